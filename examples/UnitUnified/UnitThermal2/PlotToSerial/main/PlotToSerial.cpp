@@ -36,46 +36,11 @@ void ring_buzzer(const uint16_t freq, const uint8_t duty, const uint16_t count =
 constexpr float low_alarm_temp{10.0f};
 constexpr float high_alarm_temp{30.0f};
 
-void dump(const Data& d)
-{
-    M5.Log.printf("Subpage:%u\n", d.subpage);
-    M5.Log.printf("Med:%.2f Avg:%.2f High:%.2f Low:%.2f\n", d.medianTemperature(), d.averageTemperature(),
-                  d.highestTemperature(), d.lowestTemperature());
-
-    M5.Log.printf("MostDiff(%u,%u) lowest{%u,%u} highest<%u,%u>\n", d.most_diff_x, d.most_diff_y, d.lowest_diff_x,
-                  d.lowest_diff_y, d.highest_diff_x, d.highest_diff_y);
-
-    M5.Log.printf(
-        "    0000   0001   0002   0003   0004   0005   0006   0007   0008   0009   0010   0011   0012   0013   0014   "
-        "0015   "
-        "0016   0017   0018   0019   0020   0021   0022   0023   0024   0025   0026   0027   0028   0029   0030   "
-        "0031\n");
-    M5.Log.printf(
-        "--------------------------------------------------------------------------------------------------------------"
-        "------"
-        "-------------------------------------------------------------------------------------------------------------"
-        "\n");
-    for (int y = 0; y < 24; ++y) {
-        M5.Log.printf("%02d:%s", y, ((y & 1) != d.subpage) ? "       " : "");
-        for (int x = 0; x < 16; ++x) {
-            auto val = d.raw[y * 16 + x];
-            int xx   = x * 2 + ((y & 1) != d.subpage);
-            if (xx == d.most_diff_x && y == d.most_diff_y) {
-                M5.Log.printf("(%04X) ", val);
-            } else if (xx == d.lowest_diff_x && y == d.lowest_diff_y) {
-                M5.Log.printf("{%04X} ", val);
-            } else if (xx == d.highest_diff_x && y == d.highest_diff_y) {
-                M5.Log.printf("<%04X> ", val);
-            } else {
-                M5.Log.printf(" %04X  ", val);
-            }
-            if (x != 15) {
-                M5.Log.printf("       ");
-            }
-        }
-        M5.Log.printf("\n");
-    }
-}
+// Compressed binary packets instead of text, decode them with tools/stream_decoder
+// Serial.write waits for room, give port_sink the room of a packet to keep subpages in the ring buffer instead
+// The room must fit in the transmit buffer of the port, see setup()
+auto pipeline = m5::unit::thermo::make_pipeline(stream_stage([]() { return m5::utility::millis(); }, true),
+                                                m5::unit::thermo::port_sink(Serial, stream_packet_size));
 
 };  // namespace
 
@@ -83,13 +48,19 @@ void setup()
 {
     M5.begin();
 
+    // The default transmit buffer is too small for a packet:
+    // the UART FIFO (128 bytes) for HardwareSerial, 256 bytes for HWCDC (USB CDC of ESP32-S3/C3)
+    Serial.end();
+    Serial.setTxBufferSize(2 * stream_packet_size);
+    Serial.begin(115200);
+
     auto pin_num_sda = M5.getPin(m5::pin_name_t::port_a_sda);
     auto pin_num_scl = M5.getPin(m5::pin_name_t::port_a_scl);
     M5_LOGI("getPin: SDA:%u SCL:%u", pin_num_sda, pin_num_scl);
     Wire.begin(pin_num_sda, pin_num_scl, 100 * 1000U);
 
     auto cfg = unit.config();
-    cfg.rate = Refresh::Rate0_5Hz;  // Measure per 2 second
+    cfg.rate = Refresh::Rate8Hz;  // A few hundred bytes per subpage fits in 115200 baud
     unit.config(cfg);
 
     if (!Units.add(unit, Wire) || !Units.begin()) {
@@ -112,8 +83,9 @@ void loop()
     Units.update();
 
     // Periodic
-    if (unit.updated()) {
-        dump(unit.oldest());
+    while (unit.available() && pipeline.ready()) {
+        pipeline.push(unit.oldest());
+        unit.discard();
     }
 
     // Button on UnitThermal2 (toggle  periodic <-> single)
@@ -131,8 +103,8 @@ void loop()
             if (unit.measureSingleshot(page0, page1)) {
                 ring_buzzer(2000, 64);
                 unit.writeLED(2, 10, 2);
-                dump(page0);
-                dump(page1);
+                pipeline.push(page0);
+                pipeline.push(page1);
             }
         } else {
             unit.writeLED(2, 2, 10);
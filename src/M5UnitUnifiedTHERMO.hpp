@@ -16,6 +16,25 @@
 #include "unit/unit_MLX90614.hpp"
 #include "unit/unit_NCIR2.hpp"
 #include "unit/unit_Thermal2.hpp"
+#include "thermal2/frame.hpp"
+#include "thermal2/temporal_filter.hpp"
+#include "thermal2/spatial_filter.hpp"
+#include "thermal2/pixel_health.hpp"
+#include "thermal2/roi.hpp"
+#include "thermal2/blob.hpp"
+#include "thermal2/peak.hpp"
+#include "thermal2/deinterlace.hpp"
+#include "thermal2/background.hpp"
+#include "thermal2/histogram.hpp"
+#include "thermal2/agc.hpp"
+#include "thermal2/upscale.hpp"
+#include "thermal2/tile_renderer.hpp"
+#include "thermal2/palette.hpp"
+#include "thermal2/codec.hpp"
+#include "thermal2/stream.hpp"
+#include "thermal2/recording.hpp"
+#include "thermal2/stages.hpp"
+#include "thermal2/roi_alarm.hpp"
 
 /*!
   @namespace m5
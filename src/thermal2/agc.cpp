@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file agc.cpp
+  @brief Automatic gain control for Thermal2 frames
+*/
+#include "agc.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+void Agc::config(const config_t& cfg)
+{
+    _cfg              = cfg;
+    _cfg.low_percent  = (cfg.low_percent < 0.0f) ? 0.0f : (cfg.low_percent > 100.0f) ? 100.0f : cfg.low_percent;
+    _cfg.high_percent = (cfg.high_percent < _cfg.low_percent) ? _cfg.low_percent
+                        : (cfg.high_percent > 100.0f)         ? 100.0f
+                                                              : cfg.high_percent;
+    _cfg.smooth_shift = (cfg.smooth_shift > 8) ? 8 : cfg.smooth_shift;
+    _primed           = false;
+}
+
+bool Agc::update(const Histogram& histogram)
+{
+    if (!histogram.total()) {
+        return false;
+    }
+    const float p[2] = {_cfg.mode == AgcMode::Linear ? 0.0f : _cfg.low_percent,
+                        _cfg.mode == AgcMode::Linear ? 100.0f : _cfg.high_percent};
+    uint16_t range[2]{};
+    histogram.percentiles(range, p, 2);
+
+    // Smooth the range so that the colours do not flicker with the noise of the extremes
+    if (!_primed || !_cfg.smooth_shift) {
+        _low_q8  = (int32_t)range[0] << 8;
+        _high_q8 = (int32_t)range[1] << 8;
+        _primed  = true;
+    } else {
+        _low_q8 += (((int32_t)range[0] << 8) - _low_q8) >> _cfg.smooth_shift;
+        _high_q8 += (((int32_t)range[1] << 8) - _high_q8) >> _cfg.smooth_shift;
+    }
+    set_range((uint16_t)((_low_q8 + 128) >> 8), (uint16_t)((_high_q8 + 128) >> 8));
+
+    if (_cfg.mode == AgcMode::Equalize) {
+        build_equalized(histogram);
+    } else {
+        build_linear();
+    }
+    return true;
+}
+
+void Agc::update(const uint16_t lowest, const uint16_t highest)
+{
+    set_range(lowest, highest);
+    build_linear();
+}
+
+void Agc::map(uint8_t* dst, const uint16_t* src, const uint16_t n) const
+{
+    for (uint_fast16_t i = 0; i < n; ++i) {
+        dst[i] = _lut[entry(src[i])];
+    }
+}
+
+void Agc::set_range(const uint16_t low, const uint16_t high)
+{
+    int32_t lo = low, hi = (high > low) ? high : low;
+    // Widen around the middle up to the minimum range
+    const int32_t span = (_cfg.min_span > 1) ? _cfg.min_span : 1;
+    if (hi - lo < span) {
+        const int32_t mid = (lo + hi) >> 1;
+        lo                = mid - (span >> 1);
+        hi                = lo + span;
+    }
+    lo = (lo < 0) ? 0 : lo;
+    hi = (hi > 0xFFFF) ? 0xFFFF : hi;
+    if (hi <= lo) {
+        lo = hi - 1;
+    }
+    _low  = (uint16_t)lo;
+    _high = (uint16_t)hi;
+
+    // The finest entries that cover the range
+    const uint32_t width = (uint32_t)(hi - lo);
+    _shift               = 0;
+    while ((width >> _shift) >= max_entries) {
+        ++_shift;
+    }
+    _lower = _low;
+    _size  = (uint16_t)((width >> _shift) + 1);
+}
+
+void Agc::build_linear()
+{
+    const uint32_t last = _size - 1;
+    for (uint_fast16_t i = 0; i < _size; ++i) {
+        _lut[i] = (uint8_t)((i * 255 + (last >> 1)) / last);
+    }
+}
+
+void Agc::build_equalized(const Histogram& histogram)
+{
+    const uint16_t first = histogram.bin(_low);
+    const uint16_t last  = histogram.bin(_high);
+    uint32_t in_range{};
+    for (uint_fast16_t b = first; b <= last; ++b) {
+        in_range += histogram.count(b);
+    }
+    if (!in_range) {
+        build_linear();
+        return;
+    }
+
+    // Pixels per bin are clipped so that large flat areas do not take the whole palette.
+    // The clipped excess is spread evenly over the range (linear)
+    const uint32_t bins = last - first + 1;
+    uint32_t limit      = _cfg.clip_q4 ? (in_range * _cfg.clip_q4 + bins * 16 - 1) / (bins * 16) : in_range;
+    limit               = limit ? limit : 1;
+    uint32_t excess{};
+    for (uint_fast16_t b = first; b <= last; ++b) {
+        excess += (histogram.count(b) > limit) ? histogram.count(b) - limit : 0;
+    }
+
+    // Cumulative clipped pixels below the raw value, linear inside the bin. Called with ascending values
+    const float width = (float)(1U << histogram.config().shift);
+    const float span  = (float)(_high - _low);
+    uint_fast16_t b{first};
+    uint32_t cum{};  // Clipped pixels in the bins before b
+    auto cdf = [&](const uint32_t raw) {
+        while (b < last && raw >= histogram.lower(b + 1)) {
+            cum += (histogram.count(b) > limit) ? limit : histogram.count(b);
+            ++b;
+        }
+        const uint32_t c = (histogram.count(b) > limit) ? limit : histogram.count(b);
+        float frac       = ((float)raw - (float)histogram.lower(b)) / width;
+        frac             = (frac < 0.0f) ? 0.0f : (frac > 1.0f) ? 1.0f : frac;
+        return cum + c * frac + excess * (float)(raw - _low) / span;
+    };
+
+    // The ends of the range are mapped to 0 and 255 even if they are inside a bin
+    const float top    = cdf(_high);
+    b                  = first;
+    cum                = 0;
+    const float bottom = cdf(_low);
+    const float scale  = (top > bottom) ? 255.0f / (top - bottom) : 0.0f;
+    for (uint_fast16_t i = 0; i < _size; ++i) {
+        const int32_t v = (int32_t)((cdf(_lower + (i << _shift)) - bottom) * scale + 0.5f);
+        _lut[i]         = (v < 0) ? 0 : (v > 255) ? 255 : (uint8_t)v;
+    }
+    // The last entry holds the high end
+    _lut[_size - 1] = 255;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
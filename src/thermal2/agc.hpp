@@ -0,0 +1,190 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file agc.hpp
+  @brief Automatic gain control for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_AGC_HPP
+#define M5_UNIT_THERMO_THERMAL2_AGC_HPP
+
+#include "histogram.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @enum AgcMode
+  @brief How the raw values are spread over the palette
+ */
+enum class AgcMode : uint8_t {
+    Linear,      //!< Linear from the lowest to the highest
+    Percentile,  //!< Linear between the low and high percentiles, the tails are clipped
+    Equalize,    //!< Histogram equalised between the low and high percentiles
+};
+
+/*!
+  @class Agc
+  @brief Raw value to palette index lookup table, rebuilt once per frame
+  @details The table covers the display range [lower(), lower() + (size() << shift())) and
+  values out of the range take the first or the last entry.
+  A renderer maps a pixel with index() or, with a colour table made by colorize(),
+  with colors[entry(raw)] and no division at all
+  @note Uses about 1KiB
+ */
+class Agc {
+public:
+    //! @brief Maximum entries of the table
+    static constexpr uint16_t max_entries{1024};
+
+    /*!
+      @struct config_t
+      @brief AGC settings
+     */
+    struct config_t {
+        //! Mapping
+        AgcMode mode{AgcMode::Percentile};
+        //! Low end of the range (percent, Percentile and Equalize)
+        float low_percent{1.0f};
+        //! High end of the range (percent, Percentile and Equalize)
+        float high_percent{99.0f};
+        //! Minimum range (raw, 256: 2 celsius) so that a uniform scene does not stretch the noise
+        uint16_t min_span{256};
+        //! Range smoothing over frames as a right shift (0: none)
+        uint8_t smooth_shift{2};
+        //! Equalize clip limit in multiples of the mean bin count (Q4, 48: 3 times, 0: no limit)
+        uint8_t clip_q4{48};
+    };
+
+    Agc()
+    {
+        config(_cfg);
+    }
+    explicit Agc(const config_t& cfg)
+    {
+        config(cfg);
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    void config(const config_t& cfg);
+    ///@}
+
+    //! @brief Forget the smoothed range. The next range is taken as is
+    inline void reset()
+    {
+        _primed = false;
+    }
+
+    ///@name Update
+    ///@{
+    /*!
+      @brief Rebuild the table from the histogram of the frame
+      @return True if successful
+     */
+    bool update(const Histogram& histogram);
+    /*!
+      @brief Rebuild the table linear over the range
+      @param lowest Raw value of index 0
+      @param highest Raw value of index 255
+      @note The range is used as is, without smoothing
+     */
+    void update(const uint16_t lowest, const uint16_t highest);
+    ///@}
+
+    ///@name Mapping
+    ///@{
+    //! @brief Entry of the table for the raw value
+    inline uint16_t entry(const uint16_t raw) const
+    {
+        const int32_t e = ((int32_t)raw - _lower) >> _shift;
+        return (e < 0) ? 0 : (e >= _size) ? _size - 1 : (uint16_t)e;
+    }
+    //! @brief Palette index (0-255) of the raw value
+    inline uint8_t index(const uint16_t raw) const
+    {
+        return _lut[entry(raw)];
+    }
+    /*!
+      @brief Palette index of the pixels
+      @param[out] dst Palette indexes (n)
+      @param src Raw values (n)
+      @param n Number of pixels
+     */
+    void map(uint8_t* dst, const uint16_t* src, const uint16_t n) const;
+    /*!
+      @brief Make the colour table of the entries
+      @tparam T Colour type of the palette
+      @param[out] out Colours (size())
+      @param palette Palette (256)
+     */
+    template <typename T>
+    void colorize(T* out, const T* palette) const
+    {
+        for (uint_fast16_t i = 0; i < _size; ++i) {
+            out[i] = palette[_lut[i]];
+        }
+    }
+    ///@}
+
+    ///@name Table
+    ///@{
+    //! @brief Palette indexes of the entries
+    inline const uint8_t* lut() const
+    {
+        return _lut;
+    }
+    //! @brief Number of entries
+    inline uint16_t size() const
+    {
+        return _size;
+    }
+    //! @brief Raw value of the first entry
+    inline uint16_t lower() const
+    {
+        return _lower;
+    }
+    //! @brief Raw width of an entry as a left shift
+    inline uint8_t shift() const
+    {
+        return _shift;
+    }
+    //! @brief Raw value mapped to index 0 (low end of the range)
+    inline uint16_t low() const
+    {
+        return _low;
+    }
+    //! @brief Raw value mapped to index 255 (high end of the range)
+    inline uint16_t high() const
+    {
+        return _high;
+    }
+    ///@}
+
+protected:
+    void set_range(const uint16_t low, const uint16_t high);
+    void build_linear();
+    void build_equalized(const Histogram& histogram);
+
+private:
+    config_t _cfg{};
+    uint8_t _lut[max_entries]{};
+    uint16_t _size{1}, _lower{}, _low{}, _high{};
+    uint8_t _shift{};
+    int32_t _low_q8{}, _high_q8{};
+    bool _primed{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
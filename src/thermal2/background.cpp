@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file background.cpp
+  @brief Background model and occupancy detection for Thermal2 frames
+*/
+#include "background.hpp"
+#include <algorithm>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+uint16_t BackgroundModel::process(const uint16_t* frame)
+{
+    if (!_frames++) {
+        for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+            _mean_q8[i] = (uint32_t)frame[i] << 8;
+            _var[i]     = _cfg.min_variance;
+        }
+        std::fill(std::begin(_mask), std::end(_mask), 0);
+        _count   = 0;
+        _changed = 0;
+        for (auto&& z : _zones) {
+            z.count    = 0;
+            z.occupied = false;
+        }
+        return 0;
+    }
+
+    const int64_t k2_q8 = (int64_t)_cfg.k_sigma_q4 * _cfg.k_sigma_q4;  // k^2 in Q8
+    uint16_t count{}, changed{};
+
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        uint32_t m{};
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            const uint_fast16_t i = y * frame_width + x;
+            // Q8 difference keeps the slow adaptation exact
+            const int32_t d_q8 = ((int32_t)frame[i] << 8) - (int32_t)_mean_q8[i];
+            const int32_t d    = d_q8 / 256;
+            const int32_t ad   = d < 0 ? -d : d;
+            const bool fg      = ad > _cfg.min_delta && (!_cfg.hot_only || d > 0) &&
+                            ((int64_t)d * d << 8) > k2_q8 * _var[i];
+
+            const uint8_t shift = fg ? _cfg.foreground_shift : _cfg.learn_shift;
+            _mean_q8[i]         = (uint32_t)((int32_t)_mean_q8[i] + (d_q8 >> shift));
+            if (!fg) {
+                // Variance of the background only, a foreground object must not widen it
+                // Clamped before squaring, a hot pixel far from a new mean overflows int32
+                const int32_t c  = std::min<int32_t>(ad, 255);
+                const int32_t sq = c * c;
+                int32_t v        = _var[i] + ((sq - (int32_t)_var[i]) >> shift);
+                _var[i]          = (uint16_t)std::max<int32_t>(v, _cfg.min_variance);
+            }
+            m |= (uint32_t)fg << x;
+        }
+        changed += __builtin_popcount(m ^ _mask[y]);
+        count += __builtin_popcount(m);
+        _mask[y] = m;
+    }
+    _count   = count;
+    _changed = changed;
+
+    // Zones by the mask rows
+    for (auto&& z : _zones) {
+        const uint32_t bits = ((z.rect.w >= 32) ? 0xFFFFFFFFU : ((1U << z.rect.w) - 1)) << z.rect.x;
+        uint16_t c{};
+        for (uint_fast8_t y = z.rect.y; y < z.rect.y + z.rect.h; ++y) {
+            c += __builtin_popcount(_mask[y] & bits);
+        }
+        z.count    = c;
+        z.occupied = c >= z.min_pixels;
+    }
+    return _count;
+}
+
+bool BackgroundModel::addZone(const char* name, const Rect& rect, const uint16_t min_pixels)
+{
+    if (!name || !rect.valid() || findZone(name)) {
+        return false;
+    }
+    Zone z{};
+    z.name       = name;
+    z.rect       = rect;
+    z.min_pixels = min_pixels ? min_pixels : 1;
+    _zones.push_back(z);
+    return true;
+}
+
+bool BackgroundModel::removeZone(const char* name)
+{
+    auto it = std::find_if(_zones.begin(), _zones.end(), [&name](const Zone& z) { return name && z.name == name; });
+    if (it == _zones.end()) {
+        return false;
+    }
+    _zones.erase(it);
+    return true;
+}
+
+const BackgroundModel::Zone* BackgroundModel::findZone(const char* name) const
+{
+    auto it = std::find_if(_zones.begin(), _zones.end(), [&name](const Zone& z) { return name && z.name == name; });
+    return (it != _zones.end()) ? &*it : nullptr;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
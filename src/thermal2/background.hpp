@@ -0,0 +1,173 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file background.hpp
+  @brief Background model and occupancy detection for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_BACKGROUND_HPP
+#define M5_UNIT_THERMO_THERMAL2_BACKGROUND_HPP
+
+#include "frame.hpp"
+#include "roi.hpp"
+#include <string>
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class BackgroundModel
+  @brief Per-pixel running mean and variance with foreground masking
+  @details A pixel is foreground if it departs from its mean by more than k sigma and by more than the minimum delta.
+  Background pixels adapt at the normal rate, foreground pixels at a much slower rate,
+  so a person standing still stays foreground while a slow ambient drift is absorbed
+  @note Uses about 5KiB plus the zones
+ */
+class BackgroundModel {
+public:
+    /*!
+      @struct config_t
+      @brief Model settings
+     */
+    struct config_t {
+        //! Background adaptation rate as a right shift (1/64 by default)
+        uint8_t learn_shift{6};
+        //! Foreground adaptation rate as a right shift (1/4096 by default)
+        uint8_t foreground_shift{12};
+        //! Threshold in sigma (Q4, 48: 3 sigma)
+        uint16_t k_sigma_q4{48};
+        //! Minimum raw delta to be foreground (96: 0.75 celsius)
+        uint16_t min_delta{96};
+        //! Initial and minimum variance (raw^2, 64: 8 raw)
+        uint16_t min_variance{64};
+        //! Only warmer than the background is foreground?
+        bool hot_only{true};
+    };
+
+    /*!
+      @struct Zone
+      @brief Named region and its occupancy
+     */
+    struct Zone {
+        std::string name{};
+        Rect rect{};
+        uint16_t min_pixels{};  //!< Foreground pixels that make the zone occupied
+        uint16_t count{};       //!< Foreground pixels of the latest frame
+        bool occupied{};        //!< Occupied in the latest frame?
+    };
+
+    BackgroundModel() = default;
+    explicit BackgroundModel(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    //! @brief Forget the background, the next frame is taken as the background
+    inline void reset()
+    {
+        _frames = 0;
+    }
+
+    /*!
+      @brief Classify the frame and update the model
+      @param frame Raw pixel data (768)
+      @return Number of foreground pixels
+     */
+    uint16_t process(const uint16_t* frame);
+    //! @brief Classify the frame and update the model
+    inline uint16_t process(const Frame& frame)
+    {
+        return process(frame.raw);
+    }
+
+    ///@name Result
+    ///@{
+    //! @brief Foreground mask, bit x of mask()[y] (24) for the pixel (x, y)
+    inline const uint32_t* mask() const
+    {
+        return _mask;
+    }
+    //! @brief Is the pixel foreground?
+    inline bool isForeground(const uint_fast8_t x, const uint_fast8_t y) const
+    {
+        return _mask[y] & (1U << x);
+    }
+    //! @brief Foreground pixels of the latest frame
+    inline uint16_t foregroundCount() const
+    {
+        return _count;
+    }
+    //! @brief Pixels that changed between foreground and background since the previous frame (motion)
+    inline uint16_t changedCount() const
+    {
+        return _changed;
+    }
+    //! @brief Frames processed since reset
+    inline uint32_t frames() const
+    {
+        return _frames;
+    }
+    //! @brief Background mean of the pixel (raw)
+    inline uint16_t mean(const uint_fast16_t idx) const
+    {
+        return (uint16_t)((_mean_q8[idx] + 128) >> 8);
+    }
+    //! @brief Background variance of the pixel (raw^2)
+    inline uint16_t variance(const uint_fast16_t idx) const
+    {
+        return _var[idx];
+    }
+    ///@}
+
+    ///@name Zones
+    ///@{
+    /*!
+      @brief Add an occupancy zone
+      @param name Unique name
+      @param rect Rectangle
+      @param min_pixels Foreground pixels that make the zone occupied
+      @return True if successful
+     */
+    bool addZone(const char* name, const Rect& rect, const uint16_t min_pixels = 2);
+    //! @brief Remove the zone
+    bool removeZone(const char* name);
+    //! @brief Find the zone, nullptr if not found
+    const Zone* findZone(const char* name) const;
+    //! @brief All zones in the order added
+    inline const std::vector<Zone>& zones() const
+    {
+        return _zones;
+    }
+    ///@}
+
+private:
+    config_t _cfg{};
+    uint32_t _mean_q8[frame_pixels]{};
+    uint16_t _var[frame_pixels]{};
+    uint32_t _mask[frame_height]{};
+    uint16_t _count{}, _changed{};
+    uint32_t _frames{};
+    std::vector<Zone> _zones{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
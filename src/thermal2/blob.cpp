@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file blob.cpp
+  @brief Hot-spot blob detection and tracking for Thermal2 frames
+*/
+#include "blob.hpp"
+#include <algorithm>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+// ----------------------------------------------------------------------------
+// BlobDetector
+uint16_t BlobDetector::find(uint16_t l)
+{
+    // Path halving
+    while (_labels[l].parent != l) {
+        _labels[l].parent = _labels[_labels[l].parent].parent;
+        l                 = _labels[l].parent;
+    }
+    return l;
+}
+
+uint16_t BlobDetector::unite(const uint16_t a, const uint16_t b)
+{
+    uint16_t ra = find(a);
+    uint16_t rb = find(b);
+    if (ra == rb) {
+        return ra;
+    }
+    if (rb < ra) {
+        std::swap(ra, rb);
+    }
+    // The smaller label becomes the root and takes over the statistics
+    label_t& r       = _labels[ra];
+    const label_t& m = _labels[rb];
+    r.area += m.area;
+    r.sum_x += m.sum_x;
+    r.sum_y += m.sum_y;
+    if (m.peak > r.peak) {
+        r.peak   = m.peak;
+        r.peak_x = m.peak_x;
+        r.peak_y = m.peak_y;
+    }
+    r.x0               = std::min(r.x0, m.x0);
+    r.y0               = std::min(r.y0, m.y0);
+    r.x1               = std::max(r.x1, m.x1);
+    r.y1               = std::max(r.y1, m.y1);
+    _labels[rb].parent = ra;
+    return ra;
+}
+
+uint8_t BlobDetector::detect(const uint16_t* frame)
+{
+    uint16_t rows[2][frame_width]{};
+    uint16_t* prev = rows[0];
+    uint16_t* cur  = rows[1];
+    uint16_t next{1};  // 0 is the background
+
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            const uint16_t v = frame[y * frame_width + x];
+            if (v < _cfg.threshold) {
+                cur[x] = 0;
+                continue;
+            }
+            // Already visited neighbours
+            uint16_t n[4]{x ? cur[x - 1] : (uint16_t)0, prev[x]};
+            if (_cfg.eight_connected) {
+                n[2] = x ? prev[x - 1] : 0;
+                n[3] = (x + 1 < frame_width) ? prev[x + 1] : 0;
+            }
+            uint16_t l{};
+            for (auto&& nl : n) {
+                if (nl) {
+                    l = l ? unite(l, nl) : find(nl);
+                }
+            }
+            if (!l) {
+                l = next++;
+                _labels[l].init(l, x, y);
+            }
+            label_t& s = _labels[l];
+            ++s.area;
+            s.sum_x += x;
+            s.sum_y += y;
+            if (v > s.peak) {
+                s.peak   = v;
+                s.peak_x = x;
+                s.peak_y = y;
+            }
+            s.x0   = std::min<uint8_t>(s.x0, x);
+            s.x1   = std::max<uint8_t>(s.x1, x);
+            s.y1   = y;
+            cur[x] = l;
+        }
+        std::swap(prev, cur);
+    }
+
+    // Roots are the blobs, keep the largest
+    _count    = 0;
+    _overflow = 0;
+    for (uint16_t l = 1; l < next; ++l) {
+        const label_t& s = _labels[l];
+        if (s.parent != l || s.area < _cfg.min_area) {
+            continue;
+        }
+        if (_count == max_blobs && s.area <= _blobs[max_blobs - 1].area) {
+            ++_overflow;
+            continue;
+        }
+        _overflow += (_count == max_blobs);
+        uint8_t pos = (_count < max_blobs) ? _count++ : max_blobs - 1;
+        for (; pos && _blobs[pos - 1].area < s.area; --pos) {
+            _blobs[pos] = _blobs[pos - 1];
+        }
+        Blob& b    = _blobs[pos];
+        b.id       = 0;
+        b.area     = s.area;
+        b.cx       = (float)s.sum_x / s.area;
+        b.cy       = (float)s.sum_y / s.area;
+        b.peak     = s.peak;
+        b.peak_x   = s.peak_x;
+        b.peak_y   = s.peak_y;
+        b.bounds.x = s.x0;
+        b.bounds.y = s.y0;
+        b.bounds.w = (uint8_t)(s.x1 - s.x0 + 1);
+        b.bounds.h = (uint8_t)(s.y1 - s.y0 + 1);
+    }
+    return _count;
+}
+
+// ----------------------------------------------------------------------------
+// BlobTracker
+void BlobTracker::reset()
+{
+    for (auto&& t : _tracks) {
+        t = Track{};
+    }
+}
+
+void BlobTracker::update(Blob* blobs, const uint8_t num)
+{
+    const uint8_t n = std::min<uint8_t>(num, +max_tracks);
+    bool matched_track[max_tracks]{};
+    bool matched_blob[max_tracks]{};
+    const float limit = _cfg.max_distance * _cfg.max_distance;
+
+    // Greedy, the closest pair first
+    for (;;) {
+        float best{limit};
+        int_fast8_t bi{-1}, bj{-1};
+        for (uint_fast8_t i = 0; i < max_tracks; ++i) {
+            const Track& t = _tracks[i];
+            if (!t.id || matched_track[i]) {
+                continue;
+            }
+            const float px = t.x + t.vx;
+            const float py = t.y + t.vy;
+            for (uint_fast8_t j = 0; j < n; ++j) {
+                if (matched_blob[j]) {
+                    continue;
+                }
+                const float dx = blobs[j].cx - px;
+                const float dy = blobs[j].cy - py;
+                const float d  = dx * dx + dy * dy;
+                if (d <= best) {
+                    best = d;
+                    bi   = i;
+                    bj   = j;
+                }
+            }
+        }
+        if (bi < 0) {
+            break;
+        }
+        Track& t = _tracks[bi];
+        t.vx     = (t.vx + (blobs[bj].cx - t.x)) * 0.5f;
+        t.vy     = (t.vy + (blobs[bj].cy - t.y)) * 0.5f;
+        t.x      = blobs[bj].cx;
+        t.y      = blobs[bj].cy;
+        t.missed = 0;
+        ++t.age;
+        blobs[bj].id      = t.id;
+        matched_track[bi] = true;
+        matched_blob[bj]  = true;
+    }
+
+    // Unmatched tracks coast on their velocity until they expire
+    for (uint_fast8_t i = 0; i < max_tracks; ++i) {
+        Track& t = _tracks[i];
+        if (!t.id || matched_track[i]) {
+            continue;
+        }
+        if (++t.missed > _cfg.max_missed) {
+            t = Track{};
+            continue;
+        }
+        t.x += t.vx;
+        t.y += t.vy;
+    }
+
+    // Unmatched blobs start new tracks
+    for (uint_fast8_t j = 0; j < n; ++j) {
+        if (matched_blob[j]) {
+            continue;
+        }
+        blobs[j].id = 0;
+        auto it     = std::find_if(std::begin(_tracks), std::end(_tracks), [](const Track& t) { return !t.id; });
+        if (it != std::end(_tracks)) {
+            *it         = Track{};
+            it->id      = _next_id;
+            it->x       = blobs[j].cx;
+            it->y       = blobs[j].cy;
+            it->age     = 1;
+            blobs[j].id = _next_id;
+            _next_id    = (_next_id == 0xFFFF) ? 1 : _next_id + 1;
+        }
+    }
+    for (uint_fast8_t j = n; j < num; ++j) {
+        blobs[j].id = 0;
+    }
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,229 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file blob.hpp
+  @brief Hot-spot blob detection and tracking for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_BLOB_HPP
+#define M5_UNIT_THERMO_THERMAL2_BLOB_HPP
+
+#include "frame.hpp"
+#include "roi.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @struct Blob
+  @brief Connected region above the threshold
+ */
+struct Blob {
+    uint16_t id{};     //!< Track ID assigned by BlobTracker (0: not tracked)
+    uint16_t area{};   //!< Pixels
+    float cx{}, cy{};  //!< Centroid (pixels)
+    uint16_t peak{};   //!< Highest raw value
+    uint8_t peak_x{};  //!< X of the highest pixel
+    uint8_t peak_y{};  //!< Y of the highest pixel
+    Rect bounds{};     //!< Bounding box
+};
+
+/*!
+  @class BlobDetector
+  @brief Connected-component labelling of the thresholded frame
+  @details Single pass with union-find. Only two rows of labels are kept,
+  the statistics are accumulated per provisional label and merged on union.
+  Memory and time are bounded by the frame size
+ */
+class BlobDetector {
+public:
+    //! @brief Maximum blobs reported, the largest ones are kept
+    static constexpr uint8_t max_blobs{32};
+
+    /*!
+      @struct config_t
+      @brief Detector settings
+     */
+    struct config_t {
+        //! Pixels at or above this raw value are hot (9472: 10 celsius)
+        uint16_t threshold{(10 + 64) * 128};
+        //! Blobs smaller than this are ignored
+        uint16_t min_area{1};
+        //! 8-connectivity if true, 4-connectivity if false
+        bool eight_connected{true};
+    };
+
+    BlobDetector() = default;
+    explicit BlobDetector(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Detect the blobs
+      @param frame Raw pixel data (768)
+      @return Number of blobs
+     */
+    uint8_t detect(const uint16_t* frame);
+    //! @brief Detect the blobs
+    inline uint8_t detect(const Frame& frame)
+    {
+        return detect(frame.raw);
+    }
+
+    ///@name Result
+    ///@{
+    //! @brief Number of blobs
+    inline uint8_t size() const
+    {
+        return _count;
+    }
+    //! @brief Blobs in descending order of area
+    inline const Blob* blobs() const
+    {
+        return _blobs;
+    }
+    //! @brief Blobs in descending order of area
+    inline Blob* blobs()
+    {
+        return _blobs;
+    }
+    //! @brief Blobs found but not reported because max_blobs was exceeded
+    inline uint16_t overflow() const
+    {
+        return _overflow;
+    }
+    ///@}
+
+protected:
+    uint16_t find(uint16_t l);
+    uint16_t unite(const uint16_t a, const uint16_t b);
+
+private:
+    // At most one new label every other pixel of a row
+    static constexpr uint16_t max_labels{subpage_pixels + 1};
+    struct label_t {
+        uint16_t parent;
+        uint16_t area;
+        uint16_t sum_x, sum_y;  // 768 * 31 fits
+        uint16_t peak;
+        uint8_t peak_x, peak_y;
+        uint8_t x0, y0, x1, y1;
+
+        inline void init(const uint16_t l, const uint8_t x, const uint8_t y)
+        {
+            *this  = label_t{};
+            parent = l;
+            x0     = x;
+            x1     = x;
+            y0     = y;
+            y1     = y;
+        }
+    };
+
+    config_t _cfg{};
+    label_t _labels[max_labels]{};
+    Blob _blobs[max_blobs]{};
+    uint8_t _count{};
+    uint16_t _overflow{};
+};
+
+/*!
+  @class BlobTracker
+  @brief Assigns stable IDs to blobs across frames
+  @details Greedy nearest-neighbour matching of the centroids against the positions predicted from the velocity
+ */
+class BlobTracker {
+public:
+    //! @brief Maximum tracks
+    static constexpr uint8_t max_tracks{BlobDetector::max_blobs};
+
+    /*!
+      @struct config_t
+      @brief Tracker settings
+     */
+    struct config_t {
+        //! Largest centroid move between frames that still matches (pixels)
+        float max_distance{4.0f};
+        //! Frames a track survives without a match
+        uint8_t max_missed{3};
+    };
+
+    /*!
+      @struct Track
+      @brief Tracked blob
+     */
+    struct Track {
+        uint16_t id{};     //!< ID (0: unused)
+        float x{}, y{};    //!< Latest centroid
+        float vx{}, vy{};  //!< Velocity (pixels per frame)
+        uint32_t age{};    //!< Frames matched
+        uint8_t missed{};  //!< Frames without a match in a row
+    };
+
+    BlobTracker() = default;
+    explicit BlobTracker(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    //! @brief Drop all tracks
+    void reset();
+
+    /*!
+      @brief Match the blobs of the new frame and assign their IDs
+      @param[in,out] blobs Blobs, Blob::id is written
+      @param num Number of blobs
+     */
+    void update(Blob* blobs, const uint8_t num);
+    //! @brief Match the blobs of the detector and assign their IDs
+    inline void update(BlobDetector& detector)
+    {
+        update(detector.blobs(), detector.size());
+    }
+
+    //! @brief Tracks (unused ones have id 0)
+    inline const Track* tracks() const
+    {
+        return _tracks;
+    }
+
+private:
+    config_t _cfg{};
+    Track _tracks[max_tracks]{};
+    uint16_t _next_id{1};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,218 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file codec.cpp
+  @brief Delta and Rice compression of Thermal2 subpages
+*/
+#include "codec.hpp"
+#include <cstring>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+namespace {
+constexpr uint8_t escape_quotient{16};
+
+// Neighbouring pixel of the subpage already coded, the previous one in the row or the one above
+inline uint16_t spatial_prediction(const uint16_t* raw, const uint_fast16_t i)
+{
+    return (i & 15) ? raw[i - 1] : (i ? raw[i - 16] : 0);
+}
+
+inline uint16_t zigzag(const uint16_t value, const uint16_t prediction)
+{
+    const int16_t d = (int16_t)(value - prediction);
+    return (uint16_t)(((uint16_t)d << 1) ^ (uint16_t)(d >> 15));
+}
+
+inline uint16_t unzigzag(const uint16_t z, const uint16_t prediction)
+{
+    return (uint16_t)(prediction + ((z >> 1) ^ (uint16_t)-(z & 1)));
+}
+
+inline uint32_t code_bits(const uint16_t z, const uint8_t k)
+{
+    const uint32_t q = z >> k;
+    return (q < escape_quotient) ? q + 1 + k : escape_quotient + 16;
+}
+
+struct bit_writer_t {
+    uint8_t* out;
+    size_t pos{};
+    uint32_t acc{};
+    uint8_t bits{};
+
+    explicit bit_writer_t(uint8_t* o) : out{o}
+    {
+    }
+    inline void put(const uint32_t v, const uint8_t n)
+    {
+        acc  = (acc << n) | (v & ((1U << n) - 1));
+        bits += n;
+        while (bits >= 8) {
+            bits -= 8;
+            out[pos++] = acc >> bits;
+        }
+    }
+    inline size_t finish()
+    {
+        if (bits) {
+            out[pos++] = acc << (8 - bits);
+        }
+        return pos;
+    }
+};
+
+struct bit_reader_t {
+    const uint8_t* in;
+    size_t len, pos{};
+    uint32_t acc{};
+    uint8_t bits{};
+
+    bit_reader_t(const uint8_t* i, const size_t l) : in{i}, len{l}
+    {
+    }
+    // False if the block ends
+    inline bool get(uint32_t& v, const uint8_t n)
+    {
+        while (bits < n) {
+            if (pos >= len) {
+                return false;
+            }
+            acc  = (acc << 8) | in[pos++];
+            bits += 8;
+        }
+        bits -= n;
+        v = (acc >> bits) & ((1U << n) - 1);
+        return true;
+    }
+};
+}  // namespace
+
+size_t DeltaEncoder::encode(uint8_t* out, const uint16_t* raw, const uint8_t subpage)
+{
+    if (!out || !raw) {
+        return 0;
+    }
+    const uint8_t sp = subpage & 1;
+    const bool key =
+        !(_present & (1U << sp)) || (_cfg.keyframe_interval && _since_key[sp] >= _cfg.keyframe_interval);
+
+    uint16_t z[subpage_pixels];
+    uint32_t sum{};
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        z[i] = zigzag(raw[i], key ? spatial_prediction(raw, i) : _prev[sp][i]);
+        sum += z[i];
+    }
+
+    // Rice parameter around log2 of the mean, whichever is the shortest
+    uint8_t k0{};
+    while (k0 < 15 && (sum >> (k0 + 1)) >= subpage_pixels) {
+        ++k0;
+    }
+    uint8_t k{};
+    uint32_t best{UINT32_MAX};
+    for (uint8_t c = k0 ? k0 - 1 : 0; c <= k0 + 1 && c <= 15; ++c) {
+        uint32_t bits{};
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            bits += code_bits(z[i], c);
+        }
+        if (bits < best) {
+            best = bits;
+            k    = c;
+        }
+    }
+
+    size_t len{};
+    if (1 + (best + 7) / 8 >= codec_max_block_size) {
+        out[0] = sp | codec_flag_stored | (key ? codec_flag_keyframe : 0);
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            out[1 + i * 2] = raw[i] & 0xFF;
+            out[2 + i * 2] = raw[i] >> 8;
+        }
+        len = codec_max_block_size;
+    } else {
+        out[0] = sp | (key ? codec_flag_keyframe : 0) | (k << 4);
+        bit_writer_t w(out + 1);
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            const uint16_t q = z[i] >> k;
+            if (q < escape_quotient) {
+                w.put((1U << (q + 1)) - 2, q + 1);
+                w.put(z[i], k);
+            } else {
+                w.put(0xFFFF, escape_quotient);
+                w.put(z[i], 16);
+            }
+        }
+        len = 1 + w.finish();
+    }
+
+    std::memcpy(_prev[sp], raw, sizeof(_prev[sp]));
+    _present |= 1U << sp;
+    _since_key[sp] = key ? 1 : _since_key[sp] + 1;
+    return len;
+}
+
+size_t DeltaDecoder::decode(const uint8_t* in, const size_t len, uint16_t* raw, uint8_t& subpage)
+{
+    if (!in || !raw || !len) {
+        return 0;
+    }
+    const uint8_t sp = in[0] & codec_flag_subpage;
+    const bool key   = in[0] & codec_flag_keyframe;
+    const uint8_t k  = in[0] >> 4;
+    uint16_t* prev   = _prev[sp];
+    size_t read{};
+
+    if (in[0] & codec_flag_stored) {
+        if (len < codec_max_block_size) {
+            return 0;
+        }
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            prev[i] = in[1 + i * 2] | (in[2 + i * 2] << 8);
+        }
+        read = codec_max_block_size;
+    } else {
+        if (!key && !synced(sp)) {
+            return 0;
+        }
+        // Decode into the previous subpage, a broken block leaves the subpage out of sync
+        _present &= ~(1U << sp);
+        bit_reader_t r(in + 1, len - 1);
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            uint32_t q{}, bit{1}, v{};
+            while (q < escape_quotient) {
+                if (!r.get(bit, 1)) {
+                    return 0;
+                }
+                if (!bit) {
+                    break;
+                }
+                ++q;
+            }
+            if (q < escape_quotient) {
+                if (k && !r.get(v, k)) {
+                    return 0;
+                }
+                v |= q << k;
+            } else if (!r.get(v, 16)) {
+                return 0;
+            }
+            prev[i] = unzigzag(v, key ? spatial_prediction(prev, i) : prev[i]);
+        }
+        read = 1 + r.pos;
+    }
+
+    std::memcpy(raw, prev, sizeof(_prev[sp]));
+    subpage = sp;
+    _present |= 1U << sp;
+    return read;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
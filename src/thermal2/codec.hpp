@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file codec.hpp
+  @brief Delta and Rice compression of Thermal2 subpages
+  @details A block holds one subpage.
+  |Offset|Size|Content|
+  |---|---|---|
+  |0|1|bit0: subpage, bit1: keyframe, bit2: stored, bit4-7: Rice parameter|
+  |1|...|Residuals as Rice codes (MSB first), or the raw pixels (little endian) if stored|
+  A delta block holds the differences from the previous block of the same subpage, a keyframe the differences
+  from the neighbouring pixel so that it can be decoded alone. The differences are zig-zag mapped and written as
+  Rice codes, a quotient of 16 or more escapes to the 16-bit value. A block that would be larger than the raw pixels
+  is stored as they are
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_CODEC_HPP
+#define M5_UNIT_THERMO_THERMAL2_CODEC_HPP
+
+#include "frame.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+///@name Block format
+///@{
+constexpr uint8_t codec_flag_subpage{0x01};
+constexpr uint8_t codec_flag_keyframe{0x02};
+constexpr uint8_t codec_flag_stored{0x04};
+//! Largest block, a stored one
+constexpr uint16_t codec_max_block_size{1 + subpage_pixels * 2};
+///@}
+
+/*!
+  @class DeltaEncoder
+  @brief Compress subpages into blocks
+  @note Uses 1.5KiB for the previous subpages
+ */
+class DeltaEncoder {
+public:
+    /*!
+      @struct config_t
+      @brief Encoder settings
+     */
+    struct config_t {
+        //! Subpages of each parity between keyframes (0: only the first)
+        uint16_t keyframe_interval{32};
+    };
+
+    DeltaEncoder() = default;
+    explicit DeltaEncoder(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Compress the subpage
+      @param[out] out Block (codec_max_block_size)
+      @param raw Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+      @return Bytes written
+     */
+    size_t encode(uint8_t* out, const uint16_t* raw, const uint8_t subpage);
+
+    //! @brief Make the next block of each subpage a keyframe, such as when the receiver lost a block
+    inline void requestKeyframe()
+    {
+        _present = 0;
+    }
+
+private:
+    config_t _cfg{};
+    uint16_t _prev[2][subpage_pixels]{};
+    uint16_t _since_key[2]{};
+    uint8_t _present{};  // Bits of the subpages in _prev
+};
+
+/*!
+  @class DeltaDecoder
+  @brief Decompress blocks into subpages
+  @note Uses 1.5KiB for the previous subpages
+ */
+class DeltaDecoder {
+public:
+    /*!
+      @brief Decompress the block
+      @param in Block
+      @param len Bytes available in
+      @param[out] raw Raw pixel data of the subpage (384)
+      @param[out] subpage Subpage 0:even 1:odd
+      @return Bytes read, 0 if the block is broken or a delta block without its previous block
+     */
+    size_t decode(const uint8_t* in, const size_t len, uint16_t* raw, uint8_t& subpage);
+
+    //! @brief Can a delta block of the subpage be decoded?
+    inline bool synced(const uint8_t subpage) const
+    {
+        return _present & (1U << (subpage & 1));
+    }
+    //! @brief Forget the previous subpages, blocks are skipped until the next keyframe
+    inline void invalidate()
+    {
+        _present = 0;
+    }
+
+private:
+    uint16_t _prev[2][subpage_pixels]{};
+    uint8_t _present{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
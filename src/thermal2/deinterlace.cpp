@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file deinterlace.cpp
+  @brief Motion-adaptive deinterlacer for Thermal2 checkerboard subpages
+*/
+#include "deinterlace.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+void Deinterlacer::config(const config_t& cfg)
+{
+    _cfg             = cfg;
+    _cfg.motion_high = (cfg.motion_high > cfg.motion_low) ? cfg.motion_high : cfg.motion_low + 1;
+    _slope_q8        = (256U << 8) / (_cfg.motion_high - _cfg.motion_low);
+}
+
+void Deinterlacer::process(const uint16_t* raw, const uint8_t subpage, uint16_t* out)
+{
+    const uint8_t sp = subpage & 1;
+    // Without the previous values of the fresh subpage every stale pixel counts as moving
+    const bool known = _primed & (1U << sp);
+    const bool stale = _primed & (1U << (sp ^ 1));
+
+    // Change of the fresh pixels since one frame before, in the frame layout
+    uint16_t motion[frame_pixels];
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+        const int32_t d         = (int32_t)raw[i] - _raw[idx];
+        motion[idx]             = known ? (uint16_t)(d < 0 ? -d : d) : 0xFFFF;
+        _raw[idx]               = raw[i];
+        out[idx]                = raw[i];
+    }
+    _primed |= 1U << sp;
+
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        for (uint_fast8_t x = (y & 1) == sp; x < frame_width; x += 2) {
+            const uint_fast16_t idx = y * frame_width + x;
+            // The 4-neighbours belong to the fresh subpage
+            const bool l = x > 0, r = x + 1 < frame_width, u = y > 0, d = y + 1 < frame_height;
+            uint32_t msum{}, cnt{};
+            if (l) {
+                msum += motion[idx - 1];
+                ++cnt;
+            }
+            if (r) {
+                msum += motion[idx + 1];
+                ++cnt;
+            }
+            if (u) {
+                msum += motion[idx - frame_width];
+                ++cnt;
+            }
+            if (d) {
+                msum += motion[idx + frame_width];
+                ++cnt;
+            }
+            const uint32_t m = stale ? msum / cnt : 0xFFFF;
+            if (m <= _cfg.motion_low) {
+                out[idx] = _raw[idx];
+                continue;
+            }
+
+            // Median of the stale pixel and the fresh pair along the direction with less gradient.
+            // The stale value survives where it is still consistent (e.g. beside a slowly moving edge)
+            const int32_t s = _raw[idx];
+            int32_t a{}, b{};
+            const uint32_t hg = (l && r) ? std::abs((int32_t)_raw[idx - 1] - _raw[idx + 1]) : UINT32_MAX;
+            const uint32_t vg =
+                (u && d) ? std::abs((int32_t)_raw[idx - frame_width] - _raw[idx + frame_width]) : UINT32_MAX;
+            if (hg <= vg && hg != UINT32_MAX) {
+                a = _raw[idx - 1];
+                b = _raw[idx + 1];
+            } else if (vg != UINT32_MAX) {
+                a = _raw[idx - frame_width];
+                b = _raw[idx + frame_width];
+            } else {
+                // Corner, one neighbour on each axis
+                a = l ? _raw[idx - 1] : _raw[idx + 1];
+                b = u ? _raw[idx - frame_width] : _raw[idx + frame_width];
+            }
+            const int32_t spatial = stale ? std::max(std::min(a, b), std::min(std::max(a, b), s)) : (a + b + 1) >> 1;
+
+            if (m >= _cfg.motion_high) {
+                out[idx] = (uint16_t)spatial;
+                continue;
+            }
+            const int32_t w = (int32_t)(((m - _cfg.motion_low) * _slope_q8) >> 8);  // 0 - 256
+            out[idx]        = (uint16_t)(s + (((spatial - s) * w + 128) >> 8));
+        }
+    }
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file deinterlace.hpp
+  @brief Motion-adaptive deinterlacer for Thermal2 checkerboard subpages
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_DEINTERLACE_HPP
+#define M5_UNIT_THERMO_THERMAL2_DEINTERLACE_HPP
+
+#include "frame.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class Deinterlacer
+  @brief Builds full frames at the subpage rate without checkerboard artefacts
+  @details The pixels of the fresh subpage are compared with their values one frame before.
+  Each pixel of the stale subpage takes the motion of its fresh neighbours:
+  - Still: the stale pixel is kept (full resolution)
+  - Moving: the median of the stale pixel and the fresh pair along the direction with less gradient.
+    The stale value is only replaced where it is no longer consistent with its neighbours
+  - In between: both are blended
+
+  Integer arithmetic only
+ */
+class Deinterlacer {
+public:
+    /*!
+      @struct config_t
+      @brief Deinterlacer settings
+     */
+    struct config_t {
+        //! Mean raw change of the fresh neighbours below which the stale pixel is kept (64: 0.5 celsius)
+        uint16_t motion_low{64};
+        //! Mean raw change of the fresh neighbours above which the pixel is interpolated (192: 1.5 celsius)
+        uint16_t motion_high{192};
+    };
+
+    Deinterlacer()
+    {
+        config(_cfg);
+    }
+    explicit Deinterlacer(const config_t& cfg)
+    {
+        config(cfg);
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    void config(const config_t& cfg);
+    ///@}
+
+    //! @brief Forget the previous subpages
+    inline void reset()
+    {
+        _primed = 0;
+    }
+
+    /*!
+      @brief Merge the fresh subpage and output the deinterlaced frame
+      @param raw Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+      @param[out] out Deinterlaced frame (768)
+     */
+    void process(const uint16_t* raw, const uint8_t subpage, uint16_t* out);
+    //! @brief Merge the fresh subpage and output the deinterlaced frame
+    inline void process(const uint16_t* raw, const uint8_t subpage, Frame& out)
+    {
+        process(raw, subpage, out.raw);
+        out.subpage = subpage & 1;
+        out.merged  = 0x03;
+    }
+
+    //! @brief The frame merged without deinterlacing
+    inline const uint16_t* merged() const
+    {
+        return _raw;
+    }
+
+private:
+    config_t _cfg{};
+    uint32_t _slope_q8{};
+    uint16_t _raw[frame_pixels]{};  // Latest raw values of both subpages
+    uint8_t _primed{};              // Bits of the subpages received
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file frame.cpp
+  @brief Full 32x24 frame assembled from Thermal2 subpages
+*/
+#include "frame.hpp"
+#include <algorithm>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+bool summarize(FrameSummary& out, const uint16_t* frame, const uint32_t* mask)
+{
+    out = FrameSummary{};
+
+    uint16_t values[frame_pixels];
+    uint32_t sum{};
+    uint16_t cnt{};
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        const uint32_t m = mask ? mask[y] : 0;
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            if (m & (1U << x)) {
+                continue;
+            }
+            const uint16_t v = frame[y * frame_width + x];
+            if (!cnt || v < out.lowest) {
+                out.lowest   = v;
+                out.lowest_x = x;
+                out.lowest_y = y;
+            }
+            if (!cnt || v > out.highest) {
+                out.highest   = v;
+                out.highest_x = x;
+                out.highest_y = y;
+            }
+            sum += v;
+            values[cnt++] = v;
+        }
+    }
+    if (!cnt) {
+        return false;
+    }
+    out.count   = cnt;
+    out.average = (uint16_t)((sum + (cnt >> 1)) / cnt);
+    std::nth_element(values, values + cnt / 2, values + cnt);
+    out.median = values[cnt / 2];
+
+    // The farthest of the extremes
+    if (out.highest - out.average >= out.average - out.lowest) {
+        out.most_diff   = out.highest;
+        out.most_diff_x = out.highest_x;
+        out.most_diff_y = out.highest_y;
+    } else {
+        out.most_diff   = out.lowest;
+        out.most_diff_x = out.lowest_x;
+        out.most_diff_y = out.lowest_y;
+    }
+    return true;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
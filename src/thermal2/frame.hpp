@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file frame.hpp
+  @brief Full 32x24 frame assembled from Thermal2 subpages
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_FRAME_HPP
+#define M5_UNIT_THERMO_THERMAL2_FRAME_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+///@name Frame geometry
+///@{
+constexpr uint8_t frame_width{32};
+constexpr uint8_t frame_height{24};
+constexpr uint16_t frame_pixels{frame_width * frame_height};
+constexpr uint16_t subpage_pixels{frame_pixels / 2};
+///@}
+
+//! @brief Celsius to raw temperature value
+inline static uint16_t celsius_to_raw(const float f)
+{
+    int i = std::round((f + 64) * 128);
+    return static_cast<uint16_t>(std::max(std::min(i, (int)std::numeric_limits<uint16_t>::max()), 0));
+}
+//! @brief Raw temperature value to celsius
+inline static float raw_to_celsius(const uint16_t u16)
+{
+    return u16 / 128.0f - 64;
+}
+
+/*!
+  @brief Index in the full frame of the subpage pixel
+  @param subpage Subpage 0:even 1:odd
+  @param idx Index in the subpage (0-383)
+  @note Subpages are a checkerboard. Subpage N holds the pixels where (x + y) & 1 == N
+ */
+inline constexpr uint16_t subpage_to_frame_index(const uint8_t subpage, const uint16_t idx)
+{
+    return (idx >> 4) * frame_width + ((idx & 15) << 1) + (((idx >> 4) & 1) != (subpage & 1));
+}
+
+/*!
+  @brief Does the pixel belong to the subpage?
+  @param subpage Subpage 0:even 1:odd
+  @param x X (0-31)
+  @param y Y (0-23)
+ */
+inline constexpr bool is_subpage_pixel(const uint8_t subpage, const uint_fast8_t x, const uint_fast8_t y)
+{
+    return ((x + y) & 1) == (subpage & 1);
+}
+
+/*!
+  @struct Frame
+  @brief Full frame (raw values) assembled from subpages
+ */
+struct Frame {
+    uint16_t raw[frame_pixels]{};  //!< Raw pixel data, row major
+    uint8_t subpage{};             //!< Latest merged subpage
+    uint8_t merged{};              //!< Bits of the subpages merged so far (bit0:subpage 0, bit1:subpage 1)
+
+    /*!
+      @brief Merge the subpage pixels
+      @param src Raw pixel data of the subpage (384)
+      @param sp Subpage 0:even 1:odd
+     */
+    void merge(const uint16_t* src, const uint8_t sp)
+    {
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            raw[subpage_to_frame_index(sp, i)] = src[i];
+        }
+        subpage = sp & 1;
+        merged |= 1U << subpage;
+    }
+    //! @brief Have both subpages been merged?
+    inline bool complete() const
+    {
+        return merged == 0x03;
+    }
+    //! @brief Raw value of the pixel
+    inline uint16_t pixel(const uint_fast8_t x, const uint_fast8_t y) const
+    {
+        return raw[y * frame_width + x];
+    }
+};
+
+/*!
+  @struct FrameSummary
+  @brief Summary statistics of a frame (raw values)
+ */
+struct FrameSummary {
+    uint16_t median{};     //!< Median
+    uint16_t average{};    //!< Average
+    uint16_t most_diff{};  //!< The value farthest from the average
+    uint16_t lowest{};     //!< Lowest
+    uint16_t highest{};    //!< Highest
+    uint8_t most_diff_x{}, most_diff_y{};
+    uint8_t lowest_x{}, lowest_y{};
+    uint8_t highest_x{}, highest_y{};
+    uint16_t count{};  //!< Pixels taken into account
+};
+
+/*!
+  @brief Summarize the frame
+  @param[out] out Summary
+  @param frame Raw pixel data (768)
+  @param mask Pixels to leave out, bit x of mask[y] (24) for the pixel (x, y). nullptr takes all pixels
+  @return True if at least one pixel is taken into account
+ */
+bool summarize(FrameSummary& out, const uint16_t* frame, const uint32_t* mask = nullptr);
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file histogram.cpp
+  @brief Incremental histogram and percentiles of Thermal2 frames
+*/
+#include "histogram.hpp"
+#include <algorithm>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+void Histogram::config(const config_t& cfg)
+{
+    _cfg       = cfg;
+    _cfg.shift = (cfg.shift > 15) ? 15 : cfg.shift;
+    _cfg.bins  = (cfg.bins < 1) ? 1 : (cfg.bins > 4096) ? 4096 : cfg.bins;
+    _bins.assign(_cfg.bins, 0);
+    for (uint_fast8_t sp = 0; sp < 2; ++sp) {
+        if (_present & (1U << sp)) {
+            for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+                ++_bins[bin(_raw[subpage_to_frame_index(sp, i)])];
+            }
+        }
+    }
+}
+
+void Histogram::reset()
+{
+    std::fill(_bins.begin(), _bins.end(), 0);
+    _total   = 0;
+    _present = 0;
+}
+
+void Histogram::build(const uint16_t* frame)
+{
+    std::fill(_bins.begin(), _bins.end(), 0);
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        _raw[i] = frame[i];
+        ++_bins[bin(frame[i])];
+    }
+    _total   = frame_pixels;
+    _present = 0x03;
+}
+
+void Histogram::merge(const uint16_t* src, const uint8_t subpage)
+{
+    const uint8_t sp = subpage & 1;
+    if (_present & (1U << sp)) {
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+            const uint16_t prev     = bin(_raw[idx]);
+            const uint16_t cur      = bin(src[i]);
+            // Most pixels stay in the same bin between frames
+            if (prev != cur) {
+                --_bins[prev];
+                ++_bins[cur];
+            }
+            _raw[idx] = src[i];
+        }
+        return;
+    }
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        _raw[subpage_to_frame_index(sp, i)] = src[i];
+        ++_bins[bin(src[i])];
+    }
+    _total += subpage_pixels;
+    _present |= 1U << sp;
+}
+
+void Histogram::update(const Frame& frame)
+{
+    uint16_t src[subpage_pixels];
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        src[i] = frame.raw[subpage_to_frame_index(frame.subpage, i)];
+    }
+    merge(src, frame.subpage);
+}
+
+uint16_t Histogram::percentile(const float p) const
+{
+    uint16_t v{};
+    percentiles(&v, &p, 1);
+    return v;
+}
+
+void Histogram::percentiles(uint16_t* out, const float* p, const uint16_t n) const
+{
+    if (!_total) {
+        std::fill(out, out + n, 0);
+        return;
+    }
+    const uint32_t upper = lower(_cfg.bins);
+    uint_fast16_t b{};
+    uint32_t cum{};  // Pixels in the bins before b
+    for (uint_fast16_t i = 0; i < n; ++i) {
+        const float q = (p[i] < 0.0f) ? 0.0f : (p[i] > 100.0f) ? 100.0f : p[i];
+        // Zero based rank, as the index into the sorted pixels
+        const float rank = q * (_total - 1) / 100.0f;
+        const uint32_t r = (uint32_t)rank;
+        while (b < _cfg.bins - 1U && cum + _bins[b] <= r) {
+            cum += _bins[b++];
+        }
+        // Spread the pixels of the bin evenly over its width
+        const uint32_t cnt = _bins[b] ? _bins[b] : 1;
+        uint32_t v         = lower(b) + ((((r - cum) << 1) + 1) << _cfg.shift) / (cnt << 1);
+        v                  = (v >= upper) ? upper - 1 : v;
+        out[i]             = (v > 0xFFFF) ? 0xFFFF : (uint16_t)v;
+    }
+}
+
+uint16_t Histogram::below(const uint16_t raw) const
+{
+    const uint16_t b = bin(raw);
+    uint16_t cnt{};
+    for (uint_fast16_t i = 0; i < b; ++i) {
+        cnt += _bins[i];
+    }
+    return cnt;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
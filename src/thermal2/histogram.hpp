@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file histogram.hpp
+  @brief Incremental histogram and percentiles of Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_HISTOGRAM_HPP
+#define M5_UNIT_THERMO_THERMAL2_HISTOGRAM_HPP
+
+#include "frame.hpp"
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class Histogram
+  @brief Histogram of the raw values of a frame, updated subpage by subpage
+  @details Bin b holds the raw values [lower + (b << shift), lower + ((b + 1) << shift)).
+  Values out of the range are counted in the first or the last bin.
+  Merging a subpage subtracts the previous values of its pixels and adds the new ones,
+  so the histogram always describes the latest assembled frame without scanning it again
+  @note Uses 1.5KiB for the copy of the frame plus 2 bytes per bin
+ */
+class Histogram {
+public:
+    /*!
+      @struct config_t
+      @brief Binning settings
+     */
+    struct config_t {
+        //! Lower edge of the first bin (raw, 5632: -20 celsius)
+        uint16_t lower{(-20 + 64) * 128};
+        //! Bin width as a left shift (5: 32 raw, 0.25 celsius)
+        uint8_t shift{5};
+        //! Number of bins (1 - 4096)
+        uint16_t bins{512};
+    };
+
+    Histogram()
+    {
+        config(_cfg);
+    }
+    explicit Histogram(const config_t& cfg)
+    {
+        config(cfg);
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    /*!
+      @brief Set the configration
+      @note The pixels merged so far are binned again with the new settings
+     */
+    void config(const config_t& cfg);
+    ///@}
+
+    //! @brief Forget all pixels
+    void reset();
+
+    ///@name Update
+    ///@{
+    /*!
+      @brief Rebuild from the whole frame
+      @param frame Raw pixel data (768)
+     */
+    void build(const uint16_t* frame);
+    //! @brief Rebuild from the whole frame
+    inline void build(const Frame& frame)
+    {
+        build(frame.raw);
+    }
+    /*!
+      @brief Replace the pixels of the subpage
+      @param src Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+     */
+    void merge(const uint16_t* src, const uint8_t subpage);
+    //! @brief Replace the pixels of the latest merged subpage of the frame
+    void update(const Frame& frame);
+    ///@}
+
+    ///@name Result
+    ///@{
+    //! @brief Pixels counted (0, 384 or 768)
+    inline uint16_t total() const
+    {
+        return _total;
+    }
+    //! @brief Number of bins
+    inline uint16_t bins() const
+    {
+        return _cfg.bins;
+    }
+    //! @brief Pixels in the bin
+    inline uint16_t count(const uint16_t bin) const
+    {
+        return _bins[bin];
+    }
+    //! @brief Lower edge of the bin (raw)
+    inline uint32_t lower(const uint16_t bin) const
+    {
+        return _cfg.lower + ((uint32_t)bin << _cfg.shift);
+    }
+    //! @brief Bin of the raw value
+    inline uint16_t bin(const uint16_t raw) const
+    {
+        const int32_t b = ((int32_t)raw - _cfg.lower) >> _cfg.shift;
+        return (b < 0) ? 0 : (b >= _cfg.bins) ? _cfg.bins - 1 : (uint16_t)b;
+    }
+    /*!
+      @brief Percentile
+      @param p Percent (0.0 - 100.0)
+      @return Raw value, interpolated within the bin. 0 if empty
+      @note O(bins). Exact when shift is 0, otherwise within a bin width of the true value
+     */
+    uint16_t percentile(const float p) const;
+    /*!
+      @brief Several percentiles in one pass
+      @param[out] out Raw values (n)
+      @param p Percents in ascending order (n)
+      @param n Number of percentiles
+     */
+    void percentiles(uint16_t* out, const float* p, const uint16_t n) const;
+    //! @brief Pixels in the bins below the bin of the raw value
+    uint16_t below(const uint16_t raw) const;
+    ///@}
+
+private:
+    config_t _cfg{};
+    std::vector<uint16_t> _bins{};
+    uint16_t _raw[frame_pixels]{};
+    uint16_t _total{};
+    uint8_t _present{};  // Bits of the subpages counted
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,245 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file palette.hpp
+  @brief Colour palettes generated at compile time
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_PALETTE_HPP
+#define M5_UNIT_THERMO_THERMAL2_PALETTE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @enum PaletteFormat
+  @brief Pixel format of the palette
+ */
+enum class PaletteFormat : uint8_t {
+    RGB565,    //!< uint16_t RRRRRGGGGGGBBBBB
+    RGB565BE,  //!< uint16_t RGB565 with the bytes swapped, as written to the frame buffer of the SPI displays
+    RGB888,    //!< uint32_t 0x00RRGGBB
+    ARGB8888,  //!< uint32_t 0xFFRRGGBB
+};
+
+/*!
+  @struct PaletteStop
+  @brief Control point of a palette
+ */
+struct PaletteStop {
+    uint8_t pos;      //!< Index (0-255)
+    uint8_t r, g, b;  //!< RGB888
+};
+
+///@cond
+template <PaletteFormat F>
+struct palette_traits;
+template <>
+struct palette_traits<PaletteFormat::RGB565> {
+    using type = uint16_t;
+    static constexpr type encode(const uint8_t r, const uint8_t g, const uint8_t b)
+    {
+        return (type)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    }
+};
+template <>
+struct palette_traits<PaletteFormat::RGB565BE> {
+    using type = uint16_t;
+    static constexpr type encode(const uint8_t r, const uint8_t g, const uint8_t b)
+    {
+        return (type)((palette_traits<PaletteFormat::RGB565>::encode(r, g, b) >> 8) |
+                      (palette_traits<PaletteFormat::RGB565>::encode(r, g, b) << 8));
+    }
+};
+template <>
+struct palette_traits<PaletteFormat::RGB888> {
+    using type = uint32_t;
+    static constexpr type encode(const uint8_t r, const uint8_t g, const uint8_t b)
+    {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+};
+template <>
+struct palette_traits<PaletteFormat::ARGB8888> {
+    using type = uint32_t;
+    static constexpr type encode(const uint8_t r, const uint8_t g, const uint8_t b)
+    {
+        return 0xFF000000U | palette_traits<PaletteFormat::RGB888>::encode(r, g, b);
+    }
+};
+///@endcond
+
+/*!
+  @struct Palette
+  @brief 256 colours
+  @tparam F Pixel format
+ */
+template <PaletteFormat F>
+struct Palette {
+    using value_type = typename palette_traits<F>::type;
+    value_type color[256];
+
+    //! @brief Colour of the index
+    constexpr value_type operator[](const uint8_t idx) const
+    {
+        return color[idx];
+    }
+    //! @brief The colours
+    constexpr const value_type* data() const
+    {
+        return color;
+    }
+    //! @brief Number of colours
+    static constexpr size_t size()
+    {
+        return 256;
+    }
+};
+
+///@cond
+// C++11 constexpr functions are a single return statement, so the colours are made by recursion and pack expansion
+template <size_t... I>
+struct palette_indices {};
+template <size_t N, size_t... I>
+struct make_palette_indices : make_palette_indices<N - 1, N - 1, I...> {};
+template <size_t... I>
+struct make_palette_indices<0, I...> {
+    using type = palette_indices<I...>;
+};
+
+// Control point the segment of the index starts from
+template <size_t N>
+constexpr size_t palette_segment(const PaletteStop (&stops)[N], const int32_t i, const size_t s = 0)
+{
+    return (s + 2 < N && i > stops[s + 1].pos) ? palette_segment(stops, i, s + 1) : s;
+}
+constexpr int32_t palette_clamp(const int32_t t, const int32_t span)
+{
+    return (t < 0) ? 0 : (t > span) ? span : t;
+}
+constexpr uint8_t palette_lerp(const uint8_t a, const uint8_t b, const int32_t span, const int32_t t)
+{
+    return (uint8_t)((a * (span - t) + b * t + (span >> 1)) / span);
+}
+template <PaletteFormat F>
+constexpr typename palette_traits<F>::type palette_color(const PaletteStop& a, const PaletteStop& b, const int32_t i)
+{
+    return (b.pos - a.pos <= 0) ? palette_traits<F>::encode(b.r, b.g, b.b)
+                                : palette_traits<F>::encode(
+                                      palette_lerp(a.r, b.r, b.pos - a.pos, palette_clamp(i - a.pos, b.pos - a.pos)),
+                                      palette_lerp(a.g, b.g, b.pos - a.pos, palette_clamp(i - a.pos, b.pos - a.pos)),
+                                      palette_lerp(a.b, b.b, b.pos - a.pos, palette_clamp(i - a.pos, b.pos - a.pos)));
+}
+template <PaletteFormat F, size_t N>
+constexpr typename palette_traits<F>::type palette_color(const PaletteStop (&stops)[N], const int32_t i,
+                                                         const size_t s)
+{
+    return palette_color<F>(stops[s], stops[(N > 1) ? s + 1 : s], i);
+}
+template <PaletteFormat F, size_t N, size_t... I>
+constexpr Palette<F> make_palette(const PaletteStop (&stops)[N], palette_indices<I...>)
+{
+    return Palette<F>{{palette_color<F>(stops, (int32_t)I, palette_segment(stops, (int32_t)I))...}};
+}
+///@endcond
+
+/*!
+  @brief Make the palette from the control points
+  @tparam F Pixel format
+  @tparam N Number of the control points
+  @param stops Control points in ascending order of the position. The first should be at 0 and the last at 255
+  @details Colours between the control points are linear in RGB888. Use it for a constexpr variable
+  so that the table is made by the compiler
+  @code
+  constexpr PaletteStop fire[] = {{0, 0x00, 0x00, 0x00}, {128, 0xFF, 0x00, 0x00}, {255, 0xFF, 0xFF, 0x00}};
+  constexpr auto fire565 = make_palette<PaletteFormat::RGB565>(fire);
+  @endcode
+ */
+template <PaletteFormat F, size_t N>
+constexpr Palette<F> make_palette(const PaletteStop (&stops)[N])
+{
+    return make_palette<F>(stops, typename make_palette_indices<256>::type{});
+}
+
+/*!
+  @brief Built-in control points
+ */
+namespace palette_stops {
+//! @brief Black, purple, orange, yellow, white (iron)
+constexpr PaletteStop iron[] = {
+    {0, 0x00, 0x00, 0x21}, {37, 0x42, 0x10, 0x7B}, {63, 0x84, 0x24, 0x9C}, {88, 0xBD, 0x3D, 0x63},
+    {122, 0xF7, 0x69, 0x00}, {173, 0xFF, 0xC6, 0x08}, {203, 0xFF, 0xEF, 0x42}, {240, 0xFF, 0xFF, 0xCE},
+    {255, 0xFF, 0xFF, 0xFF},
+};
+//! @brief Blue, green, yellow, red, pink
+constexpr PaletteStop rainbow[] = {
+    {0, 0x00, 0x00, 0x4A}, {11, 0x00, 0x08, 0x5A}, {26, 0x00, 0x35, 0x8C}, {59, 0x00, 0x69, 0xDE},
+    {75, 0x00, 0x86, 0xCE}, {90, 0x19, 0x9E, 0x6B}, {102, 0x63, 0xB6, 0x19}, {121, 0xBD, 0xD2, 0x00},
+    {141, 0xEF, 0xD2, 0x00}, {157, 0xFF, 0xBA, 0x10}, {170, 0xFF, 0x96, 0x19}, {192, 0xFF, 0x20, 0x3A},
+    {207, 0xF7, 0x18, 0x52}, {222, 0xFF, 0x61, 0x6B}, {226, 0xFF, 0x6D, 0x73}, {248, 0xFF, 0xDB, 0xBD},
+    {255, 0xFF, 0xEB, 0xD6},
+};
+//! @brief Black to white (white hot)
+constexpr PaletteStop grayscale[] = {
+    {0, 0x00, 0x00, 0x00}, {255, 0xFF, 0xFF, 0xFF},
+};
+//! @brief White to black, then iron. Cold and hot objects both stand out from the room
+constexpr PaletteStop iron_black[] = {
+    {0, 0xFF, 0xFF, 0xFF}, {127, 0x00, 0x00, 0x00}, {145, 0x29, 0x00, 0x7B}, {176, 0xBD, 0x08, 0x8C},
+    {196, 0xE6, 0x45, 0x21}, {215, 0xF7, 0x8A, 0x08}, {240, 0xFF, 0xE3, 0x21}, {254, 0xFF, 0xFF, 0xEF},
+    {255, 0xFF, 0xFF, 0x19},
+};
+//! @brief Purple, blue, cyan, green, yellow, red
+constexpr PaletteStop cam[] = {
+    {0, 0x4A, 0x00, 0x7B}, {34, 0x00, 0x04, 0x8C}, {80, 0x00, 0x8E, 0xA5}, {90, 0x00, 0xAE, 0xA5},
+    {145, 0x00, 0xC6, 0x00}, {200, 0xDE, 0xDF, 0x00}, {255, 0xFF, 0x00, 0x00},
+};
+//! @brief Fully saturated hues with alternating brightness so that small differences are visible
+constexpr PaletteStop high_contrast[] = {
+    {0, 0x00, 0x00, 0x00}, {36, 0x00, 0x00, 0xFF}, {73, 0x00, 0xFF, 0xFF}, {109, 0x00, 0x80, 0x00},
+    {146, 0xFF, 0xFF, 0x00}, {182, 0xFF, 0x00, 0x00}, {219, 0xFF, 0x00, 0xFF}, {255, 0xFF, 0xFF, 0xFF},
+};
+}  // namespace palette_stops
+
+/*!
+  @struct Palettes
+  @brief Built-in palettes, made at compile time
+  @tparam F Pixel format
+  @code
+  display.pushPixel(Palettes<PaletteFormat::RGB565>::iron[index]);
+  @endcode
+ */
+template <PaletteFormat F>
+struct Palettes {
+    static constexpr Palette<F> iron          = make_palette<F>(palette_stops::iron);
+    static constexpr Palette<F> rainbow       = make_palette<F>(palette_stops::rainbow);
+    static constexpr Palette<F> grayscale     = make_palette<F>(palette_stops::grayscale);
+    static constexpr Palette<F> iron_black    = make_palette<F>(palette_stops::iron_black);
+    static constexpr Palette<F> cam           = make_palette<F>(palette_stops::cam);
+    static constexpr Palette<F> high_contrast = make_palette<F>(palette_stops::high_contrast);
+};
+///@cond
+template <PaletteFormat F>
+constexpr Palette<F> Palettes<F>::iron;
+template <PaletteFormat F>
+constexpr Palette<F> Palettes<F>::rainbow;
+template <PaletteFormat F>
+constexpr Palette<F> Palettes<F>::grayscale;
+template <PaletteFormat F>
+constexpr Palette<F> Palettes<F>::iron_black;
+template <PaletteFormat F>
+constexpr Palette<F> Palettes<F>::cam;
+template <PaletteFormat F>
+constexpr Palette<F> Palettes<F>::high_contrast;
+///@endcond
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
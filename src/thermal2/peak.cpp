@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file peak.cpp
+  @brief Sub-pixel peak localisation for Thermal2 frames
+*/
+#include "peak.hpp"
+
+namespace {
+
+using namespace m5::unit::thermal2;
+
+constexpr uint8_t climb_steps{4};
+
+// Pixel accessor on the full frame or on a subpage, -1 if not available
+struct full_frame_t {
+    const uint16_t* frame;
+    static constexpr int_fast8_t step{1};  // Spacing on the axes
+    inline int32_t operator()(const int_fast8_t x, const int_fast8_t y) const
+    {
+        return (x < 0 || y < 0 || x >= frame_width || y >= frame_height) ? -1 : frame[y * frame_width + x];
+    }
+};
+
+struct subpage_t {
+    const uint16_t* raw;
+    uint8_t subpage;
+    static constexpr int_fast8_t step{2};
+    inline int32_t operator()(const int_fast8_t x, const int_fast8_t y) const
+    {
+        return (x < 0 || y < 0 || x >= frame_width || y >= frame_height || !is_subpage_pixel(subpage, x, y))
+                   ? -1
+                   : raw[y * (frame_width >> 1) + (x >> 1)];
+    }
+};
+
+// Vertex of the parabola through (-s, l), (0, c), (s, r), returns the offset and adds the height to peak
+inline float vertex(const int32_t l, const int32_t c, const int32_t r, const int_fast8_t s, float& peak)
+{
+    const int32_t den = l - 2 * c + r;
+    if (l < 0 || r < 0 || den >= 0) {
+        return 0.0f;
+    }
+    float off = 0.5f * (l - r) / den;
+    off       = off < -0.5f ? -0.5f : off > 0.5f ? 0.5f : off;
+    peak -= 0.125f * (float)(l - r) * (l - r) / den;
+    return off * s;
+}
+
+template <class F>
+bool locate(SubpixelPeak& out, const F& get, int_fast8_t x, int_fast8_t y, const PeakFit fit)
+{
+    constexpr int_fast8_t s{F::step};
+    // Same-kind neighbours (8 on the full frame, the diagonals and the axes at 2 on a subpage)
+    static constexpr int8_t around[8][2] = {{-s, 0}, {s, 0}, {0, -s}, {0, s}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
+    if (get(x, y) < 0) {
+        return false;
+    }
+    for (uint_fast8_t i = 0; i < climb_steps; ++i) {
+        int_fast8_t bx{x}, by{y};
+        int32_t best = get(x, y);
+        for (auto&& o : around) {
+            const int32_t v = get(x + o[0], y + o[1]);
+            if (v > best) {
+                best = v;
+                bx   = x + o[0];
+                by   = y + o[1];
+            }
+        }
+        if (bx == x && by == y) {
+            break;
+        }
+        x = bx;
+        y = by;
+    }
+
+    const int32_t c = get(x, y);
+    out.px          = x;
+    out.py          = y;
+    out.value       = c;
+    const float dx  = vertex(get(x - s, y), c, get(x + s, y), s, out.value);
+    const float dy  = vertex(get(x, y - s), c, get(x, y + s), s, out.value);
+
+    if (fit == PeakFit::Quadratic) {
+        out.x = x + dx;
+        out.y = y + dy;
+        return true;
+    }
+
+    int32_t lowest{c};
+    for (auto&& o : around) {
+        const int32_t v = get(x + o[0], y + o[1]);
+        lowest          = (v >= 0 && v < lowest) ? v : lowest;
+    }
+    int32_t sw{c - lowest}, sx{}, sy{};
+    for (auto&& o : around) {
+        const int32_t v = get(x + o[0], y + o[1]);
+        if (v >= 0) {
+            sw += v - lowest;
+            sx += (v - lowest) * o[0];
+            sy += (v - lowest) * o[1];
+        }
+    }
+    out.x = x + (sw ? (float)sx / sw : 0.0f);
+    out.y = y + (sw ? (float)sy / sw : 0.0f);
+    return true;
+}
+
+}  // namespace
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+bool subpixel_peak(SubpixelPeak& out, const uint16_t* frame, const uint8_t x, const uint8_t y, const PeakFit fit)
+{
+    return frame && locate(out, full_frame_t{frame}, x, y, fit);
+}
+
+bool subpixel_peak(SubpixelPeak& out, const uint16_t* raw, const uint8_t subpage, const uint8_t x, const uint8_t y,
+                   const PeakFit fit)
+{
+    return raw && locate(out, subpage_t{raw, (uint8_t)(subpage & 1)}, x, y, fit);
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file peak.hpp
+  @brief Sub-pixel peak localisation for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_PEAK_HPP
+#define M5_UNIT_THERMO_THERMAL2_PEAK_HPP
+
+#include "frame.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @enum PeakFit
+  @brief Sub-pixel fitting method
+ */
+enum class PeakFit : uint8_t {
+    Quadratic,  //!< Parabola through the peak and its neighbours on each axis
+    Centroid,   //!< Centroid of the neighbourhood weighted by the height above its lowest
+};
+
+/*!
+  @struct SubpixelPeak
+  @brief Peak with fractional coordinates
+ */
+struct SubpixelPeak {
+    float x{}, y{};  //!< Position (pixels on the full frame)
+    float value{};   //!< Interpolated peak (raw)
+    uint8_t px{};    //!< X of the peak pixel
+    uint8_t py{};    //!< Y of the peak pixel
+};
+
+/*!
+  @brief Locate the peak around the pixel with sub-pixel accuracy
+  @param[out] out Peak
+  @param frame Raw pixel data (768)
+  @param x X of the hottest pixel (e.g. highest_diff_x)
+  @param y Y of the hottest pixel (e.g. highest_diff_y)
+  @param fit Fitting method
+  @return True if successful
+  @details If the pixel is not a local maximum (e.g. the coordinate is from an older frame),
+  it first climbs a few steps to the neighbouring local maximum.
+  The value is always the vertex of the parabolas
+ */
+bool subpixel_peak(SubpixelPeak& out, const uint16_t* frame, const uint8_t x, const uint8_t y,
+                   const PeakFit fit = PeakFit::Quadratic);
+//! @brief Locate the peak around the pixel of the frame with sub-pixel accuracy
+inline bool subpixel_peak(SubpixelPeak& out, const Frame& frame, const uint8_t x, const uint8_t y,
+                          const PeakFit fit = PeakFit::Quadratic)
+{
+    return subpixel_peak(out, frame.raw, x, y, fit);
+}
+
+/*!
+  @brief Locate the peak around the pixel of a subpage with sub-pixel accuracy
+  @param[out] out Peak
+  @param raw Raw pixel data of the subpage (384)
+  @param subpage Subpage 0:even 1:odd
+  @param x X of the hottest pixel on the full frame
+  @param y Y of the hottest pixel on the full frame
+  @param fit Fitting method
+  @return True if successful, false if the pixel does not belong to the subpage
+  @note Only the checkerboard pixels of the subpage are available,
+  so the fit uses the diagonals and the pixels two apart on each axis
+ */
+bool subpixel_peak(SubpixelPeak& out, const uint16_t* raw, const uint8_t subpage, const uint8_t x, const uint8_t y,
+                   const PeakFit fit = PeakFit::Quadratic);
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,257 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file pixel_health.cpp
+  @brief Dead and unstable pixel detection for Thermal2 frames
+*/
+#include "pixel_health.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+void PixelHealth::reset()
+{
+    std::memset(_dev, 0, sizeof(_dev));
+    std::memset(_var, 0, sizeof(_var));
+    std::memset(_outlier, 0, sizeof(_outlier));
+    std::memset(_noisy, 0, sizeof(_noisy));
+    std::memset(_still, 0, sizeof(_still));
+    _updates[0]  = 0;
+    _updates[1]  = 0;
+    _deviated[0] = false;
+    _deviated[1] = false;
+}
+
+void PixelHealth::clear()
+{
+    std::memset(_bad, 0, sizeof(_bad));
+    std::fill(std::begin(_reason), std::end(_reason), Reason::None);
+    _dirty = true;
+}
+
+void PixelHealth::update(const uint16_t* raw, const uint8_t subpage)
+{
+    const uint8_t sp    = subpage & 1;
+    const bool primed   = _updates[sp] != 0;
+    const uint8_t shift = _cfg.rate_shift;
+
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+        const uint16_t v        = raw[i];
+        if (primed) {
+            _still[idx] = (v == _frame[idx]) ? (_still[idx] < 0xFF ? _still[idx] + 1 : 0xFF) : 0;
+        }
+        _frame[idx] = v;
+    }
+    _updates[sp] += (_updates[sp] < UINT32_MAX);
+
+    // Neighbours need both subpages
+    if (!_updates[sp ^ 1]) {
+        return;
+    }
+
+    // The departure is the change of the deviation from the neighbour median between updates.
+    // A pixel that follows its neighbours keeps it near zero whatever its own temperature is
+    uint16_t departure[subpage_pixels];
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+        const uint_fast8_t x    = idx % frame_width;
+        const uint_fast8_t y    = idx / frame_width;
+        int32_t dev             = (int32_t)_frame[idx] - neighbour_median(x, y);
+        dev                     = dev < INT16_MIN ? INT16_MIN : dev > INT16_MAX ? INT16_MAX : dev;
+        int32_t d               = dev - _dev[idx];
+        d                       = d < 0 ? -d : d;
+        departure[i]            = d > 4095 ? 4095 : d;  // Keep d^2 in range
+        _dev[idx]               = (int16_t)dev;
+    }
+    if (!_deviated[sp]) {
+        _deviated[sp] = true;
+        return;
+    }
+
+    // Noisy is relative to the median of the subpage, so that a busy scene or a moving edge does not flag everything
+    uint16_t sorted[subpage_pixels];
+    std::copy(std::begin(departure), std::end(departure), std::begin(sorted));
+    std::nth_element(std::begin(sorted), std::begin(sorted) + subpage_pixels / 2, std::end(sorted));
+    const uint32_t med   = sorted[subpage_pixels / 2];
+    const uint32_t noisy = std::max<uint32_t>(med * med * _cfg.noisy_ratio, _cfg.noisy_floor);
+
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+        const int32_t d         = departure[i];
+        const int32_t d2        = d * d;
+        const int32_t ohit      = (d > _cfg.outlier_delta) ? 0xFFFF : 0;
+        const int32_t nhit      = ((uint32_t)d2 > noisy) ? 0xFFFF : 0;
+        _var[idx]               = (uint32_t)((int32_t)_var[idx] + ((d2 - (int32_t)_var[idx]) >> shift));
+        _outlier[idx]           = (uint16_t)(_outlier[idx] + ((ohit - (int32_t)_outlier[idx]) >> shift));
+        _noisy[idx]             = (uint16_t)(_noisy[idx] + ((nhit - (int32_t)_noisy[idx]) >> shift));
+    }
+
+    if (!_cfg.learn || _updates[sp] <= _cfg.warmup || _updates[sp ^ 1] <= _cfg.warmup) {
+        return;
+    }
+
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+        if (isBad(idx)) {
+            // Learned from the behaviour, expires once the pixel follows its neighbours again
+            if ((_reason[idx] == Reason::Outlier && _outlier[idx] < (_cfg.outlier_rate >> 1)) ||
+                (_reason[idx] == Reason::Noisy && _noisy[idx] < (_cfg.noisy_rate >> 1))) {
+                unflag(idx);
+            }
+            continue;
+        }
+        const uint16_t v = _frame[idx];
+        if (v == 0 || v == 0xFFFF) {
+            flag(idx, Reason::Dead);
+        } else if (_still[idx] >= _cfg.stuck_updates) {
+            flag(idx, Reason::Stuck);
+        } else if (_outlier[idx] > _cfg.outlier_rate) {
+            flag(idx, Reason::Outlier);
+        } else if (_noisy[idx] > _cfg.noisy_rate) {
+            flag(idx, Reason::Noisy);
+        }
+    }
+}
+
+void PixelHealth::interpolate(uint16_t* raw, const uint8_t subpage) const
+{
+    const uint8_t sp = subpage & 1;
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+        if (isBad(idx)) {
+            raw[i] = estimate(_frame, idx % frame_width, idx / frame_width);
+        }
+    }
+}
+
+void PixelHealth::interpolate(uint16_t* frame) const
+{
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        for (uint32_t m = _bad[y]; m; m &= m - 1) {
+            const uint_fast8_t x       = __builtin_ctz(m);
+            frame[y * frame_width + x] = estimate(frame, x, y);
+        }
+    }
+}
+
+void PixelHealth::mark(const uint_fast16_t idx, const bool bad)
+{
+    if (idx >= frame_pixels) {
+        return;
+    }
+    if (bad) {
+        flag(idx, Reason::Manual);
+    } else {
+        unflag(idx);
+    }
+}
+
+uint16_t PixelHealth::count() const
+{
+    uint16_t cnt{};
+    for (auto&& m : _bad) {
+        cnt += __builtin_popcount(m);
+    }
+    return cnt;
+}
+
+bool PixelHealth::load(PixelHealthStorage& storage)
+{
+    uint32_t bitmap[frame_height]{};
+    if (!storage.load(bitmap)) {
+        return false;
+    }
+    std::memcpy(_bad, bitmap, sizeof(_bad));
+    for (uint_fast16_t idx = 0; idx < frame_pixels; ++idx) {
+        _reason[idx] = isBad(idx) ? Reason::Manual : Reason::None;
+    }
+    _dirty = false;
+    return true;
+}
+
+bool PixelHealth::save(PixelHealthStorage& storage)
+{
+    if (!storage.save(_bad)) {
+        return false;
+    }
+    _dirty = false;
+    return true;
+}
+
+void PixelHealth::flag(const uint_fast16_t idx, const Reason r)
+{
+    if (!isBad(idx)) {
+        _bad[idx / frame_width] |= 1U << (idx % frame_width);
+        _reason[idx] = r;
+        _dirty       = true;
+    }
+}
+
+void PixelHealth::unflag(const uint_fast16_t idx)
+{
+    if (isBad(idx)) {
+        _bad[idx / frame_width] &= ~(1U << (idx % frame_width));
+        _reason[idx] = Reason::None;
+        _dirty       = true;
+    }
+}
+
+uint16_t PixelHealth::neighbour_median(const uint_fast8_t x, const uint_fast8_t y) const
+{
+    uint16_t v[8];
+    uint_fast8_t n{};
+    for (int_fast8_t j = -1; j <= 1; ++j) {
+        const int_fast8_t yy = y + j;
+        if (yy < 0 || yy >= frame_height) {
+            continue;
+        }
+        for (int_fast8_t i = -1; i <= 1; ++i) {
+            const int_fast8_t xx = x + i;
+            if ((i | j) == 0 || xx < 0 || xx >= frame_width || isBad(xx, yy)) {
+                continue;
+            }
+            // Insertion sort, at most 8 values
+            const uint16_t val = _frame[yy * frame_width + xx];
+            uint_fast8_t k     = n++;
+            for (; k && v[k - 1] > val; --k) {
+                v[k] = v[k - 1];
+            }
+            v[k] = val;
+        }
+    }
+    return n ? v[n >> 1] : _frame[y * frame_width + x];
+}
+
+uint16_t PixelHealth::estimate(const uint16_t* frame, const uint_fast8_t x, const uint_fast8_t y) const
+{
+    // Good 4-neighbours (the other subpage), then good diagonals (the same subpage)
+    static constexpr int8_t offset[2][4][2] = {{{0, -1}, {-1, 0}, {1, 0}, {0, 1}},
+                                               {{-1, -1}, {1, -1}, {-1, 1}, {1, 1}}};
+    for (auto&& ring : offset) {
+        uint32_t sum{}, cnt{};
+        for (auto&& o : ring) {
+            const int_fast8_t xx = x + o[0];
+            const int_fast8_t yy = y + o[1];
+            if (xx >= 0 && xx < frame_width && yy >= 0 && yy < frame_height && !isBad(xx, yy)) {
+                sum += frame[yy * frame_width + xx];
+                ++cnt;
+            }
+        }
+        if (cnt) {
+            return (uint16_t)((sum + (cnt >> 1)) / cnt);
+        }
+    }
+    return frame[y * frame_width + x];
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,245 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file pixel_health.hpp
+  @brief Dead and unstable pixel detection for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_PIXEL_HEALTH_HPP
+#define M5_UNIT_THERMO_THERMAL2_PIXEL_HEALTH_HPP
+
+#include "frame.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class PixelHealthStorage
+  @brief Storage interface for the bad pixel bitmap
+  @details Implement this on top of NVS, a file or anything else that survives a reboot
+ */
+class PixelHealthStorage {
+public:
+    virtual ~PixelHealthStorage() = default;
+    /*!
+      @brief Load the bitmap
+      @param[out] bitmap Bit x of bitmap[y] (24) for the pixel (x, y)
+      @return True if successful
+     */
+    virtual bool load(uint32_t* bitmap) = 0;
+    /*!
+      @brief Save the bitmap
+      @param bitmap Bit x of bitmap[y] (24) for the pixel (x, y)
+      @return True if successful
+     */
+    virtual bool save(const uint32_t* bitmap) = 0;
+};
+
+/*!
+  @class PixelHealth
+  @brief Learns per-pixel stability and keeps a bad pixel bitmap
+  @details Fed with every subpage, it learns for each pixel
+  - How often its change between frames departs from the change of its neighbours (EWMA)
+  - The variance of that departure (EWMA)
+  - How many frames in a row the value did not change at all
+
+  A pixel is compared with its neighbours over time, not with the scene itself.
+  A static hot object keeps its offset from the neighbours and a moving object disturbs a pixel only while it passes,
+  so neither looks like a fault.
+  After the warm-up a pixel is flagged as bad if it is dead (0 or 0xFFFF), stuck, an outlier or noisy.
+  Dead, stuck and manual flags are sticky until cleared, so the bitmap can be persisted and reused.
+  Outlier and noisy flags expire once the pixel follows its neighbours again
+  @note Uses about 11KiB
+ */
+class PixelHealth {
+public:
+    /*!
+      @enum Reason
+      @brief Why the pixel was flagged
+     */
+    enum class Reason : uint8_t {
+        None,     //!< Healthy
+        Dead,     //!< Reads 0 or 0xFFFF
+        Stuck,    //!< Value does not change
+        Outlier,  //!< Often jumps away from its neighbours
+        Noisy,    //!< Departs from its neighbours far more than the other pixels
+        Manual,   //!< Marked by the application or loaded from storage
+    };
+
+    /*!
+      @struct config_t
+      @brief Tracker settings
+     */
+    struct config_t {
+        //! Updates of each subpage before pixels are flagged
+        uint16_t warmup{32};
+        //! EWMA weight as a right shift (1/32 by default)
+        uint8_t rate_shift{5};
+        //! Raw departure from the change of the neighbour median that counts as an outlier (384: 3 celsius)
+        uint16_t outlier_delta{384};
+        //! Outlier rate that flags the pixel (Q16, 16384: 25%), the flag expires under half of it
+        uint16_t outlier_rate{16384};
+        //! Unchanged updates in a row that flag the pixel as stuck
+        uint8_t stuck_updates{32};
+        //! Squared departure over the squared median departure of the subpage that counts as noisy
+        uint16_t noisy_ratio{16};
+        //! Squared departure (raw^2) never considered noisy (256: 16 raw)
+        uint32_t noisy_floor{256};
+        //! Noisy rate that flags the pixel (Q16, 32768: 50%), the flag expires under half of it
+        uint16_t noisy_rate{32768};
+        //! Flag pixels automatically?
+        bool learn{true};
+    };
+
+    PixelHealth() = default;
+    explicit PixelHealth(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    //! @brief Forget the learned statistics (the bitmap is kept)
+    void reset();
+    //! @brief Clear the bitmap
+    void clear();
+
+    /*!
+      @brief Learn from the subpage
+      @param raw Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+     */
+    void update(const uint16_t* raw, const uint8_t subpage);
+
+    /*!
+      @brief Replace the bad pixels of the subpage with the interpolation of their neighbours
+      @param[in,out] raw Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+      @note Neighbours are taken from the frame assembled by update()
+     */
+    void interpolate(uint16_t* raw, const uint8_t subpage) const;
+    /*!
+      @brief Replace the bad pixels of the frame with the interpolation of their neighbours
+      @param[in,out] frame Raw pixel data (768)
+     */
+    void interpolate(uint16_t* frame) const;
+    //! @brief Replace the bad pixels of the frame with the interpolation of their neighbours
+    inline void interpolate(Frame& frame) const
+    {
+        interpolate(frame.raw);
+    }
+
+    /*!
+      @brief Summarize the frame assembled by update() without the bad pixels
+      @param[out] out Summary
+      @return True if both subpages have been fed and at least one pixel is good
+     */
+    inline bool summarize(FrameSummary& out) const
+    {
+        return assembled() && thermal2::summarize(out, _frame, _bad);
+    }
+    //! @brief Have both subpages been fed since reset?
+    inline bool assembled() const
+    {
+        return _updates[0] && _updates[1];
+    }
+
+    ///@name Bitmap
+    ///@{
+    //! @brief Is the pixel bad?
+    inline bool isBad(const uint_fast8_t x, const uint_fast8_t y) const
+    {
+        return _bad[y] & (1U << x);
+    }
+    //! @brief Is the pixel bad?
+    inline bool isBad(const uint_fast16_t idx) const
+    {
+        return isBad(idx % frame_width, idx / frame_width);
+    }
+    //! @brief Why the pixel was flagged
+    inline Reason reason(const uint_fast16_t idx) const
+    {
+        return _reason[idx];
+    }
+    //! @brief Mark or unmark the pixel manually
+    void mark(const uint_fast16_t idx, const bool bad = true);
+    //! @brief Number of bad pixels
+    uint16_t count() const;
+    //! @brief Bitmap, bit x of bitmap()[y] (24) for the pixel (x, y)
+    inline const uint32_t* bitmap() const
+    {
+        return _bad;
+    }
+    //! @brief Has the bitmap changed since loaded or saved?
+    inline bool dirty() const
+    {
+        return _dirty;
+    }
+    ///@}
+
+    ///@name Storage
+    ///@{
+    //! @brief Load the bitmap, pixels are marked as Manual
+    bool load(PixelHealthStorage& storage);
+    //! @brief Save the bitmap
+    bool save(PixelHealthStorage& storage);
+    ///@}
+
+    ///@name Learned statistics
+    ///@{
+    //! @brief Variance of the departure from the change of the neighbours (raw^2)
+    inline uint32_t variance(const uint_fast16_t idx) const
+    {
+        return _var[idx];
+    }
+    //! @brief Outlier rate (Q16)
+    inline uint16_t outlierRate(const uint_fast16_t idx) const
+    {
+        return _outlier[idx];
+    }
+    //! @brief Noisy rate (Q16)
+    inline uint16_t noisyRate(const uint_fast16_t idx) const
+    {
+        return _noisy[idx];
+    }
+    ///@}
+
+protected:
+    void flag(const uint_fast16_t idx, const Reason r);
+    void unflag(const uint_fast16_t idx);
+    uint16_t neighbour_median(const uint_fast8_t x, const uint_fast8_t y) const;
+    uint16_t estimate(const uint16_t* frame, const uint_fast8_t x, const uint_fast8_t y) const;
+
+private:
+    config_t _cfg{};
+    uint16_t _frame[frame_pixels]{};  // Latest raw values
+    int16_t _dev[frame_pixels]{};     // Latest deviation from the neighbour median
+    uint32_t _var[frame_pixels]{};
+    uint16_t _outlier[frame_pixels]{};
+    uint16_t _noisy[frame_pixels]{};
+    uint8_t _still[frame_pixels]{};
+    Reason _reason[frame_pixels]{};
+    uint32_t _bad[frame_height]{};
+    uint32_t _updates[2]{};
+    bool _deviated[2]{};  // _dev holds the subpage?
+    bool _dirty{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,366 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file recording.cpp
+  @brief Append-only recording file of Thermal2 subpages
+*/
+#include "recording.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+namespace {
+inline void set16(uint8_t* p, const uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+inline void set32(uint8_t* p, const uint32_t v)
+{
+    set16(p, v & 0xFFFF);
+    set16(p + 2, v >> 16);
+}
+inline uint16_t get16(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8);
+}
+inline uint32_t get32(const uint8_t* p)
+{
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+// Chunk header and CRC around the payload already at out + 8
+size_t make_chunk(uint8_t* out, const uint16_t type, const uint16_t len)
+{
+    set32(out, recording_magic);
+    set16(out + 4, type);
+    set16(out + 6, len);
+    set16(out + 8 + len, stream_crc16(out, 8 + len));
+    return recording_chunk_overhead + len;
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// RecordingWriter
+DeltaEncoder::config_t RecordingWriter::codec_config()
+{
+    // Keyframes are requested at the sync points only
+    DeltaEncoder::config_t cfg{};
+    cfg.keyframe_interval = 0;
+    return cfg;
+}
+
+size_t RecordingWriter::begin(uint8_t* out, const RecordingHeader& header)
+{
+    if (!out) {
+        return 0;
+    }
+    _cfg.sync_interval = std::max<uint16_t>(_cfg.sync_interval, 1);
+    _cfg.index_entries = std::min<uint16_t>(std::max<uint16_t>(_cfg.index_entries, 1), recording_max_index_entries);
+
+    uint8_t* p = out + 8;
+    set16(p, recording_version);
+    p[2] = header.refresh_rate;
+    p[3] = header.noise_filter;
+    set16(p + 4, (uint16_t)std::lround(std::min(std::max(header.emissivity, 0.0f), 1.0f) * 10000));
+    set16(p + 6, _cfg.sync_interval);
+    set16(p + 8, _cfg.index_entries);
+    p[10] = _cfg.compress ? 1 : 0;
+    p[11] = 0;
+    set32(p + 12, header.start_time & 0xFFFFFFFFU);
+    set32(p + 16, header.start_time >> 32);
+
+    _entries.clear();
+    _undo_index = false;
+    _compress   = _cfg.compress;
+    _offset     = make_chunk(out, recording_chunk_header, 20);
+    _last_index = 0;
+    _since_sync = _cfg.sync_interval;
+    _begun      = true;
+    return _offset;
+}
+
+bool RecordingWriter::resume(const RecordingReader& reader)
+{
+    if (!reader._data) {
+        return false;
+    }
+    const auto& h      = reader.header();
+    _cfg.compress      = h.compressed;
+    _cfg.sync_interval = h.sync_interval;
+    _cfg.index_entries = h.index_entries;
+    _entries.assign(reader._index.begin() + reader._indexed, reader._index.end());
+    _undo_index = false;
+    _compress   = h.compressed;
+    _offset     = reader.end();
+    _last_index = reader._last_index;
+    _since_sync = _cfg.sync_interval;
+    _begun      = true;
+    return true;
+}
+
+size_t RecordingWriter::write(uint8_t* out, const uint16_t* raw, const uint8_t subpage, const uint16_t* temp,
+                              const uint32_t timestamp, const bool torn)
+{
+    if (!_begun || !out || !raw) {
+        return 0;
+    }
+    _undo_offset     = _offset;
+    _undo_last_index = _last_index;
+    _undo_entries    = _entries.size();
+    _undo_index      = false;
+
+    const bool sync = _since_sync >= _cfg.sync_interval;
+    if (sync) {
+        _since_sync = 0;
+        // Both subpages from here on can be decoded without what was before
+        _codec.requestKeyframe();
+        RecordingIndexEntry e{};
+        e.timestamp = timestamp;
+        e.offset    = _offset;
+        _entries.push_back(e);
+    }
+    ++_since_sync;
+
+    uint8_t* p = out + 8;
+    set32(p, timestamp);
+    p[4] = subpage & 1;
+    p[5] = (torn ? recording_flag_torn : 0) | (_compress ? recording_flag_compressed : 0) |
+           (sync ? recording_flag_sync : 0);
+    for (uint_fast8_t i = 0; i < 8; ++i) {
+        set16(p + 6 + i * 2, temp ? temp[i] : 0);
+    }
+    uint16_t len{22};
+    if (_compress) {
+        len += _codec.encode(p + len, raw, subpage);
+    } else {
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            set16(p + len + i * 2, raw[i]);
+        }
+        len += subpage_pixels * 2;
+    }
+    size_t written = make_chunk(out, recording_chunk_subpage, len);
+    _offset += written;
+
+    if (_entries.size() >= _cfg.index_entries) {
+        written += write_index(out + written);
+        _undo_index = true;
+    }
+    return written;
+}
+
+void RecordingWriter::discard()
+{
+    if (!_begun) {
+        return;
+    }
+    if (_undo_index) {
+        // The entries the refused index chunk listed
+        _entries.swap(_indexed);
+        _undo_index = false;
+    }
+    _entries.resize(std::min(_entries.size(), _undo_entries));
+    _offset     = _undo_offset;
+    _last_index = _undo_last_index;
+    // The decoder did not see the subpage the next one would be delta coded from
+    _since_sync = _cfg.sync_interval;
+}
+
+size_t RecordingWriter::finish(uint8_t* out)
+{
+    return (_begun && out && !_entries.empty()) ? write_index(out) : 0;
+}
+
+size_t RecordingWriter::write_index(uint8_t* out)
+{
+    uint8_t* p = out + 8;
+    set32(p, _last_index);
+    set16(p + 4, _entries.size());
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        set32(p + 6 + i * 8, _entries[i].timestamp);
+        set32(p + 10 + i * 8, _entries[i].offset);
+    }
+    const size_t written = make_chunk(out, recording_chunk_index, 6 + _entries.size() * 8);
+    _last_index          = _offset;
+    _offset += written;
+    // Kept for discard()
+    _indexed.swap(_entries);
+    _entries.clear();
+    return written;
+}
+
+// ---------------------------------------------------------------------------
+// RecordingReader
+bool RecordingReader::open(const uint8_t* data, const size_t size)
+{
+    close();
+    _data = data;
+    _size = size;
+
+    uint16_t type{};
+    if (!data || chunk(0, type) != 20 || type != recording_chunk_header) {
+        close();
+        return false;
+    }
+    const uint8_t* p      = data + 8;
+    _header.version       = get16(p);
+    _header.refresh_rate  = p[2];
+    _header.noise_filter  = p[3];
+    _header.emissivity    = get16(p + 4) / 10000.0f;
+    _header.sync_interval = get16(p + 6);
+    _header.index_entries = get16(p + 8);
+    _header.compressed    = p[10] & 1;
+    _header.start_time    = get32(p + 12) | ((uint64_t)get32(p + 16) << 32);
+    _first                = recording_header_size;
+
+    if (_header.version > recording_version) {
+        close();
+        return false;
+    }
+
+    // The last index chunk is within the sync points of an index chunk from the end
+    const size_t chunk_size = recording_chunk_overhead + 22 + codec_max_block_size;
+    const size_t window =
+        (size_t)(_header.index_entries + 1) * _header.sync_interval * chunk_size + recording_max_write_size;
+    const uint32_t lowest = (_size > _first + window) ? _size - window : _first;
+    uint32_t scan         = _first;
+    if (_size >= _first + recording_chunk_overhead) {
+        for (uint32_t pos = _size - recording_chunk_overhead; pos >= lowest; --pos) {
+            if (get32(data + pos) == recording_magic && chunk(pos, type) >= 6 && type == recording_chunk_index) {
+                _last_index = pos;
+                break;
+            }
+            if (pos == lowest) {
+                break;
+            }
+        }
+    }
+
+    // Back along the index chunks
+    std::vector<uint32_t> chain;
+    for (uint32_t pos = _last_index; pos;) {
+        const int32_t len = chunk(pos, type);
+        if (len < 6 || type != recording_chunk_index || get16(_data + pos + 12) * 8 + 6 != len) {
+            break;
+        }
+        chain.push_back(pos);
+        const uint32_t prev = get32(_data + pos + 8);
+        pos                 = (prev < pos) ? prev : 0;
+    }
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        const uint8_t* q   = _data + *it + 8;
+        const uint16_t cnt = get16(q + 4);
+        for (uint_fast16_t i = 0; i < cnt; ++i) {
+            RecordingIndexEntry e{};
+            e.timestamp = get32(q + 6 + i * 8);
+            e.offset    = get32(q + 10 + i * 8);
+            _index.push_back(e);
+        }
+    }
+    _indexed = _index.size();
+    if (_last_index) {
+        scan = _last_index + recording_chunk_overhead + chunk(_last_index, type);
+    }
+
+    // Sync points not indexed yet, and the end of the valid chunks
+    int32_t len{};
+    while ((len = chunk(scan, type)) >= 0) {
+        if (type == recording_chunk_subpage && len >= 22 && (_data[scan + 13] & recording_flag_sync)) {
+            RecordingIndexEntry e{};
+            e.timestamp = get32(_data + scan + 8);
+            e.offset    = scan;
+            _index.push_back(e);
+        }
+        scan += recording_chunk_overhead + len;
+    }
+    _end = scan;
+    rewind();
+    return true;
+}
+
+void RecordingReader::close()
+{
+    _data = nullptr;
+    _size = _end = _cursor = _first = _last_index = _indexed = 0;
+    _header = RecordingHeader{};
+    _index.clear();
+    _codec.invalidate();
+}
+
+bool RecordingReader::seek(const uint32_t timestamp)
+{
+    auto it = std::upper_bound(_index.begin(), _index.end(), timestamp,
+                               [](const uint32_t t, const RecordingIndexEntry& e) { return t < e.timestamp; });
+    if (it == _index.begin()) {
+        return false;
+    }
+    _cursor = (it - 1)->offset;
+    _codec.invalidate();
+    return true;
+}
+
+void RecordingReader::rewind()
+{
+    _cursor = _first;
+    _codec.invalidate();
+}
+
+bool RecordingReader::next(RecordedSubpage& out)
+{
+    uint16_t type{};
+    int32_t len{};
+    while (_cursor < _end && (len = chunk(_cursor, type)) >= 0) {
+        const uint32_t pos = _cursor;
+        _cursor += recording_chunk_overhead + len;
+        if (type != recording_chunk_subpage || len < 22) {
+            continue;
+        }
+        const uint8_t* p = _data + pos + 8;
+        if (p[5] & recording_flag_compressed) {
+            uint8_t sp{};
+            // Subpages before the first keyframes after seeking are skipped
+            if (_codec.decode(p + 22, len - 22, out.raw, sp) != (size_t)len - 22) {
+                continue;
+            }
+        } else if (len == 22 + subpage_pixels * 2) {
+            for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+                out.raw[i] = get16(p + 22 + i * 2);
+            }
+        } else {
+            continue;
+        }
+        out.offset    = pos;
+        out.timestamp = get32(p);
+        out.subpage   = p[4] & 1;
+        out.flags     = p[5];
+        for (uint_fast8_t i = 0; i < 8; ++i) {
+            out.temp[i] = get16(p + 6 + i * 2);
+        }
+        return true;
+    }
+    return false;
+}
+
+int32_t RecordingReader::chunk(const uint32_t offset, uint16_t& type) const
+{
+    if (!_data || (uint64_t)offset + recording_chunk_overhead > _size || get32(_data + offset) != recording_magic) {
+        return -1;
+    }
+    const uint16_t len = get16(_data + offset + 6);
+    if ((uint64_t)offset + recording_chunk_overhead + len > _size ||
+        stream_crc16(_data + offset, 8 + len) != get16(_data + offset + 8 + len)) {
+        return -1;
+    }
+    type = get16(_data + offset + 4);
+    return len;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
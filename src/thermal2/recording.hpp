@@ -0,0 +1,290 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file recording.hpp
+  @brief Append-only recording file of Thermal2 subpages
+  @details The file is a sequence of chunks, only ever appended.
+  |Offset|Size|Content|
+  |---|---|---|
+  |0|4|Magic "T2CK"|
+  |4|2|Type (1: header, 2: subpage, 3: index)|
+  |6|2|Payload length|
+  |8|...|Payload (little endian)|
+  |...|2|CRC-16/CCITT-FALSE of the chunk before|
+  The header is the first chunk. A subpage holds the timestamp, the flags, the temperature information and the
+  raw pixels or a DeltaEncoder block. Every sync_interval subpages one is a sync point where the blocks of both
+  subpages are keyframes, and an index chunk lists the time and the offset of index_entries sync points
+  together with the offset of the previous index chunk.
+  A chunk cut by a power loss fails the CRC, the reader stops there and keeps everything written before
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_RECORDING_HPP
+#define M5_UNIT_THERMO_THERMAL2_RECORDING_HPP
+
+#include "stream.hpp"
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+///@name Recording format
+///@{
+constexpr uint16_t recording_version{1};
+constexpr uint32_t recording_magic{0x4B433254};  // "T2CK"
+constexpr uint16_t recording_chunk_header{1};
+constexpr uint16_t recording_chunk_subpage{2};
+constexpr uint16_t recording_chunk_index{3};
+constexpr uint8_t recording_flag_torn{0x01};
+constexpr uint8_t recording_flag_compressed{0x02};
+constexpr uint8_t recording_flag_sync{0x04};
+//! Chunk header and CRC
+constexpr uint16_t recording_chunk_overhead{8 + 2};
+//! Maximum sync points of an index chunk
+constexpr uint16_t recording_max_index_entries{64};
+//! Header chunk
+constexpr uint16_t recording_header_size{recording_chunk_overhead + 20};
+//! Largest output of RecordingWriter::write, a stored subpage and an index chunk
+constexpr uint16_t recording_max_write_size{recording_chunk_overhead + 22 + codec_max_block_size +
+                                            recording_chunk_overhead + 6 + recording_max_index_entries * 8};
+///@}
+
+/*!
+  @struct RecordingHeader
+  @brief Settings of the recording
+ */
+struct RecordingHeader {
+    uint16_t version{recording_version};  //!< Format version
+    uint8_t refresh_rate{};               //!< Refresh rate (m5::unit::thermal2::Refresh)
+    uint8_t noise_filter{};               //!< Noise filter level
+    float emissivity{1.0f};               //!< Emissivity (0.0 - 1.0, stored in 1/10000)
+    uint64_t start_time{};                //!< Start time (ms since the epoch, 0: unknown)
+    uint16_t sync_interval{};             //!< Subpages between sync points (set by the writer)
+    uint16_t index_entries{};             //!< Sync points per index chunk (set by the writer)
+    bool compressed{};                    //!< Are the subpages compressed? (set by the writer)
+};
+
+/*!
+  @struct RecordingIndexEntry
+  @brief Sync point
+ */
+struct RecordingIndexEntry {
+    uint32_t timestamp{};  //!< Timestamp (ms)
+    uint32_t offset{};     //!< Offset of the subpage chunk
+};
+
+/*!
+  @struct RecordedSubpage
+  @brief Subpage read from the recording
+ */
+struct RecordedSubpage {
+    uint32_t offset{};               //!< Offset of the chunk
+    uint32_t timestamp{};            //!< Timestamp (ms)
+    uint8_t subpage{};               //!< Subpage 0:even 1:odd
+    uint8_t flags{};                 //!< Flags
+    uint16_t temp[8]{};              //!< Temperature information (raw)
+    uint16_t raw[subpage_pixels]{};  //!< Raw pixel data of the subpage
+
+    //! @brief Was the subpage torn?
+    inline bool torn() const
+    {
+        return flags & recording_flag_torn;
+    }
+    //! @brief Is it a sync point?
+    inline bool sync() const
+    {
+        return flags & recording_flag_sync;
+    }
+};
+
+class RecordingReader;
+
+/*!
+  @class RecordingWriter
+  @brief Make the chunks of a recording
+  @details Write each output to the end of the file at once and flush it if the recording must survive
+  a power loss. The writer keeps the offset by the sizes it returned
+  @code
+  uint8_t buf[recording_max_write_size];
+  file.write(buf, writer.begin(buf, header));
+  while (unit.available()) {
+      auto& d = unit.oldest();
+      file.write(buf, writer.write(buf, d.raw, d.subpage, d.temp, millis() - started, d.torn));
+      unit.discard();
+  }
+  file.write(buf, writer.finish(buf));
+  @endcode
+ */
+class RecordingWriter {
+public:
+    /*!
+      @struct config_t
+      @brief Writer settings
+     */
+    struct config_t {
+        //! Compress the subpages?
+        bool compress{true};
+        //! Subpages between sync points (1 -)
+        uint16_t sync_interval{16};
+        //! Sync points per index chunk (1 - 64)
+        uint16_t index_entries{32};
+    };
+
+    RecordingWriter() = default;
+    explicit RecordingWriter(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    /*!
+      @brief Set the configration
+      @note Applied at the next begin()
+     */
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Start a new recording
+      @param[out] out Header chunk (recording_header_size)
+      @param header Settings of the recording
+      @return Bytes written
+     */
+    size_t begin(uint8_t* out, const RecordingHeader& header);
+    /*!
+      @brief Continue the recording after the last valid chunk
+      @param reader Reader of the recording
+      @return True if successful
+      @note Truncate the file to RecordingReader::end() before writing. The settings are taken from the header
+     */
+    bool resume(const RecordingReader& reader);
+
+    /*!
+      @brief Add the subpage
+      @param[out] out Chunks (recording_max_write_size)
+      @param raw Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+      @param temp Temperature information (8), nullptr writes zeros
+      @param timestamp Timestamp (ms), not decreasing
+      @param torn Was the subpage torn?
+      @return Bytes written, 0 if not begun
+     */
+    size_t write(uint8_t* out, const uint16_t* raw, const uint8_t subpage, const uint16_t* temp,
+                 const uint32_t timestamp, const bool torn = false);
+    /*!
+      @brief Index the sync points not yet indexed
+      @param[out] out Index chunk (recording_max_write_size)
+      @return Bytes written
+     */
+    size_t finish(uint8_t* out);
+    /*!
+      @brief Forget the chunks of the last write(), the file did not take them
+      @details The offset goes back to where they started and the next subpage is a sync point,
+      so that the recording decodes without the subpage lost
+      @note Write the next chunks where the refused ones started
+     */
+    void discard();
+
+    //! @brief Bytes of the recording so far
+    inline uint32_t offset() const
+    {
+        return _offset;
+    }
+
+protected:
+    size_t write_index(uint8_t* out);
+    static DeltaEncoder::config_t codec_config();
+
+private:
+    config_t _cfg{};
+    DeltaEncoder _codec{codec_config()};
+    std::vector<RecordingIndexEntry> _entries{};
+    // Before the last write(), for discard()
+    std::vector<RecordingIndexEntry> _indexed{};
+    uint32_t _undo_offset{}, _undo_last_index{};
+    size_t _undo_entries{};
+    bool _undo_index{};
+
+    uint32_t _offset{}, _last_index{};
+    uint16_t _since_sync{};
+    bool _compress{}, _begun{};
+};
+
+/*!
+  @class RecordingReader
+  @brief Read a recording in memory, such as a memory-mapped file
+  @details Opening reads the header, follows the index chunks back from the last one
+  and scans the subpages after it, so that seeking is a binary search of the sync points
+ */
+class RecordingReader {
+public:
+    /*!
+      @brief Open the recording
+      @param data Bytes of the recording, kept until closed
+      @param size Size
+      @return True if the header is valid
+     */
+    bool open(const uint8_t* data, const size_t size);
+    //! @brief Forget the recording
+    void close();
+
+    //! @brief Settings of the recording
+    inline const RecordingHeader& header() const
+    {
+        return _header;
+    }
+    //! @brief Sync points
+    inline const std::vector<RecordingIndexEntry>& index() const
+    {
+        return _index;
+    }
+    //! @brief Offset after the last valid chunk, where a writer continues
+    inline uint32_t end() const
+    {
+        return _end;
+    }
+
+    /*!
+      @brief Move to the last sync point at or before the time
+      @param timestamp Timestamp (ms)
+      @return True if there is a sync point
+      @note next() returns the subpages from the sync point, up to sync_interval of them before the time
+     */
+    bool seek(const uint32_t timestamp);
+    //! @brief Move to the first subpage
+    void rewind();
+    /*!
+      @brief Read the next subpage
+      @param[out] out Subpage
+      @return True if read, false at the end
+     */
+    bool next(RecordedSubpage& out);
+
+protected:
+    friend class RecordingWriter;
+    // Chunk at the offset, the payload length or -1 if not valid
+    int32_t chunk(const uint32_t offset, uint16_t& type) const;
+
+private:
+    const uint8_t* _data{};
+    uint32_t _size{}, _end{}, _cursor{}, _first{}, _last_index{};
+    uint32_t _indexed{};  // Entries of _index in index chunks
+    RecordingHeader _header{};
+    std::vector<RecordingIndexEntry> _index{};
+    DeltaDecoder _codec{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
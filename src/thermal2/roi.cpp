@@ -0,0 +1,177 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file roi.cpp
+  @brief Region of interest statistics for Thermal2 frames
+*/
+#include "roi.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// floor(log2(v)) for 1 - 32
+inline uint8_t log2_floor(const uint8_t v)
+{
+    return 31 - __builtin_clz(v);
+}
+
+}  // namespace
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+// ----------------------------------------------------------------------------
+// IntegralImage
+void IntegralImage::build(const uint16_t* frame)
+{
+    // Summed-area tables (the first row and column stay 0)
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        uint32_t rs{};
+        uint64_t rs2{};
+        const uint16_t* src = frame + y * frame_width;
+        uint32_t* s         = _sum + (y + 1) * stride + 1;
+        uint64_t* s2        = _sum2 + (y + 1) * stride + 1;
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            rs += src[x];
+            rs2 += (uint64_t)src[x] * src[x];
+            s[x]  = s[x - stride] + rs;
+            s2[x] = s2[x - stride] + rs2;
+        }
+    }
+
+    // Row sparse tables
+    std::memcpy(_lowest[0], frame, sizeof(_lowest[0]));
+    std::memcpy(_highest[0], frame, sizeof(_highest[0]));
+    for (uint_fast8_t k = 1; k < levels; ++k) {
+        const uint_fast8_t half = 1U << (k - 1);
+        for (uint_fast8_t y = 0; y < frame_height; ++y) {
+            const uint_fast16_t row = y * frame_width;
+            for (uint_fast8_t x = 0; x + (half << 1) <= frame_width; ++x) {
+                _lowest[k][row + x]  = std::min(_lowest[k - 1][row + x], _lowest[k - 1][row + x + half]);
+                _highest[k][row + x] = std::max(_highest[k - 1][row + x], _highest[k - 1][row + x + half]);
+            }
+        }
+    }
+}
+
+uint32_t IntegralImage::sum(const Rect& r) const
+{
+    const uint_fast16_t a = r.y * stride + r.x;
+    const uint_fast16_t b = (r.y + r.h) * stride + r.x;
+    return _sum[b + r.w] - _sum[b] - _sum[a + r.w] + _sum[a];
+}
+
+uint64_t IntegralImage::sum2(const Rect& r) const
+{
+    const uint_fast16_t a = r.y * stride + r.x;
+    const uint_fast16_t b = (r.y + r.h) * stride + r.x;
+    return _sum2[b + r.w] - _sum2[b] - _sum2[a + r.w] + _sum2[a];
+}
+
+uint16_t IntegralImage::lowest(const Rect& r) const
+{
+    const uint8_t k   = log2_floor(r.w);
+    const uint8_t x1  = r.x + r.w - (1U << k);
+    const uint16_t* t = _lowest[k];
+    uint16_t v{0xFFFF};
+    for (uint_fast8_t y = r.y; y < r.y + r.h; ++y) {
+        v = std::min(v, std::min(t[y * frame_width + r.x], t[y * frame_width + x1]));
+    }
+    return v;
+}
+
+uint16_t IntegralImage::highest(const Rect& r) const
+{
+    const uint8_t k   = log2_floor(r.w);
+    const uint8_t x1  = r.x + r.w - (1U << k);
+    const uint16_t* t = _highest[k];
+    uint16_t v{};
+    for (uint_fast8_t y = r.y; y < r.y + r.h; ++y) {
+        v = std::max(v, std::max(t[y * frame_width + r.x], t[y * frame_width + x1]));
+    }
+    return v;
+}
+
+RoiStatistics IntegralImage::statistics(const Rect& r) const
+{
+    RoiStatistics s{};
+    s.sum     = sum(r);
+    s.sum2    = sum2(r);
+    s.count   = r.area();
+    s.lowest  = lowest(r);
+    s.highest = highest(r);
+    return s;
+}
+
+// ----------------------------------------------------------------------------
+// RoiEngine
+bool RoiEngine::begin()
+{
+    if (!_image) {
+        _image.reset(new (std::nothrow) IntegralImage());
+    }
+    if (!_frame) {
+        _frame.reset(new (std::nothrow) Frame());
+    }
+    return _image && _frame;
+}
+
+bool RoiEngine::add(const char* name, const Rect& rect)
+{
+    if (!name || !rect.valid() || find(name)) {
+        return false;
+    }
+    Roi roi{};
+    roi.name = name;
+    roi.rect = rect;
+    _rois.push_back(roi);
+    return true;
+}
+
+bool RoiEngine::remove(const char* name)
+{
+    auto it = std::find_if(_rois.begin(), _rois.end(), [&name](const Roi& r) { return name && r.name == name; });
+    if (it == _rois.end()) {
+        return false;
+    }
+    _rois.erase(it);
+    return true;
+}
+
+const RoiEngine::Roi* RoiEngine::find(const char* name) const
+{
+    auto it = std::find_if(_rois.begin(), _rois.end(), [&name](const Roi& r) { return name && r.name == name; });
+    return (it != _rois.end()) ? &*it : nullptr;
+}
+
+bool RoiEngine::process(const uint16_t* frame)
+{
+    if (!begin()) {
+        return false;
+    }
+    _image->build(frame);
+    for (auto&& roi : _rois) {
+        roi.stats = _image->statistics(roi.rect);
+    }
+    ++_sequence;
+    return true;
+}
+
+bool RoiEngine::merge(const uint16_t* src, const uint8_t subpage)
+{
+    if (!begin()) {
+        return false;
+    }
+    _frame->merge(src, subpage);
+    return _frame->complete() && process(_frame->raw);
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
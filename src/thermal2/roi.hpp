@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file roi.hpp
+  @brief Region of interest statistics for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_ROI_HPP
+#define M5_UNIT_THERMO_THERMAL2_ROI_HPP
+
+#include "frame.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @struct Rect
+  @brief Rectangle on the frame (pixels)
+ */
+struct Rect {
+    uint8_t x{}, y{};  //!< Top-left
+    uint8_t w{}, h{};  //!< Size
+
+    //! @brief Does the rectangle lie on the frame and have an area?
+    inline bool valid() const
+    {
+        return w && h && x + w <= frame_width && y + h <= frame_height;
+    }
+    //! @brief Number of pixels
+    inline uint16_t area() const
+    {
+        return (uint16_t)w * h;
+    }
+};
+
+/*!
+  @struct RoiStatistics
+  @brief Statistics of a rectangle (raw values)
+ */
+struct RoiStatistics {
+    uint32_t sum{};      //!< Sum of the values
+    uint64_t sum2{};     //!< Sum of the squared values
+    uint16_t count{};    //!< Number of pixels
+    uint16_t lowest{};   //!< Lowest
+    uint16_t highest{};  //!< Highest
+
+    //! @brief Mean (raw)
+    inline float mean() const
+    {
+        return count ? (float)sum / count : 0.0f;
+    }
+    //! @brief Population variance (raw^2)
+    inline float variance() const
+    {
+        if (!count) {
+            return 0.0f;
+        }
+        const double m = (double)sum / count;
+        const double v = (double)sum2 / count - m * m;
+        return v > 0.0 ? (float)v : 0.0f;
+    }
+};
+
+/*!
+  @class IntegralImage
+  @brief Summed-area tables and row sparse tables of a frame
+  @details After build(), the sum and the sum of squares of any rectangle are O(1),
+  lowest and highest are O(height) with the per-row sparse tables
+  @warning Uses about 28KiB. Do not declare it as a local variable, the stack of an Arduino task is 8KiB.
+  Allocate it on the heap or make it static. RoiEngine allocates its tables on the heap
+ */
+class IntegralImage {
+public:
+    /*!
+      @brief Build the tables
+      @param frame Raw pixel data (768)
+     */
+    void build(const uint16_t* frame);
+    //! @brief Build the tables
+    inline void build(const Frame& frame)
+    {
+        build(frame.raw);
+    }
+
+    ///@name Queries
+    ///@warning The rectangle must be valid
+    ///@{
+    //! @brief Sum of the values in the rectangle
+    uint32_t sum(const Rect& r) const;
+    //! @brief Sum of the squared values in the rectangle
+    uint64_t sum2(const Rect& r) const;
+    //! @brief Lowest value in the rectangle
+    uint16_t lowest(const Rect& r) const;
+    //! @brief Highest value in the rectangle
+    uint16_t highest(const Rect& r) const;
+    //! @brief All statistics of the rectangle
+    RoiStatistics statistics(const Rect& r) const;
+    ///@}
+
+    static constexpr uint8_t levels{6};  // log2(frame_width) + 1
+
+private:
+    static constexpr uint16_t stride{frame_width + 1};
+    uint32_t _sum[stride * (frame_height + 1)]{};
+    uint64_t _sum2[stride * (frame_height + 1)]{};
+    // [k][y * frame_width + x] is the lowest/highest of x ... x + 2^k - 1 on the row y
+    uint16_t _lowest[levels][frame_pixels]{};
+    uint16_t _highest[levels][frame_pixels]{};
+};
+
+/*!
+  @class RoiEngine
+  @brief Statistics of many named regions per frame
+  @details The tables are built once per frame, so the cost per region stays constant.
+  They are allocated on the heap by begin(), so the engine itself is small enough for the stack.
+  Subpages can be fed as they arrive by merge(), which assembles the frame and processes it
+ */
+class RoiEngine {
+public:
+    /*!
+      @struct Roi
+      @brief Named region and its latest statistics
+     */
+    struct Roi {
+        std::string name{};
+        Rect rect{};
+        RoiStatistics stats{};
+    };
+
+    /*!
+      @brief Allocate the tables
+      @return True if successful
+      @note About 30KiB on the heap. process() and merge() call it if not called yet
+     */
+    bool begin();
+    //! @brief Are the tables allocated?
+    inline bool isBegun() const
+    {
+        return _image != nullptr;
+    }
+
+    ///@name Regions
+    ///@{
+    /*!
+      @brief Add a region
+      @param name Unique name
+      @param rect Rectangle
+      @return True if successful. False if the rectangle is invalid or the name is already used
+     */
+    bool add(const char* name, const Rect& rect);
+    //! @brief Remove the region
+    bool remove(const char* name);
+    //! @brief Remove all regions
+    inline void clear()
+    {
+        _rois.clear();
+    }
+    //! @brief Find the region, nullptr if not found
+    const Roi* find(const char* name) const;
+    //! @brief All regions in the order added
+    inline const std::vector<Roi>& rois() const
+    {
+        return _rois;
+    }
+    ///@}
+
+    /*!
+      @brief Compute the statistics of all regions for the frame
+      @param frame Raw pixel data (768)
+      @return True if successful, false if the tables could not be allocated
+     */
+    bool process(const uint16_t* frame);
+    //! @brief Compute the statistics of all regions for the frame
+    inline bool process(const Frame& frame)
+    {
+        return process(frame.raw);
+    }
+    /*!
+      @brief Merge the subpage into the assembled frame and compute the statistics
+      @param src Raw pixel data of the subpage (384)
+      @param subpage Subpage 0 or 1
+      @return True if the statistics were computed. False until both subpages have been merged
+      @details Once assembled, each subpage yields a frame of the latest two subpages
+     */
+    bool merge(const uint16_t* src, const uint8_t subpage);
+    //! @brief Discard the assembled frame, the next frame is assembled from scratch
+    inline void reset()
+    {
+        if (_frame) {
+            _frame->merged = 0;
+        }
+    }
+    //! @brief The assembled frame, nullptr if not begun
+    inline const Frame* frame() const
+    {
+        return _frame.get();
+    }
+    //! @brief Frames processed, to tell which frame the statistics belong to
+    inline uint32_t sequence() const
+    {
+        return _sequence;
+    }
+    //! @brief The tables of the latest frame, nullptr if not begun
+    inline const IntegralImage* image() const
+    {
+        return _image.get();
+    }
+
+private:
+    std::unique_ptr<IntegralImage> _image{};
+    std::unique_ptr<Frame> _frame{};  // Assembled by merge()
+    std::vector<Roi> _rois{};
+    uint32_t _sequence{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
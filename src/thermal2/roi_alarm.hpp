@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file roi_alarm.hpp
+  @brief Alarms of the regions of interest
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_ROI_ALARM_HPP
+#define M5_UNIT_THERMO_THERMAL2_ROI_ALARM_HPP
+
+#include "roi.hpp"
+#include "../utility/alarm.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @brief Evaluate the highest temperature of each region on the channel of the same number
+  @param alarms Alarms, a channel added for each region in the order of RoiEngine::rois()
+  @param engine Regions processed for the frame
+  @param time Time of the frame (ms)
+  @param on_event Functor void(const thermo::AlarmEvent&, const RoiEngine::Roi&) called when an alarm changes
+  @code
+  roi.process(frame);
+  push_roi_alarms(alarms, roi, millis(), [](const thermo::AlarmEvent& e, const RoiEngine::Roi& r) {
+      M5_LOGW("%s %s", r.name.c_str(), e.raised ? "raised" : "cleared");
+  });
+  @endcode
+ */
+template <typename F>
+inline void push_roi_alarms(thermo::AlarmEngine& alarms, const RoiEngine& engine, const uint32_t time, F&& on_event)
+{
+    const auto& rois = engine.rois();
+    for (size_t i = 0; i < rois.size() && i < alarms.channels(); ++i) {
+        if (alarms.push((uint8_t)i, time, raw_to_celsius(rois[i].stats.highest))) {
+            on_event(alarms.event(), rois[i]);
+        }
+    }
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,202 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file spatial_filter.cpp
+  @brief Spatial denoise filters for Thermal2 frames
+*/
+#include "spatial_filter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+using namespace m5::unit::thermal2;
+
+// Copy the row with R pixels replicated on both sides
+template <uint_fast8_t R>
+inline void load_row(uint16_t* dst, const uint16_t* src)
+{
+    for (uint_fast8_t i = 0; i < R; ++i) {
+        dst[i]                   = src[0];
+        dst[frame_width + R + i] = src[frame_width - 1];
+    }
+    std::memcpy(dst + R, src, frame_width * sizeof(uint16_t));
+}
+
+inline const uint16_t* clamped_row(const uint16_t* frame, const int_fast8_t y)
+{
+    return frame + (y < 0 ? 0 : y >= frame_height ? frame_height - 1 : y) * frame_width;
+}
+
+inline void sort2(uint16_t& a, uint16_t& b)
+{
+    const uint16_t lo = std::min(a, b);
+    b                 = std::max(a, b);
+    a                 = lo;
+}
+
+inline uint16_t min3(const uint16_t a, const uint16_t b, const uint16_t c)
+{
+    return std::min(std::min(a, b), c);
+}
+
+inline uint16_t max3(const uint16_t a, const uint16_t b, const uint16_t c)
+{
+    return std::max(std::max(a, b), c);
+}
+
+inline uint16_t med3(const uint16_t a, const uint16_t b, const uint16_t c)
+{
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// Separable binomial filter with radius R, rows are kept in a ring so the frame can be overwritten
+template <uint_fast8_t R>
+void binomial(uint16_t* frame)
+{
+    constexpr uint_fast8_t taps{2 * R + 1};
+    constexpr uint_fast8_t padded{frame_width + 2 * R};
+    constexpr uint32_t k[2][5] = {{1, 2, 1}, {1, 4, 6, 4, 1}};
+    constexpr uint_fast8_t shift{4 * R};  // Both passes
+    const uint32_t* kk = k[R - 1];
+
+    uint16_t rows[taps][padded];
+    for (int_fast8_t i = 0; i < (int_fast8_t)taps - 1; ++i) {
+        load_row<R>(rows[i], clamped_row(frame, i - R));
+    }
+
+    uint32_t v[padded];
+    for (int_fast8_t y = 0; y < frame_height; ++y) {
+        // rows[(y + i) % taps] holds row y - R + i
+        load_row<R>(rows[(y + taps - 1) % taps], clamped_row(frame, y + R));
+        std::fill(std::begin(v), std::end(v), 0);
+        for (uint_fast8_t i = 0; i < taps; ++i) {
+            const uint16_t* r = rows[(y + i) % taps];
+            for (uint_fast8_t x = 0; x < padded; ++x) {
+                v[x] += kk[i] * r[x];
+            }
+        }
+        uint16_t* out = frame + y * frame_width;
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            uint32_t s{};
+            for (uint_fast8_t i = 0; i < taps; ++i) {
+                s += kk[i] * v[x + i];
+            }
+            out[x] = (uint16_t)((s + (1U << (shift - 1))) >> shift);
+        }
+    }
+}
+
+}  // namespace
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+void median3x3(uint16_t* frame)
+{
+    constexpr uint_fast8_t padded{frame_width + 2};
+    uint16_t rows[3][padded];
+    uint16_t* r0 = rows[0];
+    uint16_t* r1 = rows[1];
+    uint16_t* r2 = rows[2];
+    load_row<1>(r0, frame);
+    load_row<1>(r1, frame);
+
+    uint16_t lo[padded], mid[padded], hi[padded];
+    for (int_fast8_t y = 0; y < frame_height; ++y) {
+        load_row<1>(r2, clamped_row(frame, y + 1));
+        // Sort each column once
+        for (uint_fast8_t x = 0; x < padded; ++x) {
+            uint16_t a = r0[x], b = r1[x], c = r2[x];
+            sort2(a, b);
+            sort2(b, c);
+            sort2(a, b);
+            lo[x]  = a;
+            mid[x] = b;
+            hi[x]  = c;
+        }
+        // Median of 9 = median of (max of lows, median of mids, min of highs)
+        uint16_t* out = frame + y * frame_width;
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            out[x] = med3(max3(lo[x], lo[x + 1], lo[x + 2]), med3(mid[x], mid[x + 1], mid[x + 2]),
+                          min3(hi[x], hi[x + 1], hi[x + 2]));
+        }
+        uint16_t* t = r0;
+        r0          = r1;
+        r1          = r2;
+        r2          = t;
+    }
+}
+
+void gaussian3x3(uint16_t* frame)
+{
+    binomial<1>(frame);
+}
+
+void gaussian5x5(uint16_t* frame)
+{
+    binomial<2>(frame);
+}
+
+// ----------------------------------------------------------------------------
+// BilateralFilter
+void BilateralFilter::config(const config_t& cfg)
+{
+    _cfg       = cfg;
+    _cfg.sigma = cfg.sigma ? cfg.sigma : 1;
+
+    // The table covers 3 sigma
+    const uint32_t range = 3U * _cfg.sigma;
+    _shift               = 0;
+    while (((uint32_t)lut_size << _shift) < range) {
+        ++_shift;
+    }
+    const double s2 = 2.0 * _cfg.sigma * _cfg.sigma;
+    for (uint_fast8_t i = 0; i < lut_size; ++i) {
+        const double d = i << _shift;
+        _lut[i]        = (uint16_t)std::lround(256.0 * std::exp(-d * d / s2));
+    }
+}
+
+void BilateralFilter::apply(uint16_t* frame) const
+{
+    constexpr uint_fast8_t padded{frame_width + 2};
+    constexpr uint32_t ws[3][3] = {{1, 2, 1}, {2, 4, 2}, {1, 2, 1}};
+    uint16_t rows[3][padded];
+    uint16_t* r[3] = {rows[0], rows[1], rows[2]};
+    load_row<1>(r[0], frame);
+    load_row<1>(r[1], frame);
+
+    for (int_fast8_t y = 0; y < frame_height; ++y) {
+        load_row<1>(r[2], clamped_row(frame, y + 1));
+        uint16_t* out = frame + y * frame_width;
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            const uint16_t c = r[1][x + 1];
+            uint32_t sum{}, wsum{};
+            for (uint_fast8_t j = 0; j < 3; ++j) {
+                for (uint_fast8_t i = 0; i < 3; ++i) {
+                    const uint16_t v = r[j][x + i];
+                    const uint32_t w = ws[j][i] * weight(v > c ? v - c : c - v);
+                    sum += w * v;
+                    wsum += w;
+                }
+            }
+            // wsum is never 0, the center weighs 4 * 256
+            out[x] = (uint16_t)((sum + (wsum >> 1)) / wsum);
+        }
+        uint16_t* t = r[0];
+        r[0]        = r[1];
+        r[1]        = r[2];
+        r[2]        = t;
+    }
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file spatial_filter.hpp
+  @brief Spatial denoise filters for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_SPATIAL_FILTER_HPP
+#define M5_UNIT_THERMO_THERMAL2_SPATIAL_FILTER_HPP
+
+#include "frame.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @brief 3x3 median filter in place
+  @param frame Raw pixel data (768)
+  @details Each column triple is sorted once and shared by the three windows that contain it,
+  then the median is taken from the sorted columns with min/max only (no branches)
+  @note Edge pixels are replicated
+ */
+void median3x3(uint16_t* frame);
+//! @brief 3x3 median filter in place
+inline void median3x3(Frame& frame)
+{
+    median3x3(frame.raw);
+}
+
+/*!
+  @brief 3x3 Gaussian filter in place (separable, [1 2 1] / 4)
+  @param frame Raw pixel data (768)
+  @note Edge pixels are replicated
+ */
+void gaussian3x3(uint16_t* frame);
+//! @brief 3x3 Gaussian filter in place
+inline void gaussian3x3(Frame& frame)
+{
+    gaussian3x3(frame.raw);
+}
+
+/*!
+  @brief 5x5 Gaussian filter in place (separable, [1 4 6 4 1] / 16)
+  @param frame Raw pixel data (768)
+  @note Edge pixels are replicated
+ */
+void gaussian5x5(uint16_t* frame);
+//! @brief 5x5 Gaussian filter in place
+inline void gaussian5x5(Frame& frame)
+{
+    gaussian5x5(frame.raw);
+}
+
+/*!
+  @class BilateralFilter
+  @brief Edge preserving 3x3 bilateral filter in integer arithmetic
+  @details The spatial weights are the 3x3 Gaussian (1, 2, 4).
+  The range weights are taken from a table built on config(), in Q8
+ */
+class BilateralFilter {
+public:
+    /*!
+      @struct config_t
+      @brief Filter settings
+     */
+    struct config_t {
+        //! Range sigma (raw, 128: 1 celsius)
+        uint16_t sigma{128};
+    };
+
+    BilateralFilter()
+    {
+        config(_cfg);
+    }
+    explicit BilateralFilter(const config_t& cfg)
+    {
+        config(cfg);
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    void config(const config_t& cfg);
+    ///@}
+
+    /*!
+      @brief Filter the frame in place
+      @param frame Raw pixel data (768)
+      @note Edge pixels are replicated
+     */
+    void apply(uint16_t* frame) const;
+    //! @brief Filter the frame in place
+    inline void apply(Frame& frame) const
+    {
+        apply(frame.raw);
+    }
+
+    //! @brief Range weight for the raw difference (Q8)
+    inline uint16_t weight(const uint16_t diff) const
+    {
+        const uint32_t i = diff >> _shift;
+        return i < lut_size ? _lut[i] : 0;
+    }
+
+    static constexpr uint8_t lut_size{64};
+
+private:
+    config_t _cfg{};
+    uint8_t _shift{};
+    uint16_t _lut[lut_size]{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
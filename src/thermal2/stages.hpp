@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file stages.hpp
+  @brief Pipeline stages that encode Thermal2 subpages
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_STAGES_HPP
+#define M5_UNIT_THERMO_THERMAL2_STAGES_HPP
+
+#include "recording.hpp"
+#include "../utility/pipeline.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class StreamStage
+  @brief Encode subpages into stream packets
+  @tparam Clock Functor uint32_t() that returns the timestamp (ms)
+  @details Takes any type with raw, subpage, temp and torn like Data, passes on thermo::Bytes.
+  If a sink refuses a compressed packet the next ones are keyframes, so the receiver recovers at once
+ */
+template <typename Clock>
+class StreamStage {
+public:
+    /*!
+      @param clock Timestamp source
+      @param compress Compress the subpages?
+     */
+    StreamStage(Clock clock, const bool compress) : _clock{std::move(clock)}, _compress{compress}
+    {
+    }
+    template <typename T, typename Next>
+    bool push(const T& d, Next&& next)
+    {
+        const size_t len = _compress ? _encoder.encode(_buf, _codec, d.raw, d.subpage, d.temp, _clock(), d.torn)
+                                     : _encoder.encode(_buf, d.raw, d.subpage, d.temp, _clock(), d.torn);
+        const bool ok = next(thermo::Bytes{_buf, len});
+        if (!ok) {
+            _codec.requestKeyframe();
+        }
+        return ok;
+    }
+
+    //! @brief The encoder
+    inline StreamEncoder& encoder()
+    {
+        return _encoder;
+    }
+    //! @brief The compressor
+    inline DeltaEncoder& codec()
+    {
+        return _codec;
+    }
+
+private:
+    Clock _clock;
+    bool _compress{};
+    StreamEncoder _encoder{};
+    DeltaEncoder _codec{};
+    uint8_t _buf[stream_packet_size]{};
+};
+template <typename Clock>
+inline StreamStage<Clock> stream_stage(Clock clock, const bool compress = true)
+{
+    return StreamStage<Clock>(std::move(clock), compress);
+}
+
+/*!
+  @class RecordingStage
+  @brief Encode subpages into the chunks of a recording
+  @tparam Clock Functor uint32_t() that returns the timestamp (ms)
+  @details The header is passed on before the first subpage, again until a sink takes it.
+  If a sink refuses the chunks of a subpage the writer forgets them and the next subpage is a sync point.
+  Call finish() with the pipeline before closing the file to index the last sync points
+ */
+template <typename Clock>
+class RecordingStage {
+public:
+    /*!
+      @param clock Timestamp source
+      @param header Settings of the recording
+      @param cfg Writer settings
+     */
+    RecordingStage(Clock clock, const RecordingHeader& header, const RecordingWriter::config_t& cfg)
+        : _clock{std::move(clock)}, _header{header}, _writer{cfg}
+    {
+    }
+    template <typename T, typename Next>
+    bool push(const T& d, Next&& next)
+    {
+        if (!_begun) {
+            if (!next(thermo::Bytes{_buf, _writer.begin(_buf, _header)})) {
+                return false;
+            }
+            _begun = true;
+        }
+        if (!next(thermo::Bytes{_buf, _writer.write(_buf, d.raw, d.subpage, d.temp, _clock(), d.torn)})) {
+            _writer.discard();
+            return false;
+        }
+        return true;
+    }
+
+    /*!
+      @brief Write the last index chunk
+      @param sink Sink of the chunk, such as a FileSink
+     */
+    template <typename Sink>
+    bool finish(Sink& sink)
+    {
+        const size_t len = _begun ? _writer.finish(_buf) : 0;
+        return !len || sink.push(thermo::Bytes{_buf, len}, [](const thermo::Bytes&) { return true; });
+    }
+
+    //! @brief The writer
+    inline const RecordingWriter& writer() const
+    {
+        return _writer;
+    }
+
+private:
+    Clock _clock;
+    RecordingHeader _header{};
+    RecordingWriter _writer{};
+    bool _begun{};
+    uint8_t _buf[recording_max_write_size]{};
+};
+template <typename Clock>
+inline RecordingStage<Clock> recording_stage(Clock clock, const RecordingHeader& header = RecordingHeader{},
+                                             const RecordingWriter::config_t& cfg = RecordingWriter::config_t{})
+{
+    return RecordingStage<Clock>(std::move(clock), header, cfg);
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,233 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file stream.cpp
+  @brief Compact binary streaming of Thermal2 subpages
+*/
+#include "stream.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+namespace {
+constexpr uint16_t crc_table[16] = {0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+                                    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+inline uint16_t crc_update(uint16_t crc, const uint8_t b)
+{
+    crc = (crc << 4) ^ crc_table[(crc >> 12) ^ (b >> 4)];
+    return (crc << 4) ^ crc_table[(crc >> 12) ^ (b & 0x0F)];
+}
+
+// COBS encoding byte by byte, the code of a block is written when the block ends
+struct cobs_writer_t {
+    uint8_t* out;
+    size_t pos, code_pos;
+    uint8_t code;
+    uint16_t crc;
+
+    explicit cobs_writer_t(uint8_t* o) : out{o}, pos{2}, code_pos{1}, code{1}, crc{0xFFFF}
+    {
+        out[0] = 0x00;
+    }
+    inline void raw(const uint8_t b)
+    {
+        if (b) {
+            out[pos++] = b;
+            if (++code != 0xFF) {
+                return;
+            }
+        }
+        out[code_pos] = code;
+        code_pos      = pos++;
+        code          = 1;
+    }
+    inline void put(const uint8_t b)
+    {
+        crc = crc_update(crc, b);
+        raw(b);
+    }
+    inline void put16(const uint16_t v)
+    {
+        put(v & 0xFF);
+        put(v >> 8);
+    }
+    size_t finish()
+    {
+        const uint16_t c = crc;
+        raw(c & 0xFF);
+        raw(c >> 8);
+        out[code_pos] = code;
+        out[pos++]    = 0x00;
+        return pos;
+    }
+};
+
+inline uint16_t get16(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+void write_header(cobs_writer_t& w, const uint8_t type, const uint16_t sequence, const uint8_t subpage,
+                  const uint16_t* temp, const uint32_t timestamp, const bool torn)
+{
+    w.put(stream_version);
+    w.put(type);
+    w.put16(sequence);
+    w.put16(timestamp & 0xFFFF);
+    w.put16(timestamp >> 16);
+    w.put(subpage & 1);
+    w.put(torn ? stream_flag_torn : 0);
+    for (uint_fast8_t i = 0; i < 8; ++i) {
+        w.put16(temp ? temp[i] : 0);
+    }
+}
+}  // namespace
+
+uint16_t stream_crc16(const uint8_t* data, const size_t len, uint16_t crc)
+{
+    for (size_t i = 0; i < len; ++i) {
+        crc = crc_update(crc, data[i]);
+    }
+    return crc;
+}
+
+size_t StreamEncoder::encode(uint8_t* out, const uint16_t* raw, const uint8_t subpage, const uint16_t* temp,
+                             const uint32_t timestamp, const bool torn)
+{
+    if (!out || !raw) {
+        return 0;
+    }
+    cobs_writer_t w(out);
+    write_header(w, stream_type_subpage, _sequence++, subpage, temp, timestamp, torn);
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        w.put16(raw[i]);
+    }
+    return w.finish();
+}
+
+size_t StreamEncoder::encode(uint8_t* out, DeltaEncoder& codec, const uint16_t* raw, const uint8_t subpage,
+                             const uint16_t* temp, const uint32_t timestamp, const bool torn)
+{
+    uint8_t block[codec_max_block_size];
+    const size_t len = codec.encode(block, raw, subpage);
+    if (!out || !len) {
+        return 0;
+    }
+    cobs_writer_t w(out);
+    write_header(w, stream_type_compressed, _sequence++, subpage, temp, timestamp, torn);
+    for (size_t i = 0; i < len; ++i) {
+        w.put(block[i]);
+    }
+    return w.finish();
+}
+
+bool StreamDecoder::push(const uint8_t b)
+{
+    if (b) {
+        if (_len < sizeof(_buf)) {
+            _buf[_len++] = b;
+        } else {
+            _overflow = true;
+        }
+        return false;
+    }
+
+    // Delimiter
+    bool decoded{};
+    if (_len || _overflow) {
+        // The bytes before the first delimiter may be the tail of a packet
+        if (_synced) {
+            decoded = !_overflow && decode();
+            _stats.framing += _overflow;
+        }
+    }
+    _synced   = true;
+    _len      = 0;
+    _overflow = false;
+    return decoded;
+}
+
+void StreamDecoder::reset()
+{
+    _len       = 0;
+    _overflow  = false;
+    _synced    = false;
+    _sequenced = false;
+    _packet    = StreamPacket{};
+    _stats     = stats_t{};
+    _codec.invalidate();
+}
+
+bool StreamDecoder::decode()
+{
+    // COBS in place, the decoded bytes are never ahead of the encoded ones
+    uint16_t rd{}, wr{};
+    while (rd < _len) {
+        const uint8_t code = _buf[rd++];
+        if (rd + code - 1 > _len) {
+            ++_stats.framing;
+            return false;
+        }
+        for (uint_fast8_t i = 1; i < code; ++i) {
+            _buf[wr++] = _buf[rd++];
+        }
+        if (code != 0xFF && rd < _len) {
+            _buf[wr++] = 0x00;
+        }
+    }
+    const uint8_t type = _buf[1];
+    if (_buf[0] != stream_version ||
+        !((type == stream_type_subpage && wr == stream_payload_size) || (type == stream_type_compressed && wr > 28))) {
+        ++_stats.framing;
+        return false;
+    }
+    if (stream_crc16(_buf, wr - 2) != get16(_buf + wr - 2)) {
+        ++_stats.crc;
+        return false;
+    }
+
+    // Compressed subpages after the lost ones can not be decoded until the next keyframes
+    // A packet behind the expected one is not a gap, the sequence restarts from it
+    const uint16_t seq = get16(_buf + 2);
+    if (_sequenced && seq != _sequence) {
+        const uint16_t gap = seq - _sequence;
+        if (gap < 0x8000) {
+            _stats.dropped += gap;
+        } else {
+            ++_stats.resync;
+        }
+        _codec.invalidate();
+    }
+    _sequence  = seq + 1;
+    _sequenced = true;
+
+    if (type == stream_type_compressed) {
+        uint8_t sp{};
+        if (_codec.decode(_buf + 26, wr - 28, _packet.raw, sp) != wr - 28u) {
+            ++_stats.unsynced;
+            return false;
+        }
+    } else {
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            _packet.raw[i] = get16(_buf + 26 + i * 2);
+        }
+    }
+    ++_stats.packets;
+    _packet.sequence  = seq;
+    _packet.timestamp = get16(_buf + 4) | ((uint32_t)get16(_buf + 6) << 16);
+    _packet.subpage   = _buf[8];
+    _packet.flags     = _buf[9];
+    for (uint_fast8_t i = 0; i < 8; ++i) {
+        _packet.temp[i] = get16(_buf + 10 + i * 2);
+    }
+    return true;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,193 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file stream.hpp
+  @brief Compact binary streaming of Thermal2 subpages
+  @details A packet is COBS encoded between 0x00 delimiters, so that a receiver can join the stream anywhere
+  and text written to the same port only costs the packet it hits.
+  Decoded payload (little endian, 796 bytes for a subpage)
+  |Offset|Size|Content|
+  |---|---|---|
+  |0|1|Version (1)|
+  |1|1|Type (1: subpage, 2: compressed subpage)|
+  |2|2|Sequence number|
+  |4|4|Timestamp (ms)|
+  |8|1|Subpage 0:even 1:odd|
+  |9|1|Flags (bit0: torn)|
+  |10|16|Temperature information (raw, as Data::temp)|
+  |26|768|Raw pixel data of the subpage (384), or a DeltaEncoder block of any size|
+  |794|2|CRC-16/CCITT-FALSE of the bytes before|
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_STREAM_HPP
+#define M5_UNIT_THERMO_THERMAL2_STREAM_HPP
+
+#include "codec.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+///@name Stream format
+///@{
+constexpr uint8_t stream_version{1};
+constexpr uint8_t stream_type_subpage{1};
+constexpr uint8_t stream_type_compressed{2};
+constexpr uint8_t stream_flag_torn{0x01};
+constexpr uint16_t stream_payload_size{26 + subpage_pixels * 2 + 2};
+//! Largest payload, a compressed subpage stored as it is
+constexpr uint16_t stream_max_payload_size{26 + codec_max_block_size + 2};
+//! Largest encoded packet with the COBS overhead and both delimiters
+constexpr uint16_t stream_packet_size{stream_max_payload_size + (stream_max_payload_size + 253) / 254 + 2};
+///@}
+
+/*!
+  @brief CRC-16/CCITT-FALSE
+  @param data Bytes
+  @param len Length
+  @param crc Initial value, or the result of the previous block
+ */
+uint16_t stream_crc16(const uint8_t* data, const size_t len, uint16_t crc = 0xFFFF);
+
+/*!
+  @struct StreamPacket
+  @brief Decoded subpage
+ */
+struct StreamPacket {
+    uint16_t sequence{};             //!< Sequence number
+    uint32_t timestamp{};            //!< Timestamp (ms)
+    uint8_t subpage{};               //!< Subpage 0:even 1:odd
+    uint8_t flags{};                 //!< Flags
+    uint16_t temp[8]{};              //!< Temperature information (raw)
+    uint16_t raw[subpage_pixels]{};  //!< Raw pixel data of the subpage
+
+    //! @brief Was the subpage torn?
+    inline bool torn() const
+    {
+        return flags & stream_flag_torn;
+    }
+};
+
+/*!
+  @class StreamEncoder
+  @brief Encode subpages into packets
+  @details Reads the subpage where it is, such as the Data in the ring buffer of the unit,
+  and writes the encoded bytes in one pass
+  @code
+  uint8_t buf[stream_packet_size];
+  while (unit.available()) {
+      auto& d = unit.oldest();
+      Serial.write(buf, encoder.encode(buf, d.raw, d.subpage, d.temp, millis(), d.torn));
+      unit.discard();
+  }
+  @endcode
+ */
+class StreamEncoder {
+public:
+    /*!
+      @brief Encode the subpage
+      @param[out] out Packet (stream_packet_size)
+      @param raw Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+      @param temp Temperature information (8), nullptr writes zeros
+      @param timestamp Timestamp (ms)
+      @param torn Was the subpage torn?
+      @return Bytes written
+     */
+    size_t encode(uint8_t* out, const uint16_t* raw, const uint8_t subpage, const uint16_t* temp,
+                  const uint32_t timestamp, const bool torn = false);
+    /*!
+      @brief Encode the subpage compressed
+      @param[out] out Packet (stream_packet_size)
+      @param codec Compressor of the stream
+      @param raw Raw pixel data of the subpage (384)
+      @param subpage Subpage 0:even 1:odd
+      @param temp Temperature information (8), nullptr writes zeros
+      @param timestamp Timestamp (ms)
+      @param torn Was the subpage torn?
+      @return Bytes written
+      @note Call DeltaEncoder::requestKeyframe() when a receiver starts listening
+     */
+    size_t encode(uint8_t* out, DeltaEncoder& codec, const uint16_t* raw, const uint8_t subpage,
+                  const uint16_t* temp, const uint32_t timestamp, const bool torn = false);
+
+    //! @brief Sequence number of the next packet
+    inline uint16_t sequence() const
+    {
+        return _sequence;
+    }
+    //! @brief Restart the sequence number
+    inline void reset(const uint16_t sequence = 0)
+    {
+        _sequence = sequence;
+    }
+
+private:
+    uint16_t _sequence{};
+};
+
+/*!
+  @class StreamDecoder
+  @brief Decode packets from the byte stream
+  @note Uses 1.5KiB more for the previous subpages of the compressed packets
+  @code
+  while (Serial.available()) {
+      if (decoder.push(Serial.read())) {
+          frame.merge(decoder.packet().raw, decoder.packet().subpage);
+      }
+  }
+  @endcode
+ */
+class StreamDecoder {
+public:
+    /*!
+      @struct stats_t
+      @brief Counters since reset()
+     */
+    struct stats_t {
+        uint32_t packets{};   //!< Packets decoded
+        uint32_t dropped{};   //!< Packets missing from the sequence
+        uint32_t resync{};    //!< Packets behind the sequence (duplicated, reordered or from a restarted sender)
+        uint32_t crc{};       //!< Packets with a wrong CRC
+        uint32_t framing{};   //!< Byte runs between delimiters that are not packets
+        uint32_t unsynced{};  //!< Compressed packets skipped while waiting for a keyframe
+    };
+
+    /*!
+      @brief Push the received byte
+      @return True if a packet has been decoded
+     */
+    bool push(const uint8_t b);
+
+    //! @brief The packet last decoded
+    inline const StreamPacket& packet() const
+    {
+        return _packet;
+    }
+    //! @brief Counters
+    inline const stats_t& stats() const
+    {
+        return _stats;
+    }
+    //! @brief Forget the partial packet, the sequence and the counters
+    void reset();
+
+protected:
+    bool decode();
+
+private:
+    uint8_t _buf[stream_packet_size]{};
+    uint16_t _len{};
+    bool _overflow{}, _synced{}, _sequenced{};
+    uint16_t _sequence{};  // Expected sequence number
+    DeltaDecoder _codec{};
+    StreamPacket _packet{};
+    stats_t _stats{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
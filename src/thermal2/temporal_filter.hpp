@@ -0,0 +1,204 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file temporal_filter.hpp
+  @brief Per-pixel temporal IIR filter for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_TEMPORAL_FILTER_HPP
+#define M5_UNIT_THERMO_THERMAL2_TEMPORAL_FILTER_HPP
+
+#include "frame.hpp"
+#include <array>
+#include <type_traits>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class TemporalFilterT
+  @brief Per-pixel exponential smoothing in fixed point
+  @tparam FracBits Fraction bits of the state (0: uint16_t state, 1-6: int32_t state)
+  @details s += (x - s) * alpha, for every pixel of the frame.
+  With the motion adaptive mode, alpha rises linearly toward 1 as the pixel departs from its state,
+  so that moving objects are not smeared while static areas are smoothed.
+  Each loop runs over contiguous arrays with one mode, GCC vectorises them at -O3 on the host
+  @note With FracBits 0 the state is rounded to whole raw counts, see TemporalFilter16
+ */
+template <uint8_t FracBits>
+class TemporalFilterT {
+    static_assert(FracBits <= 6, "FracBits must be between 0 and 6");
+
+public:
+    using state_type = typename std::conditional<FracBits == 0, uint16_t, int32_t>::type;
+
+    /*!
+      @struct config_t
+      @brief Filter settings
+     */
+    struct config_t {
+        //! Smoothing factor (Q8, 1 - 256). 256 passes the input through
+        uint16_t alpha{64};
+        //! Raise alpha for pixels in motion?
+        bool motion_adaptive{false};
+        //! Raw delta where alpha starts to rise (64: 0.5 celsius)
+        uint16_t motion_low{64};
+        //! Raw delta where alpha reaches 256 (384: 3 celsius)
+        uint16_t motion_high{384};
+    };
+
+    explicit TemporalFilterT(const config_t& cfg = config_t{})
+    {
+        config(cfg);
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    void config(const config_t& cfg)
+    {
+        _cfg       = cfg;
+        _cfg.alpha = (cfg.alpha < 1) ? 1 : (cfg.alpha > 256) ? 256 : cfg.alpha;
+        _span      = (cfg.motion_high > cfg.motion_low) ? cfg.motion_high - cfg.motion_low : 1;
+        _slope_q8  = ((256 - _cfg.alpha) << 8) / _span;
+    }
+    ///@}
+
+    //! @brief Forget the state. The next input is taken as is
+    inline void reset()
+    {
+        _primed = 0;
+    }
+
+    /*!
+      @brief Filter the whole frame in place
+      @param frame Raw pixel data (768)
+     */
+    void apply(uint16_t* frame)
+    {
+        if (_primed != 0x03) {
+            prime(frame, 0);
+            prime(frame, 1);
+            return;
+        }
+        if (_cfg.motion_adaptive) {
+            for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+                frame[i] = step_adaptive(_state[i], frame[i]);
+            }
+        } else {
+            const int32_t a = _cfg.alpha;
+            for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+                frame[i] = step(_state[i], frame[i], a);
+            }
+        }
+    }
+    //! @brief Filter the whole frame in place
+    inline void apply(Frame& frame)
+    {
+        apply(frame.raw);
+    }
+
+    /*!
+      @brief Filter only the pixels of the subpage in place
+      @param frame Raw pixel data (768)
+      @param subpage Subpage 0:even 1:odd
+      @note Use this when the frame is assembled subpage by subpage so that stale pixels are not filtered twice
+     */
+    void apply(uint16_t* frame, const uint8_t subpage)
+    {
+        const uint8_t sp = subpage & 1;
+        if (!(_primed & (1U << sp))) {
+            prime(frame, sp);
+            return;
+        }
+        if (_cfg.motion_adaptive) {
+            for (uint_fast8_t y = 0; y < frame_height; ++y) {
+                const uint_fast16_t row = y * frame_width;
+                for (uint_fast8_t x = (y & 1) != sp; x < frame_width; x += 2) {
+                    frame[row + x] = step_adaptive(_state[row + x], frame[row + x]);
+                }
+            }
+        } else {
+            const int32_t a = _cfg.alpha;
+            for (uint_fast8_t y = 0; y < frame_height; ++y) {
+                const uint_fast16_t row = y * frame_width;
+                for (uint_fast8_t x = (y & 1) != sp; x < frame_width; x += 2) {
+                    frame[row + x] = step(_state[row + x], frame[row + x], a);
+                }
+            }
+        }
+    }
+    //! @brief Filter only the latest merged subpage of the frame in place
+    inline void apply(Frame& frame, const uint8_t subpage)
+    {
+        apply(frame.raw, subpage);
+    }
+
+    //! @brief Filtered value of the pixel (raw)
+    inline uint16_t value(const uint_fast16_t idx) const
+    {
+        return output(_state[idx]);
+    }
+
+protected:
+    static inline uint16_t output(const state_type s)
+    {
+        return FracBits ? (uint16_t)((s + ((1 << FracBits) >> 1)) >> FracBits) : (uint16_t)s;
+    }
+
+    static inline uint16_t step(state_type& s, const uint16_t in, const int32_t a)
+    {
+        const int32_t x = (int32_t)in << FracBits;
+        const int32_t t = (int32_t)s;
+        s               = (state_type)(t + (((x - t) * a + 128) >> 8));
+        return output(s);
+    }
+
+    inline uint16_t step_adaptive(state_type& s, const uint16_t in) const
+    {
+        const int32_t x = (int32_t)in << FracBits;
+        const int32_t t = (int32_t)s;
+        int32_t d       = ((x > t) ? x - t : t - x) >> FracBits;
+        d               = (d > _cfg.motion_low) ? d - _cfg.motion_low : 0;
+        const int32_t a = (d < _span) ? _cfg.alpha + ((d * _slope_q8) >> 8) : 256;
+        s               = (state_type)(t + (((x - t) * a + 128) >> 8));
+        return output(s);
+    }
+
+    void prime(const uint16_t* frame, const uint8_t sp)
+    {
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            const uint_fast16_t idx = subpage_to_frame_index(sp, i);
+            _state[idx]             = (state_type)((int32_t)frame[idx] << FracBits);
+        }
+        _primed |= 1U << sp;
+    }
+
+private:
+    config_t _cfg{};
+    int32_t _span{}, _slope_q8{};
+    uint8_t _primed{};
+    std::array<state_type, frame_pixels> _state{};
+};
+
+//! @brief Temporal filter with int32_t state (6 fraction bits, 3KiB)
+using TemporalFilter = TemporalFilterT<6>;
+/*!
+  @brief Temporal filter with uint16_t state (1.5KiB)
+  @note The state has no fraction bits, so it cannot move while |x - s| * alpha < 128.
+  The steady state is biased by up to 128 / alpha raw counts (2 with the default alpha 64)
+ */
+using TemporalFilter16 = TemporalFilterT<0>;
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file tile_renderer.cpp
+  @brief Dirty-tile incremental renderer for Thermal2 frames
+*/
+#include "tile_renderer.hpp"
+#include <algorithm>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+namespace {
+// Output edges of the tiles, cell c lies between the source pixels c and c + 1
+template <typename F>
+void make_edges(std::vector<uint16_t>& edges, const uint8_t tiles, const uint8_t cells, const uint8_t last_cell,
+                const uint16_t size, F source)
+{
+    edges.assign(tiles + 1, size);
+    uint_fast16_t o{};
+    for (uint_fast8_t t = 0; t < tiles; ++t) {
+        while (o < size && std::min<uint8_t>(source(o), last_cell) < t * cells) {
+            ++o;
+        }
+        edges[t] = o;
+    }
+}
+}  // namespace
+
+bool TileRenderer::setup(const uint16_t width, const uint16_t height)
+{
+    if (!_upscaler.setup(width, height)) {
+        return false;
+    }
+    _cells   = (_cfg.tile_cells < 1) ? 1 : (_cfg.tile_cells > 8) ? 8 : _cfg.tile_cells;
+    _tiles_x = (frame_width - 1 + _cells - 1) / _cells;
+    _tiles_y = (frame_height - 1 + _cells - 1) / _cells;
+    make_edges(_edge_x, _tiles_x, _cells, frame_width - 2, width,
+               [this](const uint16_t x) { return _upscaler.column(x); });
+    make_edges(_edge_y, _tiles_y, _cells, frame_height - 2, height,
+               [this](const uint16_t y) { return _upscaler.row(y); });
+
+    _max_tile_pixels = 0;
+    for (uint_fast8_t ty = 0; ty < _tiles_y; ++ty) {
+        for (uint_fast8_t tx = 0; tx < _tiles_x; ++tx) {
+            const Tile t     = tile(tx, ty);
+            _max_tile_pixels = std::max<uint32_t>(_max_tile_pixels, (uint32_t)t.w * t.h);
+        }
+    }
+    _dirty.assign(tiles(), 1);
+    _valid = false;
+    return true;
+}
+
+uint16_t TileRenderer::update(const uint16_t* frame, const Agc& agc)
+{
+    if (!tiles()) {
+        return 0;
+    }
+    ++_stats.frames;
+    _upscaler.source(frame, agc);
+
+    // Source pixels whose palette index moved by the threshold or more
+    bool changed[frame_pixels];
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        const uint8_t idx = agc.index(frame[i]);
+        const int d       = (int)idx - _last[i];
+        changed[i]        = !_valid || d >= _cfg.threshold || -d >= _cfg.threshold;
+        // Small drifts stay relative to what was rendered, so that they add up to a redraw
+        if (changed[i]) {
+            _last[i] = idx;
+        }
+    }
+    _valid = true;
+
+    // A tile is drawn from the source pixels on its edges and inside
+    uint16_t cnt{};
+    for (uint_fast8_t ty = 0; ty < _tiles_y; ++ty) {
+        const uint_fast8_t y0 = ty * _cells;
+        const uint_fast8_t y1 = std::min<uint_fast8_t>(y0 + _cells, frame_height - 1);
+        for (uint_fast8_t tx = 0; tx < _tiles_x; ++tx) {
+            const uint_fast8_t x0 = tx * _cells;
+            const uint_fast8_t x1 = std::min<uint_fast8_t>(x0 + _cells, frame_width - 1);
+            uint8_t& dirty        = _dirty[ty * _tiles_x + tx];
+            for (uint_fast8_t y = y0; y <= y1 && !dirty; ++y) {
+                for (uint_fast8_t x = x0; x <= x1; ++x) {
+                    if (changed[y * frame_width + x]) {
+                        dirty = 1;
+                        break;
+                    }
+                }
+            }
+            cnt += dirty;
+        }
+    }
+    return cnt;
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,221 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file tile_renderer.hpp
+  @brief Dirty-tile incremental renderer for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_TILE_RENDERER_HPP
+#define M5_UNIT_THERMO_THERMAL2_TILE_RENDERER_HPP
+
+#include "upscale.hpp"
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class TileRenderer
+  @brief Upscaled output split into tiles, only the tiles whose colours changed are rendered
+  @details A tile covers a block of cells between the source pixels. The palette index of every source pixel
+  is compared with the one last rendered, and a tile is dirty if the index of any of its corner pixels changed
+  by the threshold or more. Changes of the Agc range are caught as well since they change the indexes.
+  Call invalidate() when the palette or the screen behind the output changes
+ */
+class TileRenderer {
+public:
+    /*!
+      @struct config_t
+      @brief Renderer settings
+     */
+    struct config_t {
+        //! Tile size in source cells (1 - 8). 4 splits the output into 8 x 6 tiles
+        uint8_t tile_cells{4};
+        //! Palette index change of a source pixel that makes its tiles dirty (1: any change)
+        uint8_t threshold{1};
+    };
+
+    /*!
+      @struct Tile
+      @brief Rectangle of the output
+     */
+    struct Tile {
+        uint16_t x{}, y{};  //!< Top-left
+        uint16_t w{}, h{};  //!< Size
+    };
+
+    /*!
+      @struct stats_t
+      @brief Counters since resetStats()
+     */
+    struct stats_t {
+        uint32_t frames{};   //!< Frames updated
+        uint32_t drawn{};    //!< Tiles rendered
+        uint32_t skipped{};  //!< Tiles left as they were
+    };
+
+    TileRenderer() = default;
+    explicit TileRenderer(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    /*!
+      @brief Set the configration
+      @note Call setup() again to apply the tile size
+     */
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Set the output size
+      @param width Output width (2 - 4096)
+      @param height Output height (2 - 4096)
+      @return True if successful
+     */
+    bool setup(const uint16_t width, const uint16_t height);
+
+    //! @brief Render every tile at the next render()
+    inline void invalidate()
+    {
+        _valid = false;
+    }
+
+    /*!
+      @brief Find the dirty tiles of the frame
+      @param frame Raw pixel data (768)
+      @param agc Mapping of the raw values
+      @return Number of dirty tiles
+     */
+    uint16_t update(const uint16_t* frame, const Agc& agc);
+    //! @brief Find the dirty tiles of the frame
+    inline uint16_t update(const Frame& frame, const Agc& agc)
+    {
+        return update(frame.raw, agc);
+    }
+
+    /*!
+      @brief Render the dirty tiles
+      @tparam T Output pixel type
+      @tparam F Functor void(const Tile&, const T*) that pushes the rendered tile to the screen
+      @param table Output pixel of each Agc entry (Agc::size())
+      @param buffer Buffer of a tile (maxTilePixels())
+      @param push Called for each rendered tile, the pixels are w x h without padding
+      @return Number of tiles rendered
+      @code
+      if (renderer.update(frame, agc)) {
+          renderer.render(colors, buffer, [](const TileRenderer::Tile& t, const uint16_t* pixels) {
+              display.pushImage(t.x, t.y, t.w, t.h, pixels);
+          });
+      }
+      @endcode
+     */
+    template <typename T, typename F>
+    uint16_t render(const T* table, T* buffer, F&& push)
+    {
+        uint16_t cnt{};
+        for (uint_fast8_t ty = 0; ty < _tiles_y; ++ty) {
+            for (uint_fast8_t tx = 0; tx < _tiles_x; ++tx) {
+                if (!_dirty[ty * _tiles_x + tx]) {
+                    continue;
+                }
+                _dirty[ty * _tiles_x + tx] = 0;
+                const Tile t               = tile(tx, ty);
+                if (!t.w || !t.h) {
+                    continue;  // Output smaller than the frame
+                }
+                _upscaler.renderArea(buffer, table, t.x, t.y, t.w, t.h);
+                push(t, (const T*)buffer);
+                ++cnt;
+            }
+        }
+        _stats.drawn += cnt;
+        _stats.skipped += (uint32_t)tiles() - cnt;
+        return cnt;
+    }
+
+    ///@name Tiles
+    ///@{
+    //! @brief Number of tiles
+    inline uint16_t tiles() const
+    {
+        return (uint16_t)_tiles_x * _tiles_y;
+    }
+    //! @brief Tiles across
+    inline uint8_t tilesX() const
+    {
+        return _tiles_x;
+    }
+    //! @brief Tiles down
+    inline uint8_t tilesY() const
+    {
+        return _tiles_y;
+    }
+    //! @brief Rectangle of the tile
+    inline Tile tile(const uint8_t tx, const uint8_t ty) const
+    {
+        Tile t{};
+        t.x = _edge_x[tx];
+        t.y = _edge_y[ty];
+        t.w = (uint16_t)(_edge_x[tx + 1] - _edge_x[tx]);
+        t.h = (uint16_t)(_edge_y[ty + 1] - _edge_y[ty]);
+        return t;
+    }
+    //! @brief Is the tile dirty?
+    inline bool isDirty(const uint8_t tx, const uint8_t ty) const
+    {
+        return _dirty[ty * _tiles_x + tx];
+    }
+    //! @brief Pixels of the largest tile, the size of the buffer for render()
+    inline uint32_t maxTilePixels() const
+    {
+        return _max_tile_pixels;
+    }
+    ///@}
+
+    ///@name Statistics
+    ///@{
+    inline const stats_t& stats() const
+    {
+        return _stats;
+    }
+    inline void resetStats()
+    {
+        _stats = stats_t{};
+    }
+    ///@}
+
+    //! @brief The upscaler behind
+    inline const Upscaler& upscaler() const
+    {
+        return _upscaler;
+    }
+
+private:
+    config_t _cfg{};
+    Upscaler _upscaler{};
+    uint8_t _cells{}, _tiles_x{}, _tiles_y{};
+    std::vector<uint16_t> _edge_x{}, _edge_y{};  // Output edges of the tiles (tiles + 1)
+    std::vector<uint8_t> _dirty{};
+    uint32_t _max_tile_pixels{};
+    uint8_t _last[frame_pixels]{};  // Palette indexes last rendered
+    bool _valid{};
+    stats_t _stats{};
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file upscale.cpp
+  @brief Fixed-point bilinear upscaler for Thermal2 frames
+*/
+#include "upscale.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+namespace {
+template <typename T>
+void make_taps(std::vector<T>& taps, const uint16_t size, const uint8_t src)
+{
+    // Output 0 and size - 1 are the centres of the first and the last source pixel
+    taps.resize(size);
+    const uint32_t last = size - 1;
+    for (uint_fast16_t i = 0; i < size; ++i) {
+        const uint32_t pos = (i * ((uint32_t)(src - 1) << 8) + (last >> 1)) / last;
+        taps[i].idx        = pos >> 8;
+        taps[i].weight     = pos & 0xFF;
+    }
+}
+}  // namespace
+
+bool Upscaler::setup(const uint16_t width, const uint16_t height)
+{
+    if (width < 2 || height < 2 || width > max_size || height > max_size) {
+        return false;
+    }
+    _width  = width;
+    _height = height;
+    make_taps(_cols, width, frame_width);
+    make_taps(_rows, height, frame_height);
+    return true;
+}
+
+void Upscaler::source(const uint16_t* frame, const Agc& agc)
+{
+    const int32_t lower = agc.lower();
+    const int32_t upper = agc.high();
+    const uint8_t shift = agc.shift();
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        int32_t raw = frame[i];
+        raw         = (raw < lower) ? lower : (raw > upper) ? upper : raw;
+        _pos[i]     = (uint16_t)(((raw - lower) << 4) >> shift);
+    }
+}
+
+void Upscaler::blend_row(uint32_t* line, const uint_fast16_t y) const
+{
+    const tap_t& t     = _rows[y];
+    const uint16_t* p0 = _pos + t.idx * frame_width;
+    if (!t.weight) {
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            line[x] = (uint32_t)p0[x] << 8;
+        }
+    } else {
+        const uint16_t* p1 = p0 + frame_width;
+        const uint32_t w1  = t.weight;
+        const uint32_t w0  = 256 - w1;
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            line[x] = p0[x] * w0 + p1[x] * w1;
+        }
+    }
+    // The last column has no next pixel, its weight is 0
+    line[frame_width] = line[frame_width - 1];
+}
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
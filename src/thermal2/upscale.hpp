@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file upscale.hpp
+  @brief Fixed-point bilinear upscaler for Thermal2 frames
+*/
+#ifndef M5_UNIT_THERMO_THERMAL2_UPSCALE_HPP
+#define M5_UNIT_THERMO_THERMAL2_UPSCALE_HPP
+
+#include "agc.hpp"
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermal2 {
+
+/*!
+  @class Upscaler
+  @brief Bilinear interpolation of the frame to any output size
+  @details The frame is converted to positions in the Agc table once, then every output pixel
+  is interpolated from precomputed row and column weights and looked up in a table of the entries,
+  such as Agc::lut() for palette indexes or a colour table made by Agc::colorize().
+  The corners of the output are the centres of the corner pixels.
+  Rows can be rendered in strips into a small buffer
+  @note Uses about 1.5KiB plus 2 bytes per output row and column
+ */
+class Upscaler {
+public:
+    //! @brief Maximum output width and height
+    static constexpr uint16_t max_size{4096};
+
+    Upscaler() = default;
+    Upscaler(const uint16_t width, const uint16_t height)
+    {
+        setup(width, height);
+    }
+
+    /*!
+      @brief Set the output size and precompute the weights
+      @param width Output width (2 - 4096)
+      @param height Output height (2 - 4096)
+      @return True if successful
+     */
+    bool setup(const uint16_t width, const uint16_t height);
+    //! @brief Output width
+    inline uint16_t width() const
+    {
+        return _width;
+    }
+    //! @brief Output height
+    inline uint16_t height() const
+    {
+        return _height;
+    }
+    //! @brief Source column left of the output column (0 - 31)
+    inline uint8_t column(const uint16_t x) const
+    {
+        return _cols[x].idx;
+    }
+    //! @brief Source row above the output row (0 - 23)
+    inline uint8_t row(const uint16_t y) const
+    {
+        return _rows[y].idx;
+    }
+
+    /*!
+      @brief Set the frame to render
+      @param frame Raw pixel data (768)
+      @param agc Mapping of the raw values
+     */
+    void source(const uint16_t* frame, const Agc& agc);
+    //! @brief Set the frame to render
+    inline void source(const Frame& frame, const Agc& agc)
+    {
+        source(frame.raw, agc);
+    }
+
+    /*!
+      @brief Render the output rows
+      @tparam T Output pixel type
+      @param[out] out Top left of the first row to render
+      @param table Output pixel of each Agc entry (Agc::size())
+      @param y First row
+      @param rows Rows to render, 0 renders to the last row
+      @param stride Pixels between rows of out, 0 is the output width
+      @code
+      // RGB565 of the palette, the whole output at once
+      agc.colorize(colors, palette);
+      upscaler.source(frame, agc);
+      upscaler.render(buffer, colors);
+      // Palette indexes, 16 rows from the row 32
+      upscaler.render(indexes, agc.lut(), 32, 16);
+      @endcode
+     */
+    template <typename T>
+    inline void render(T* out, const T* table, const uint16_t y = 0, const uint16_t rows = 0,
+                       const uint32_t stride = 0) const
+    {
+        renderArea(out, table, 0, y, _width, rows ? rows : _height, stride);
+    }
+
+    /*!
+      @brief Render a rectangle of the output
+      @tparam T Output pixel type
+      @param[out] out Top left of the rectangle
+      @param table Output pixel of each Agc entry (Agc::size())
+      @param x Left
+      @param y Top
+      @param w Width, clipped to the output
+      @param h Height, clipped to the output
+      @param stride Pixels between rows of out, 0 is the width
+     */
+    template <typename T>
+    void renderArea(T* out, const T* table, const uint16_t x, const uint16_t y, uint16_t w, uint16_t h,
+                    uint32_t stride = 0) const
+    {
+        if (x >= _width || y >= _height) {
+            return;
+        }
+        w      = (w > _width - x) ? _width - x : w;
+        h      = (h > _height - y) ? _height - y : h;
+        stride = stride ? stride : w;
+        uint32_t line[frame_width + 1];
+        for (uint_fast16_t r = 0; r < h; ++r) {
+            blend_row(line, y + r);
+            render_line(out + r * stride, table, line, x, w);
+        }
+    }
+
+protected:
+    struct tap_t {
+        uint8_t idx;     // Source pixel
+        uint8_t weight;  // Weight of the next source pixel (Q8)
+    };
+
+    // Vertical pass, positions of the source columns (Q12) for the output row
+    void blend_row(uint32_t* line, const uint_fast16_t y) const;
+
+    // Horizontal pass
+    template <typename T>
+    void render_line(T* dst, const T* table, const uint32_t* line, const uint16_t x, const uint16_t w) const
+    {
+        const tap_t* tap = _cols.data() + x;
+        for (uint_fast16_t i = 0; i < w; ++i, ++tap) {
+            dst[i] = table[(line[tap->idx] * (256 - tap->weight) + line[tap->idx + 1] * tap->weight) >> 20];
+        }
+    }
+
+private:
+    std::vector<tap_t> _cols{}, _rows{};
+    uint16_t _width{}, _height{};
+    uint16_t _pos[frame_pixels]{};  // Positions in the Agc table (Q4)
+};
+
+}  // namespace thermal2
+}  // namespace unit
+}  // namespace m5
+#endif
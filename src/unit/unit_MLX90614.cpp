@@ -205,6 +205,9 @@ bool UnitMLX90614::begin()
         }
     }
 
+    _statistics.config(_cfg.statistics);
+    _publish_filter.config(_cfg.publish);
+
     // Sleep and wakeup
     applySettings();
 
@@ -243,7 +246,14 @@ void UnitMLX90614::update(const bool force)
             _updated = read_measurement(d, _eeprom.config);
             if (_updated) {
                 _latest = at;
-                _data->push_back(d);
+                _statistics.push(d.objectCelsius1());
+                _updated = _publish_filter.publish(at, {d.ambientCelsius(), d.objectCelsius1(), d.objectCelsius2()});
+                if (_updated) {
+                    _data->push_back(d);
+                    if (_on_data.subscribed()) {
+                        _on_data.emit((*_data)[_data->size() - 1]);
+                    }
+                }
             }
         }
     }
@@ -273,6 +283,8 @@ bool UnitMLX90614::start_periodic_measurement()
     _interval = get_interval(c.iir(), c.fir());
     _periodic = true;
     _latest   = 0;
+    _statistics.reset();
+    _publish_filter.reset();
 
     // M5_LIB_LOGW("IIR:%u FIR:%u IT:%u", c.iir(), c.fir(), _interval);
 
@@ -12,6 +12,9 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "../utility/running_statistics.hpp"
+#include "../utility/events.hpp"
+#include "../utility/change_filter.hpp"
 #include <limits>  // NaN
 #include <array>
 
@@ -192,6 +195,10 @@ public:
         mlx90614::IRSensor irs{mlx90614::IRSensor::Single};
         //! Emissivity if start on begin
         float emissivity{1.0f};
+        //! Window of the running statistics of the object 1 temperature
+        thermo::RunningStatistics::config_t statistics{};
+        //! Store a sample only if a temperature changed, see also thermo::ChangeFilter
+        thermo::ChangeFilter::config_t publish{};
     };
 
     explicit UnitMLX90614(const uint8_t addr = DEFAULT_ADDRESS)
@@ -290,6 +297,36 @@ public:
     {
         return !empty() ? oldest().objectFahrenheit2() : std::numeric_limits<float>::quiet_NaN();
     }
+    /*!
+      @brief Running statistics of the object 1 temperature (Celsius) over the window of config_t::statistics
+      @note Not limited by stored_size. Reset by startPeriodicMeasurement
+     */
+    inline const thermo::RunningStatistics& statistics() const
+    {
+        return _statistics;
+    }
+    /*!
+      @brief Gets the publish filter
+      @details Samples whose ambient, object 1 and object 2 temperatures did not change are not stored and
+      updated() is false. The running statistics still see every sample
+      @note Reset by startPeriodicMeasurement
+     */
+    inline const thermo::ChangeFilter& publishFilter() const
+    {
+        return _publish_filter;
+    }
+    ///@}
+
+    ///@name Events
+    ///@{
+    /*!
+      @brief New data
+      @details Called from update() with the slot of the ring buffer the data was stored in
+     */
+    inline thermo::EventSource<mlx90614::Data>& onData()
+    {
+        return _on_data;
+    }
     ///@}
 
     ///@name Periodic measurement
@@ -619,6 +656,9 @@ protected:
 private:
     std::unique_ptr<m5::container::CircularBuffer<mlx90614::Data>> _data{};
     mlx90614::EEPROM _eeprom{};
+    thermo::RunningStatistics _statistics{};
+    thermo::ChangeFilter _publish_filter{};
+    thermo::EventSource<mlx90614::Data> _on_data{};
     config_t _cfg{};
 };
 
@@ -56,6 +56,14 @@ bool UnitNCIR2::begin()
     }
 
     _button_interval = _cfg.button_interval;
+    _statistics.config(_cfg.statistics);
+    _publish_filter.config(_cfg.publish);
+    if (!readAlarmTemperature(false, _alarm_raw[0]) || !readAlarmTemperature(true, _alarm_raw[1])) {
+        M5_LIB_LOGW("Failed to read the alarm temperature");
+        // No alarm rather than half of one
+        _alarm_raw[0] = std::numeric_limits<int16_t>::min();
+        _alarm_raw[1] = std::numeric_limits<int16_t>::max();
+    }
     return _cfg.start_periodic ? startPeriodicMeasurement(_cfg.interval) : true;
 }
 
@@ -70,7 +78,22 @@ void UnitNCIR2::update(const bool force)
             _updated = read_temperature(TEMPERATURE_REG, d.raw.data());
             if (_updated) {
                 _latest = at;
-                _data->push_back(d);
+                _statistics.push(d.temperature());
+                _updated = _publish_filter.publish(at, {d.temperature()});
+                if (_updated) {
+                    _data->push_back(d);
+                    if (_on_data.subscribed()) {
+                        _on_data.emit((*_data)[_data->size() - 1]);
+                    }
+                }
+                const uint8_t alarm = (d.value() < _alarm_raw[0] ? alarm_low : 0) |
+                                      (d.value() > _alarm_raw[1] ? alarm_high : 0);
+                if (alarm != _alarm) {
+                    _alarm = alarm;
+                    if (_on_alarm.subscribed()) {
+                        _on_alarm.emit(_alarm);
+                    }
+                }
             }
         }
     }
@@ -79,6 +102,9 @@ void UnitNCIR2::update(const bool force)
         _prev_button = _button;
         if (readButtonStatus(_button)) {
             _latest_button = at;
+            if (_on_button.subscribed() && _button != _prev_button) {
+                _on_button.emit(_button);
+            }
         }
     }
 }
@@ -91,6 +117,9 @@ bool UnitNCIR2::start_periodic_measurement(const uint32_t interval)
     _periodic = true;
     _interval = interval;
     _latest   = 0;
+    _alarm    = 0;  // The first sample raises an alarm already there
+    _statistics.reset();
+    _publish_filter.reset();
     return true;
 }
 
@@ -102,6 +131,7 @@ bool UnitNCIR2::start_periodic_measurement()
 bool UnitNCIR2::stop_periodic_measurement()
 {
     _periodic = false;
+    _alarm    = 0;
     return true;
 }
 
@@ -175,7 +205,11 @@ bool UnitNCIR2::readAlarmTemperature(const bool highlow, float& celsius)
 bool UnitNCIR2::writeAlarmTemperature(const bool highlow, const int16_t raw)
 {
     const uint8_t reg = ALARM_TEMPERATURE_REG + highlow * 2;
-    return writeRegister16LE(reg, static_cast<uint16_t>(raw));
+    if (writeRegister16LE(reg, static_cast<uint16_t>(raw))) {
+        _alarm_raw[highlow] = raw;
+        return true;
+    }
+    return false;
 }
 
 bool UnitNCIR2::write_alarm_temperature(const bool highlow, const float celsius)
@@ -12,6 +12,9 @@
 
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "../utility/running_statistics.hpp"
+#include "../utility/events.hpp"
+#include "../utility/change_filter.hpp"
 #include <limits>  // NaN
 #include <array>
 
@@ -23,6 +26,14 @@ namespace unit {
   @brief For UnitNCIR2
  */
 namespace ncir2 {
+
+///@sa m5::unit::UnitNCIR2::onAlarm
+///@name Alarm status
+///@{
+constexpr uint8_t alarm_low{0x01};   //!< Below the low threshold
+constexpr uint8_t alarm_high{0x02};  //!< Above the high threshold
+///@}
+
 /*!
   @struct Data
   @brief Measurement data group
@@ -72,6 +83,10 @@ public:
         uint32_t interval{250};
         //! Button status update interval(ms)
         uint32_t button_interval{20};
+        //! Window of the running statistics of the temperature
+        thermo::RunningStatistics::config_t statistics{};
+        //! Store a sample only if the temperature changed, see also thermo::ChangeFilter
+        thermo::ChangeFilter::config_t publish{};
     };
 
     explicit UnitNCIR2(const uint8_t addr = DEFAULT_ADDRESS)
@@ -128,6 +143,24 @@ public:
     {
         return !empty() ? oldest().fahrenheit() : std::numeric_limits<float>::quiet_NaN();
     }
+    /*!
+      @brief Running statistics of the temperature (Celsius) over the window of config_t::statistics
+      @note Not limited by stored_size. Reset by startPeriodicMeasurement
+     */
+    inline const thermo::RunningStatistics& statistics() const
+    {
+        return _statistics;
+    }
+    /*!
+      @brief Gets the publish filter
+      @details Samples whose temperature did not change are not stored and updated() is false.
+      The running statistics and the alarm status still see every sample
+      @note Reset by startPeriodicMeasurement
+     */
+    inline const thermo::ChangeFilter& publishFilter() const
+    {
+        return _publish_filter;
+    }
     ///@}
 
     ///@name Periodic measurement
@@ -404,6 +437,35 @@ public:
     bool writeConfig();
     ///@}
 
+    ///@name Events
+    ///@{
+    /*!
+      @brief New data
+      @details Called from update() with the slot of the ring buffer the data was stored in
+     */
+    inline thermo::EventSource<ncir2::Data>& onData()
+    {
+        return _on_data;
+    }
+    /*!
+      @brief Button pressed or released
+      @details Called with the pressed state when it changed
+     */
+    inline thermo::EventSource<bool>& onButton()
+    {
+        return _on_button;
+    }
+    /*!
+      @brief Alarm status changed
+      @details Called with the alarm status (alarm_xxx bits) when it changed.
+      The status is the new data compared with the alarm thresholds, read in begin and kept by writeAlarmTemperature
+     */
+    inline thermo::EventSource<uint8_t>& onAlarm()
+    {
+        return _on_alarm;
+    }
+    ///@}
+
     ////@name Button
     ///@{
     /*!
@@ -485,6 +547,14 @@ private:
     bool _button{}, _prev_button{};
     uint32_t _button_interval{20};
     types::elapsed_time_t _latest_button{};
+    thermo::RunningStatistics _statistics{};
+    thermo::ChangeFilter _publish_filter{};
+    // Alarm thresholds [0]:low [1]:high
+    int16_t _alarm_raw[2]{std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()};
+    uint8_t _alarm{};
+    thermo::EventSource<ncir2::Data> _on_data{};
+    thermo::EventSource<bool> _on_button{};
+    thermo::EventSource<uint8_t> _on_alarm{};
     config_t _cfg{};
 };
 
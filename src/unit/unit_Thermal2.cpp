@@ -83,6 +83,9 @@ bool UnitThermal2::begin()
     }
 
     _button_interval = _cfg.button_interval;
+    for (auto& f : _publish_filter) {
+        f.config(_cfg.publish);
+    }
 
     return writeRegister8(BUTTON_STATUS_REG, 1) && writeFunctionControl(_cfg.function_control) && writeBuzzer(0, 0) &&
            writeLED(0, 0, 0) && writeTemeratureMonitorSize(_cfg.monitor_width, _cfg.monitor_height) &&
@@ -96,14 +99,34 @@ void UnitThermal2::update(const bool force)
 
     // Data
     if (inPeriodic()) {
-        if (force || !_latest || at >= _latest + _interval) {
+        if (force || _ready_predictor.due(at)) {
             Data d{};
             uint8_t ds[2]{};
-            _updated = read_data_status(ds) && ds[0] && read_data(d);
+            if (read_data_status(ds)) {
+                if (ds[0]) {
+                    _ready_predictor.ready(at);
+                    d.subpage = ds[1];
+                    _updated  = read_data(d) && accept_subpage(d, at);
+                } else {
+                    _ready_predictor.miss(at);
+                }
+            }
+            if (_updated && _pixel_health) {
+                apply_pixel_health(d);
+            }
+            // Computed even if the subpage is not published, the regions follow every frame
+            if (_updated && _roi_engine && _roi_engine->merge(d.raw, d.subpage)) {
+                d.roi_sequence = _roi_engine->sequence();
+            }
+            if (_updated) {
+                _latest  = m5::utility::millis();
+                _updated = publish(d, at);
+            }
             if (_updated) {
-                _latest   = m5::utility::millis();
-                d.subpage = ds[1];
                 _data->push_back(d);
+                if (_on_data.subscribed()) {
+                    _on_data.emit((*_data)[_data->size() - 1]);
+                }
             }
         }
     }
@@ -118,6 +141,14 @@ void UnitThermal2::update(const bool force)
             if (wasHold()) {
                 _holding = 1;
             }
+            if (_on_button.subscribed() && (_button & ~thermal2::button_is_pressed)) {
+                _on_button.emit(_button);
+            }
+        }
+        uint8_t alarm{};
+        if (_on_alarm.subscribed() && readAlarmStatus(alarm) && alarm != _alarm) {
+            _alarm = alarm;
+            _on_alarm.emit(_alarm);
         }
     }
 }
@@ -130,7 +161,16 @@ bool UnitThermal2::start_periodic_measurement(const thermal2::Refresh rate)
     _periodic = write_function_control_bit(enabled_function_auto_refresh, true) && writeRefreshRate(rate);
     if (_periodic) {
         _latest   = 0;
+        _alarm    = 0;  // An alarm already raised is emitted with the first status read
         _interval = interval_table[m5::stl::to_underlying(rate)];
+        _ready_predictor.reset(_interval);
+        _frame_stats = FrameStatistics{};
+        for (auto& f : _publish_filter) {
+            f.reset();
+        }
+        if (_roi_engine) {
+            _roi_engine->reset();
+        }
     }
     return _periodic;
 }
@@ -144,6 +184,7 @@ bool UnitThermal2::start_periodic_measurement()
 bool UnitThermal2::stop_periodic_measurement()
 {
     _periodic = false;
+    _alarm    = 0;  // onAlarm is edge-triggered, an alarm still raised on restart must be emitted again
     return write_function_control_bit(enabled_function_auto_refresh, false);
 }
 
@@ -369,6 +410,12 @@ bool UnitThermal2::writeAlarmBuzzer(const bool highlow, const uint16_t freq, con
     return writeRegister(reg, v, 3);
 }
 
+bool UnitThermal2::readAlarmStatus(uint8_t& status)
+{
+    status = 0;
+    return read_register8(TEMPERATURE_ALARM_STATUS_REG, status);
+}
+
 bool UnitThermal2::readBuzzer(uint16_t& freq, uint8_t& duty)
 {
     freq = duty = 0;
@@ -510,5 +557,65 @@ bool UnitThermal2::read_data(thermal2::Data& data)
     return true;
 }
 
+bool UnitThermal2::accept_subpage(thermal2::Data& data, const types::elapsed_time_t at)
+{
+    // The burst read takes 25 transactions, the sensor may have flipped the page in the meantime
+    uint8_t ds[2]{};
+    data.torn = _cfg.detect_torn && read_data_status(ds) && (ds[1] != data.subpage);
+
+    // Subpages elapsed by timing, corrected by parity (same subpage: even, otherwise odd)
+    const uint32_t period = _ready_predictor.periodQ8();
+    if (_frame_stats.received && period) {
+        // In 64 bits, a gap of hours between the updates overflows 32 bits in Q8
+        uint64_t k = (((uint64_t)(at - _latest_subpage_at) << 8) + (period >> 1)) / period;
+        k          = k ? k : 1;
+        if ((k & 1) == (data.subpage == _latest_subpage)) {
+            ++k;
+        }
+        _frame_stats.dropped += (uint32_t)(k - 1);
+    }
+    ++_frame_stats.received;
+    _latest_subpage    = data.subpage;
+    _latest_subpage_at = at;
+
+    if (data.torn) {
+        ++_frame_stats.torn;
+        M5_LIB_LOGD("Torn subpage %u", data.subpage);
+        return !_cfg.discard_torn;
+    }
+    return true;
+}
+
+void UnitThermal2::apply_pixel_health(thermal2::Data& data)
+{
+    // A torn subpage mixes two frames, do not learn from it
+    if (!data.torn) {
+        _pixel_health->update(data.raw, data.subpage);
+    }
+    _pixel_health->interpolate(data.raw, data.subpage);
+
+    thermal2::FrameSummary s{};
+    if (_pixel_health->summarize(s)) {
+        data.median_temperature    = s.median;
+        data.average_temperature   = s.average;
+        data.most_diff_temperature = s.most_diff;
+        data.most_diff_x           = s.most_diff_x;
+        data.most_diff_y           = s.most_diff_y;
+        data.lowest_temperature    = s.lowest;
+        data.lowest_diff_x         = s.lowest_x;
+        data.lowest_diff_y         = s.lowest_y;
+        data.highest_temperature   = s.highest;
+        data.highest_diff_x        = s.highest_x;
+        data.highest_diff_y        = s.highest_y;
+    }
+}
+
+bool UnitThermal2::publish(const thermal2::Data& data, const types::elapsed_time_t at)
+{
+    return _publish_filter[data.subpage & 1].publish(
+        at, {data.medianTemperature(), data.averageTemperature(), data.lowestTemperature(), data.highestTemperature()},
+        data.raw, 384);
+}
+
 }  // namespace unit
 }  // namespace m5
@@ -11,6 +11,12 @@
 #define M5_UNIT_THERMO_UNIT_THERMAL2_HPP
 #include <M5UnitComponent.hpp>
 #include <m5_utility/container/circular_buffer.hpp>
+#include "../utility/ready_predictor.hpp"
+#include "../utility/events.hpp"
+#include "../utility/change_filter.hpp"
+#include "../thermal2/frame.hpp"
+#include "../thermal2/pixel_health.hpp"
+#include "../thermal2/roi.hpp"
 #include <limits>  // NaN
 #include <cmath>
 #include <array>
@@ -69,18 +75,6 @@ enum class Refresh : uint8_t {
     Rate64Hz,   //!< 64Hz
 };
 
-//! @brief Celsius to raw temperature value
-inline static uint16_t celsius_to_raw(const float f)
-{
-    int i = std::round((f + 64) * 128);
-    return static_cast<uint16_t>(std::max(std::min(i, (int)std::numeric_limits<uint16_t>::max()), 0));
-}
-//! @brief Raw temperature value to celsius
-inline static float raw_to_celsius(const uint16_t u16)
-{
-    return u16 / 128.0f - 64;
-}
-
 #pragma pack(push)
 #pragma pack(1)
 /*!
@@ -105,7 +99,9 @@ struct Data {
             uint8_t highest_diff_y;
         };
     };
-    uint16_t raw[384]{};  // Raw pixel data (1/2)
+    uint16_t raw[384]{};      // Raw pixel data (1/2)
+    bool torn{};              // The sensor flipped the subpage while this was being read
+    uint32_t roi_sequence{};  // RoiEngine::sequence() of the frame this subpage completed, 0 if not processed
 
     // temperture information
     inline float medianTemperature() const
@@ -137,6 +133,17 @@ struct Data {
 };
 #pragma pack(pop)
 
+/*!
+  @struct FrameStatistics
+  @brief Subpage sequence counters
+  @sa m5::unit::UnitThermal2::frameStatistics
+ */
+struct FrameStatistics {
+    uint32_t received{};  //!< Subpages read
+    uint32_t dropped{};   //!< Subpages the sensor produced but were never read
+    uint32_t torn{};      //!< Subpages the sensor flipped while being read
+};
+
 }  // namespace thermal2
 
 /*!
@@ -164,6 +171,12 @@ public:
         uint8_t function_control{thermal2::enabled_function_led};
         //! Button status update interval(ms)
         uint32_t button_interval{20};
+        //! Re-read the subpage after each read to detect torn subpages
+        bool detect_torn{true};
+        //! Discard torn subpages if true, otherwise store them with Data::torn set
+        bool discard_torn{true};
+        //! Store a subpage only if its temperature information or pixels changed, see also thermo::ChangeFilter
+        thermo::ChangeFilter::config_t publish{};
     };
 
     explicit UnitThermal2(const uint8_t addr = DEFAULT_ADDRESS)
@@ -218,6 +231,73 @@ public:
     {
         return PeriodicMeasurementAdapter<UnitThermal2, thermal2::Data>::stopPeriodicMeasurement();
     }
+    /*!
+      @brief Gets the data-ready predictor
+      @details Status polls during periodic measurement are scheduled by this predictor,
+      which learns the actual cadence and phase of the sensor from observed subpage updates
+     */
+    inline const thermo::ReadyPredictor& readyPredictor() const
+    {
+        return _ready_predictor;
+    }
+    /*!
+      @brief Gets the subpage sequence counters
+      @details Subpages alternate 0,1,0,1... A repeated subpage or a gap longer than the learned period means
+      subpages were dropped. A subpage that changed between the status read and the re-read after the burst read is
+      counted as torn
+      @note Reset by startPeriodicMeasurement
+     */
+    inline const thermal2::FrameStatistics& frameStatistics() const
+    {
+        return _frame_stats;
+    }
+    /*!
+      @brief Gets the publish filter
+      @details Subpages that did not change are not stored and updated() is false.
+      Each subpage is compared with the last stored one of the same subpage on the median, average, lowest and
+      highest temperature, and on the raw pixels (thermo::ChangeFilter::config_t::pixel_band)
+      @note Reset by startPeriodicMeasurement
+     */
+    inline const thermo::ChangeFilter& publishFilter(const uint8_t subpage) const
+    {
+        return _publish_filter[subpage & 1];
+    }
+    /*!
+      @brief Attach the pixel health tracker
+      @param ph Tracker, nullptr to detach
+      @details Every subpage read is fed to the tracker. Bad pixels are replaced by the interpolation of their
+      neighbours, and the summary temperatures (median, average, lowest, highest...) are recomputed from the
+      assembled frame without them
+      @warning The tracker must outlive the unit or be detached
+     */
+    inline void setPixelHealth(thermal2::PixelHealth* ph)
+    {
+        _pixel_health = ph;
+    }
+    //! @brief Gets the attached pixel health tracker
+    inline thermal2::PixelHealth* pixelHealth() const
+    {
+        return _pixel_health;
+    }
+    /*!
+      @brief Attach the region of interest engine
+      @param roi Engine, nullptr to detach
+      @details Every subpage read is merged into the frame assembled by the engine (after the pixel health
+      interpolation), and the statistics of the regions are computed for the latest two subpages.
+      Data::roi_sequence of the stored data and onData tells which RoiEngine::sequence() the statistics in
+      RoiEngine::rois() belong to
+      @note The assembled frame is reset by startPeriodicMeasurement
+      @warning The engine must outlive the unit or be detached
+     */
+    inline void setRoiEngine(thermal2::RoiEngine* roi)
+    {
+        _roi_engine = roi;
+    }
+    //! @brief Gets the attached region of interest engine
+    inline thermal2::RoiEngine* roiEngine() const
+    {
+        return _roi_engine;
+    }
     ///@}
 
     ///@name Single shot measurement
@@ -413,6 +493,12 @@ public:
       @note The interval valid range between 5 and 255 (50ms - 2550ms)
      */
     bool writeAlarmBuzzer(const bool highlow, const uint16_t freq, const uint8_t interval);
+    /*!
+      @brief Read the alarm status
+      @param[out] status Alarms currently reached (enabled_xxx bits)
+      @return True if successful
+     */
+    bool readAlarmStatus(uint8_t& status);
     ///@}
 
     ///@warning Value setting is invalid while buzzer is controlled by alarms
@@ -496,6 +582,38 @@ public:
     bool writeLED(const uint8_t r, const uint8_t g, const uint8_t b, const bool verify = true);
     ///@}
 
+    ///@name Events
+    ///@{
+    /*!
+      @brief New data
+      @details Called from update() with the slot of the ring buffer the data was stored in
+      @code
+      unit.onData().subscribe([](const thermal2::Data& d) { M5_LOGI("%.2f", d.averageTemperature()); });
+      @endcode
+     */
+    inline thermo::EventSource<thermal2::Data>& onData()
+    {
+        return _on_data;
+    }
+    /*!
+      @brief Button pressed, released, clicked or hold
+      @details Called with the button status (button_xxx bits) when any of the was_xxx bits is set
+     */
+    inline thermo::EventSource<uint8_t>& onButton()
+    {
+        return _on_button;
+    }
+    /*!
+      @brief Alarm status changed
+      @details Called with the alarm status (enabled_xxx bits) when it changed.
+      The status is polled at the button status interval only while subscribed
+     */
+    inline thermo::EventSource<uint8_t>& onAlarm()
+    {
+        return _on_alarm;
+    }
+    ///@}
+
     ///@name Button
     ///@{
     /*!
@@ -593,6 +711,9 @@ protected:
     bool request_data();
     bool read_data_status(uint8_t s[2]);  // [0]:data refresh ctrl, [1]subpage information
     bool read_data(thermal2::Data& data);
+    bool accept_subpage(thermal2::Data& data, const types::elapsed_time_t at);
+    void apply_pixel_health(thermal2::Data& data);
+    bool publish(const thermal2::Data& data, const types::elapsed_time_t at);
 
     bool start_periodic_measurement(const thermal2::Refresh rate);
     bool start_periodic_measurement();
@@ -622,9 +743,18 @@ protected:
 
 private:
     std::unique_ptr<m5::container::CircularBuffer<thermal2::Data>> _data{};
-    uint8_t _button{}, _holding{};
+    uint8_t _button{}, _holding{}, _alarm{};
     uint32_t _button_interval{20};
     types::elapsed_time_t _latest_button{};
+    thermo::ReadyPredictor _ready_predictor{};
+    thermal2::FrameStatistics _frame_stats{};
+    thermo::ChangeFilter _publish_filter[2]{};  // For each subpage
+    types::elapsed_time_t _latest_subpage_at{};
+    uint8_t _latest_subpage{};
+    thermal2::PixelHealth* _pixel_health{};
+    thermal2::RoiEngine* _roi_engine{};
+    thermo::EventSource<thermal2::Data> _on_data{};
+    thermo::EventSource<uint8_t> _on_button{}, _on_alarm{};
     config_t _cfg{};
 };
 
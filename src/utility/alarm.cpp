@@ -0,0 +1,240 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file alarm.cpp
+  @brief Rate-of-rise and change-point alarms evaluated on the host
+*/
+#include "alarm.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+namespace {
+constexpr float nan_value{std::numeric_limits<float>::quiet_NaN()};
+constexpr uint8_t cause_bits[3]{alarm_cause_high, alarm_cause_rise, alarm_cause_change};
+}  // namespace
+
+uint8_t AlarmEngine::add(const config_t& cfg)
+{
+    _channels.emplace_back();
+    _channels.back().cfg = cfg;
+    return (uint8_t)(_channels.size() - 1);
+}
+
+AlarmEngine::config_t AlarmEngine::config(const uint8_t ch) const
+{
+    return ch < _channels.size() ? _channels[ch].cfg : config_t{};
+}
+
+bool AlarmEngine::config(const uint8_t ch, const config_t& cfg)
+{
+    if (ch >= _channels.size()) {
+        return false;
+    }
+    _channels[ch]     = channel_t{};
+    _channels[ch].cfg = cfg;
+    return true;
+}
+
+void AlarmEngine::reset(const uint8_t ch)
+{
+    if (ch < _channels.size()) {
+        config(ch, _channels[ch].cfg);
+    }
+}
+
+void AlarmEngine::clear()
+{
+    _channels.clear();
+    _event = AlarmEvent{};
+    _stats = stats_t{};
+}
+
+bool AlarmEngine::active(const uint8_t ch) const
+{
+    return ch < _channels.size() && _channels[ch].active;
+}
+
+uint8_t AlarmEngine::causes(const uint8_t ch) const
+{
+    return active(ch) ? _channels[ch].causes : 0;
+}
+
+float AlarmEngine::rate(const uint8_t ch) const
+{
+    return ch < _channels.size() ? _channels[ch].rate : nan_value;
+}
+
+float AlarmEngine::cusum(const uint8_t ch) const
+{
+    return ch < _channels.size() ? _channels[ch].s : nan_value;
+}
+
+void AlarmEngine::close_slot(channel_t& c)
+{
+    const uint8_t tail = (c.head + c.size) % rise_points;
+    c.time[tail]       = c.slot_start + (uint32_t)(c.slot_time / c.slot_count);
+    c.value[tail]      = (float)(c.slot_sum / c.slot_count);
+    if (c.size < rise_points) {
+        ++c.size;
+    } else {
+        c.head = (c.head + 1) % rise_points;
+    }
+
+    // Least-squares slope of the points in the window, times relative to the newest
+    const uint32_t newest = c.time[tail];
+    double st{}, sv{}, stt{}, stv{};
+    uint32_t n{}, span{};
+    for (uint8_t i = 0; i < c.size; ++i) {
+        const uint8_t idx = (c.head + i) % rise_points;
+        const uint32_t dt = newest - c.time[idx];
+        if (dt > c.cfg.rise_window) {
+            continue;
+        }
+        const double t = -(double)dt / 1000.0;
+        st += t;
+        sv += c.value[idx];
+        stt += t * t;
+        stv += t * c.value[idx];
+        span = dt > span ? dt : span;
+        ++n;
+    }
+    const double den = n * stt - st * st;
+    // Not until the points cover half of the window
+    c.rate = (n >= 4 && span * 2 >= c.cfg.rise_window && den > 0.0) ? (float)((n * stv - st * sv) / den) : nan_value;
+}
+
+void AlarmEngine::update_condition(channel_t& c, const uint8_t cause, const bool on, const bool off,
+                                   const uint32_t onset)
+{
+    if (!(c.conditions & cause) && on) {
+        c.conditions |= cause;
+        for (uint8_t i = 0; i < 3; ++i) {
+            if (cause_bits[i] == cause) {
+                c.onset[i] = onset;
+            }
+        }
+    } else if ((c.conditions & cause) && off) {
+        c.conditions &= ~cause;
+    }
+}
+
+bool AlarmEngine::push(const uint8_t ch, const uint32_t time, const float value)
+{
+    if (ch >= _channels.size() || value != value) {
+        return false;
+    }
+    auto& c         = _channels[ch];
+    const auto& cfg = c.cfg;
+    ++_stats.samples;
+
+    // Threshold
+    if (cfg.high == cfg.high) {
+        update_condition(c, alarm_cause_high, value > cfg.high, value < cfg.high - cfg.high_hysteresis, time);
+    }
+
+    // Rate of rise
+    if (cfg.rise_rate == cfg.rise_rate) {
+        const uint32_t slot = cfg.rise_window / rise_points ? cfg.rise_window / rise_points : 1;
+        if (c.slot_count && time - c.slot_start >= slot) {
+            close_slot(c);
+            c.slot_count = 0;
+        }
+        if (!c.slot_count) {
+            c.slot_start = time;
+            c.slot_time = c.slot_sum = 0;
+        }
+        c.slot_time += time - c.slot_start;
+        c.slot_sum += value;
+        ++c.slot_count;
+        if (c.rate == c.rate) {
+            update_condition(c, alarm_cause_rise, c.rate > cfg.rise_rate, c.rate < cfg.rise_rate - cfg.rise_hysteresis,
+                             time);
+        }
+    }
+
+    // CUSUM
+    if (cfg.cusum_limit == cfg.cusum_limit) {
+        if (!c.baseline_count) {
+            c.baseline = value;
+        }
+        const float s = c.s + value - c.baseline - cfg.cusum_drift;
+        c.s           = s > 0.0f ? s : 0.0f;
+        if (c.s == 0.0f) {
+            c.s_zero  = time;
+            c.s_count = 0;
+        } else {
+            ++c.s_count;
+        }
+        const bool detected = c.s > cfg.cusum_limit && !(c.conditions & alarm_cause_change);
+        update_condition(c, alarm_cause_change, c.s > cfg.cusum_limit, c.s < cfg.cusum_limit * 0.5f, c.s_zero);
+        if (c.conditions & alarm_cause_change) {
+            if (detected) {
+                // Move the baseline to the new level, the mean since S was 0
+                c.baseline += cfg.cusum_drift + c.s / c.s_count;
+            }
+            // Bounded, so that S falls under half of the limit soon after the value settles
+            c.s = c.s < cfg.cusum_limit ? c.s : cfg.cusum_limit;
+        }
+        if (c.s == 0.0f || (c.conditions & alarm_cause_change)) {
+            // No evidence of a change or the change is known, follow the value
+            const uint32_t n =
+                c.baseline_count < cfg.cusum_baseline ? c.baseline_count + 1 : (uint32_t)cfg.cusum_baseline + 1;
+            c.baseline += (value - c.baseline) * 2.0f / (n + 1);
+            ++c.baseline_count;
+        }
+    }
+
+    // Debounce
+    bool changed{};
+    if (!c.active) {
+        c.hold = c.conditions ? c.hold + 1 : 0;
+        if (c.hold >= (cfg.debounce ? cfg.debounce : 1)) {
+            c.active  = true;
+            c.causes  = c.conditions;
+            c.hold    = 0;
+            uint32_t onset{time};
+            for (uint8_t i = 0; i < 3; ++i) {
+                if ((c.conditions & cause_bits[i]) && (int32_t)(c.onset[i] - onset) < 0) {
+                    onset = c.onset[i];
+                }
+            }
+            _event         = AlarmEvent{};
+            _event.channel = ch;
+            _event.raised  = true;
+            _event.causes  = c.causes;
+            _event.time    = time;
+            _event.onset   = onset;
+            _event.value   = value;
+            ++_stats.raised;
+            _stats.total_latency += _event.latency();
+            _stats.max_latency = _event.latency() > _stats.max_latency ? _event.latency() : _stats.max_latency;
+            changed            = true;
+        }
+    } else {
+        c.causes |= c.conditions;
+        c.hold = c.conditions ? 0 : c.hold + 1;
+        if (c.hold >= (cfg.release ? cfg.release : 1)) {
+            _event         = AlarmEvent{};
+            _event.channel = ch;
+            _event.causes  = c.causes;
+            _event.time    = time;
+            _event.onset   = time;
+            _event.value   = value;
+            c.active       = false;
+            c.causes       = 0;
+            c.hold         = 0;
+            ++_stats.cleared;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
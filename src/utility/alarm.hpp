@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file alarm.hpp
+  @brief Rate-of-rise and change-point alarms evaluated on the host
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_ALARM_HPP
+#define M5_UNIT_THERMO_UTILITY_ALARM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+///@name Alarm causes
+///@{
+constexpr uint8_t alarm_cause_high{0x01};    //!< Above the threshold
+constexpr uint8_t alarm_cause_rise{0x02};    //!< Rising faster than the rate
+constexpr uint8_t alarm_cause_change{0x04};  //!< CUSUM detected a shift up from the baseline
+///@}
+
+/*!
+  @struct AlarmEvent
+  @brief Alarm raised or cleared
+ */
+struct AlarmEvent {
+    uint8_t channel{};  //!< Channel
+    bool raised{};      //!< Raised if true, otherwise cleared
+    uint8_t causes{};   //!< Causes (alarm_cause_xxx) while raised
+    uint32_t time{};    //!< Time of the sample that changed the state (ms)
+    uint32_t onset{};   //!< Estimated start of the change that raised it (ms)
+    float value{};      //!< Value of the sample
+
+    //! @brief Time from the onset to the alarm (ms)
+    inline uint32_t latency() const
+    {
+        return time - onset;
+    }
+};
+
+/*!
+  @class AlarmEngine
+  @brief Alarms of many channels, such as the regions of Thermal2 or the NCIR2 and MLX90614 sensors
+  @details Each channel evaluates, on every sample
+  - Threshold: the value is above high, cleared below high - high_hysteresis
+  - Rate of rise: the least-squares slope of the window is above rise_rate, cleared below
+  rise_rate - rise_hysteresis. The window is kept as rise_points means of equal slots, so the memory is fixed
+  - CUSUM: S = max(0, S + value - baseline - cusum_drift) is above cusum_limit, cleared below half of it.
+  The baseline is an EWMA that only follows the value while S is 0 or the change is raised.
+  When raised, the baseline moves to the mean since S was 0 and S is capped at cusum_limit,
+  so a step to a new steady level clears once the value settles
+  The alarm is raised when a condition holds for debounce samples and cleared when every condition has been
+  clear for release samples. The onset of a CUSUM alarm is the last time S was 0, otherwise the first sample of
+  the condition, so the latency shows how long the alarm took to notice the change
+  @code
+  AlarmEngine alarms;
+  AlarmEngine::config_t cfg{};
+  cfg.rise_rate = 0.5f;  // 0.5 Celsius per second
+  auto ch       = alarms.add(cfg);
+  if (alarms.push(ch, millis(), unit.temperature()) && alarms.event().raised) {
+      M5_LOGW("Alarm %x latency %u ms", alarms.event().causes, alarms.event().latency());
+  }
+  @endcode
+ */
+class AlarmEngine {
+public:
+    //! Points of the rate of rise window
+    static constexpr uint8_t rise_points{32};
+
+    /*!
+      @struct config_t
+      @brief Channel settings
+      @note The levels are in the unit of the values pushed, NaN disables a condition
+     */
+    struct config_t {
+        //! Raise above this value
+        float high{std::numeric_limits<float>::quiet_NaN()};
+        //! Clear below high minus this
+        float high_hysteresis{1.0f};
+        //! Raise when the value rises faster than this (per second)
+        float rise_rate{std::numeric_limits<float>::quiet_NaN()};
+        //! Clear below rise_rate minus this (per second)
+        float rise_hysteresis{0.1f};
+        //! Window of the rate of rise (ms)
+        uint32_t rise_window{10 * 1000};
+        //! Raise when the cumulative sum of the shift from the baseline exceeds this (h)
+        float cusum_limit{std::numeric_limits<float>::quiet_NaN()};
+        //! Shift per sample ignored by the CUSUM (k)
+        float cusum_drift{0.5f};
+        //! Samples of the EWMA baseline of the CUSUM
+        uint16_t cusum_baseline{256};
+        //! Samples a condition must hold to raise (1 -)
+        uint8_t debounce{3};
+        //! Samples every condition must be clear to clear (1 -)
+        uint8_t release{3};
+    };
+
+    /*!
+      @struct stats_t
+      @brief Counters since clear()
+     */
+    struct stats_t {
+        uint32_t samples{};        //!< Samples evaluated
+        uint32_t raised{};         //!< Alarms raised
+        uint32_t cleared{};        //!< Alarms cleared
+        uint32_t max_latency{};    //!< Longest latency of a raised alarm (ms)
+        uint64_t total_latency{};  //!< Sum of the latencies of the raised alarms (ms)
+
+        //! @brief Mean latency of the raised alarms (ms)
+        inline uint32_t meanLatency() const
+        {
+            return raised ? (uint32_t)(total_latency / raised) : 0;
+        }
+    };
+
+    ///@name Channels
+    ///@{
+    /*!
+      @brief Add a channel
+      @return Channel number
+     */
+    uint8_t add(const config_t& cfg);
+    //! @brief Number of channels
+    inline size_t channels() const
+    {
+        return _channels.size();
+    }
+    //! @brief Gets the configration of the channel
+    config_t config(const uint8_t ch) const;
+    /*!
+      @brief Set the configration of the channel
+      @note Resets the channel
+     */
+    bool config(const uint8_t ch, const config_t& cfg);
+    //! @brief Forget the history of the channel and clear its alarm
+    void reset(const uint8_t ch);
+    //! @brief Remove all channels and the counters
+    void clear();
+    ///@}
+
+    /*!
+      @brief Evaluate the sample
+      @param ch Channel
+      @param time Time (ms), not decreasing
+      @param value Value, NaN is ignored
+      @return True if the alarm of the channel was raised or cleared, see event()
+     */
+    bool push(const uint8_t ch, const uint32_t time, const float value);
+
+    //! @brief Is the alarm of the channel raised?
+    bool active(const uint8_t ch) const;
+    //! @brief Causes of the raised alarm of the channel, 0 if not raised
+    uint8_t causes(const uint8_t ch) const;
+    //! @brief Latest rate of rise of the channel (per second, NaN if not yet known)
+    float rate(const uint8_t ch) const;
+    //! @brief Latest CUSUM of the channel
+    float cusum(const uint8_t ch) const;
+
+    //! @brief The latest alarm raised or cleared
+    inline const AlarmEvent& event() const
+    {
+        return _event;
+    }
+    //! @brief Counters
+    inline const stats_t& stats() const
+    {
+        return _stats;
+    }
+
+protected:
+    struct channel_t {
+        config_t cfg{};
+        // Rate of rise, a ring of slot means
+        uint32_t time[rise_points]{};
+        float value[rise_points]{};
+        uint8_t head{}, size{};
+        uint32_t slot_start{}, slot_count{};
+        double slot_time{}, slot_sum{};  // Sums of the open slot, time relative to slot_start
+        float rate{std::numeric_limits<float>::quiet_NaN()};
+        // CUSUM
+        float baseline{}, s{};
+        uint32_t baseline_count{}, s_zero{}, s_count{};
+        // Conditions and the alarm
+        uint8_t conditions{}, causes{};
+        uint32_t onset[3]{};
+        uint8_t hold{};
+        bool active{};
+    };
+
+    void close_slot(channel_t& c);
+    void update_condition(channel_t& c, const uint8_t cause, const bool on, const bool off, const uint32_t onset);
+
+private:
+    std::vector<channel_t> _channels{};
+    AlarmEvent _event{};
+    stats_t _stats{};
+};
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
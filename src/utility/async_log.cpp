@@ -0,0 +1,274 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file async_log.cpp
+  @brief Multi-buffered logging to storage by a writer thread
+*/
+#include "async_log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+namespace {
+inline uint32_t elapsed_us(const std::chrono::steady_clock::time_point& from)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - from)
+        .count();
+}
+}  // namespace
+
+// PosixFileBackend
+PosixFileBackend::~PosixFileBackend()
+{
+    close();
+}
+
+bool PosixFileBackend::open(const char* path, const bool append)
+{
+    close();
+    _fd = ::open(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    return _fd >= 0;
+}
+
+void PosixFileBackend::close()
+{
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool PosixFileBackend::write(const uint8_t* data, const size_t len)
+{
+    size_t done{};
+    while (_fd >= 0 && done < len) {
+        const ssize_t n = ::write(_fd, data + done, len - done);
+        if (n <= 0) {
+            return false;
+        }
+        done += (size_t)n;
+    }
+    return done == len;
+}
+
+bool PosixFileBackend::sync()
+{
+    return _fd >= 0 && ::fsync(_fd) == 0;
+}
+
+// AsyncLog
+AsyncLog::~AsyncLog()
+{
+    end();
+}
+
+bool AsyncLog::begin(LogBackend& backend)
+{
+    end();
+    const uint32_t align = std::max<uint32_t>(_cfg.alignment, 1);
+    if (_cfg.buffers < 2 || !_cfg.buffer_size || (align & (align - 1))) {
+        return false;
+    }
+    const size_t stride = (_cfg.buffer_size + align - 1) & ~(size_t)(align - 1);
+    _memory.reset(new (std::nothrow) uint8_t[stride * _cfg.buffers + align]);
+    if (!_memory) {
+        return false;
+    }
+    uint8_t* p = _memory.get() + ((align - ((uintptr_t)_memory.get() & (align - 1))) & (align - 1));
+
+    _buffers.clear();
+    _free.clear();
+    _queue.clear();
+    _lengths.assign(_cfg.buffers, 0);
+    for (uint8_t i = 0; i < _cfg.buffers; ++i) {
+        _buffers.push_back(p + stride * i);
+        _free.push_back(i);
+    }
+    _queue.reserve(_cfg.buffers);
+    _active  = -1;
+    _writing = _stop = _sync = false;
+    _largest = 0;
+    _stats   = stats_t{};
+    _backend = &backend;
+    _thread  = std::thread([this]() { writer(); });
+    return true;
+}
+
+void AsyncLog::end()
+{
+    if (!_backend) {
+        return;
+    }
+    flush(true);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _work.notify_one();
+    _thread.join();
+    _backend = nullptr;
+    _buffers.clear();
+    _memory.reset();
+}
+
+size_t AsyncLog::room_locked() const
+{
+    return (_active >= 0 ? _cfg.buffer_size - _lengths[_active] : 0) + _free.size() * _cfg.buffer_size;
+}
+
+size_t AsyncLog::room() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _backend ? room_locked() : 0;
+}
+
+bool AsyncLog::ready() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _backend && room_locked() >= std::max<size_t>(_largest, 1);
+}
+
+AsyncLog::stats_t AsyncLog::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+bool AsyncLog::append(const uint8_t* data, const size_t len)
+{
+    const auto started = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_backend || (!data && len)) {
+        return false;
+    }
+    if (len > (size_t)_cfg.buffer_size * _cfg.buffers) {
+        ++_stats.dropped;
+        return false;
+    }
+    _largest = std::max(_largest, len);
+
+    bool waited{};
+    while (room_locked() < len) {
+        if (_cfg.overflow == Overflow::DropOldest && !_queue.empty()) {
+            const uint8_t oldest = _queue.front();
+            _queue.erase(_queue.begin());
+            _stats.dropped_bytes += _lengths[oldest];
+            _lengths[oldest] = 0;
+            _free.push_back(oldest);
+            continue;
+        }
+        if (_cfg.overflow == Overflow::Block) {
+            if (_queue.empty() && !_writing && _active >= 0) {
+                // Only the partly filled buffer is left to write
+                _queue.push_back(_active);
+                _active = -1;
+                _work.notify_one();
+            }
+            waited = true;
+            _done.wait(lock);
+            continue;
+        }
+        // DropNewest, or DropOldest with nothing to discard but the buffer being written
+        ++_stats.dropped;
+        return false;
+    }
+    _stats.blocked += waited;
+
+    size_t done{};
+    bool queued{};
+    while (done < len) {
+        if (_active < 0) {
+            _active = _free.front();
+            _free.erase(_free.begin());
+        }
+        uint32_t& fill = _lengths[_active];
+        const size_t n = std::min<size_t>(len - done, _cfg.buffer_size - fill);
+        std::memcpy(_buffers[_active] + fill, data + done, n);
+        fill += n;
+        done += n;
+        if (fill == _cfg.buffer_size) {
+            _queue.push_back(_active);
+            _active = -1;
+            queued  = true;
+        }
+    }
+    ++_stats.records;
+    _stats.bytes += len;
+    _stats.max_queued    = std::max<uint8_t>(_stats.max_queued, _queue.size() + _writing);
+    _stats.max_append_us = std::max(_stats.max_append_us, elapsed_us(started));
+    lock.unlock();
+    if (queued) {
+        _work.notify_one();
+    }
+    return true;
+}
+
+void AsyncLog::flush(const bool wait)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_backend) {
+        return;
+    }
+    if (_active >= 0 && _lengths[_active]) {
+        _queue.push_back(_active);
+        _active = -1;
+    }
+    _sync |= wait;
+    _work.notify_one();
+    if (wait) {
+        _done.wait(lock, [this]() { return _queue.empty() && !_writing && !_sync; });
+    }
+}
+
+void AsyncLog::writer()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _work.wait(lock, [this]() { return _stop || _sync || !_queue.empty(); });
+        if (_queue.empty()) {
+            if (_sync) {
+                lock.unlock();
+                _backend->sync();
+                lock.lock();
+                _sync = false;
+                _done.notify_all();
+                continue;
+            }
+            return;  // Stopped
+        }
+        const uint8_t idx = _queue.front();
+        _queue.erase(_queue.begin());
+        _writing = true;
+        lock.unlock();
+
+        const auto started = std::chrono::steady_clock::now();
+        bool ok            = _backend->write(_buffers[idx], _lengths[idx]);
+        if (ok && _cfg.sync_each) {
+            ok = _backend->sync();
+        }
+        const uint32_t us = elapsed_us(started);
+
+        lock.lock();
+        _writing      = false;
+        _lengths[idx] = 0;
+        _free.push_back(idx);
+        ++_stats.written;
+        _stats.errors += !ok;
+        _stats.max_write_us = std::max(_stats.max_write_us, us);
+        _done.notify_all();
+    }
+}
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
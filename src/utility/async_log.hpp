@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file async_log.hpp
+  @brief Multi-buffered logging to storage by a writer thread
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_ASYNC_LOG_HPP
+#define M5_UNIT_THERMO_UTILITY_ASYNC_LOG_HPP
+
+#include "pipeline.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+/*!
+  @class LogBackend
+  @brief Storage written by AsyncLog
+  @details Called from the writer thread only
+ */
+class LogBackend {
+public:
+    virtual ~LogBackend() = default;
+    //! @brief Write all the bytes, false on error
+    virtual bool write(const uint8_t* data, const size_t len) = 0;
+    //! @brief Make what was written durable
+    virtual bool sync()
+    {
+        return true;
+    }
+};
+
+/*!
+  @class PosixFileBackend
+  @brief File written with open/write/fsync
+  @details Works on Linux and on a file system of the ESP32 VFS (SD, LittleFS, FAT)
+ */
+class PosixFileBackend : public LogBackend {
+public:
+    PosixFileBackend() = default;
+    ~PosixFileBackend() override;
+    PosixFileBackend(const PosixFileBackend&)            = delete;
+    PosixFileBackend& operator=(const PosixFileBackend&) = delete;
+
+    /*!
+      @brief Open the file
+      @param path Path
+      @param append Append to the file if true, otherwise truncate it
+      @return True if successful
+     */
+    bool open(const char* path, const bool append = true);
+    //! @brief Close the file
+    void close();
+    //! @brief Is the file open?
+    inline bool isOpen() const
+    {
+        return _fd >= 0;
+    }
+
+    bool write(const uint8_t* data, const size_t len) override;
+    bool sync() override;
+
+private:
+    int _fd{-1};
+};
+
+/*!
+  @class AsyncLog
+  @brief Append records to buffers and write the full buffers to the backend on a writer thread
+  @details The caller only copies into the active buffer, so a page erase or a cluster allocation that stalls
+  the storage for tens of milliseconds does not stall the acquisition. Buffers are written whole, so the
+  storage sees writes of buffer_size aligned to alignment.
+  When every buffer is waiting for the storage the overflow policy decides:
+  - DropNewest refuses the record, what was written stays whole records
+  - DropOldest discards the oldest buffer waiting to be written, a record across its edges is cut
+  - Block waits for the writer
+  @code
+  PosixFileBackend file;
+  file.open("/sd/thermal.bin");
+  AsyncLog log;
+  log.begin(file);
+  while (unit.available()) {
+      auto& d = unit.oldest();
+      log.append(buf, encoder.encode(buf, d.raw, d.subpage, d.temp, millis(), d.torn));
+      unit.discard();
+  }
+  log.end();
+  @endcode
+  @note Records longer than a buffer are split across buffers, but the total capacity limits the record size
+ */
+class AsyncLog {
+public:
+    //! @brief What to do when the buffers are full
+    enum class Overflow : uint8_t {
+        DropNewest,  //!< Refuse the record
+        DropOldest,  //!< Discard the oldest buffer not yet being written
+        Block,       //!< Wait for the writer
+    };
+
+    /*!
+      @struct config_t
+      @brief Log settings
+     */
+    struct config_t {
+        //! Bytes of each buffer, a multiple of the sector or page size works best
+        uint32_t buffer_size{16 * 1024};
+        //! Buffers (2 -)
+        uint8_t buffers{2};
+        //! Alignment of the buffers (power of 2)
+        uint16_t alignment{64};
+        //! Overflow policy
+        Overflow overflow{Overflow::DropNewest};
+        //! Call LogBackend::sync after every buffer written
+        bool sync_each{false};
+    };
+
+    /*!
+      @struct stats_t
+      @brief Counters since begin()
+     */
+    struct stats_t {
+        uint32_t records{};        //!< Records appended
+        uint64_t bytes{};          //!< Bytes appended
+        uint32_t dropped{};        //!< Records refused
+        uint64_t dropped_bytes{};  //!< Bytes discarded with the oldest buffers
+        uint32_t blocked{};        //!< Appends that waited for the writer
+        uint32_t written{};        //!< Buffers written
+        uint32_t errors{};         //!< Buffers the backend failed to write
+        uint32_t max_write_us{};   //!< Longest write of a buffer (us)
+        uint32_t max_append_us{};  //!< Longest append, including the waiting (us)
+        uint8_t max_queued{};      //!< Most buffers waiting to be written
+    };
+
+    AsyncLog() = default;
+    explicit AsyncLog(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+    ~AsyncLog();
+    AsyncLog(const AsyncLog&)            = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    /*!
+      @brief Set the configration
+      @note Applied at the next begin()
+     */
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Allocate the buffers and start the writer thread
+      @param backend Storage, kept until end()
+      @return True if successful
+     */
+    bool begin(LogBackend& backend);
+    //! @brief Write what is buffered, stop the writer thread and free the buffers
+    void end();
+    //! @brief Is it begun?
+    inline bool isBegun() const
+    {
+        return _backend != nullptr;
+    }
+
+    /*!
+      @brief Append the record
+      @param data Bytes
+      @param len Length
+      @return True if appended, false if refused or not begun
+     */
+    bool append(const uint8_t* data, const size_t len);
+    /*!
+      @brief Hand the partly filled buffer to the writer
+      @param wait Wait until the buffers are written and synced
+     */
+    void flush(const bool wait = false);
+
+    //! @brief Bytes that can be appended without overflow
+    size_t room() const;
+    //! @brief Is there room for the longest record so far?
+    bool ready() const;
+    //! @brief Counters
+    stats_t stats() const;
+
+    //! @brief Pipeline sink of Bytes
+    template <typename Next>
+    inline bool push(const Bytes& bytes, Next&& next)
+    {
+        const bool ok = append(bytes.data, bytes.size);
+        return next(bytes) && ok;
+    }
+
+protected:
+    void writer();
+    size_t room_locked() const;
+
+private:
+    config_t _cfg{};
+    LogBackend* _backend{};
+    std::unique_ptr<uint8_t[]> _memory{};
+    std::vector<uint8_t*> _buffers{};
+    std::vector<uint32_t> _lengths{};  // Bytes in each buffer
+    std::vector<uint8_t> _free{}, _queue{};
+    int16_t _active{-1};  // Buffer being filled, -1 if none
+    bool _writing{}, _stop{}, _sync{};
+    size_t _largest{};
+    std::thread _thread{};
+    mutable std::mutex _mutex{};
+    std::condition_variable _work{}, _done{};
+    stats_t _stats{};
+};
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
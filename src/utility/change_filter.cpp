@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file change_filter.cpp
+  @brief Dead-band and deduplication of the published samples
+*/
+#include "change_filter.hpp"
+#include <cmath>
+#include <cstring>
+#include <new>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+void ChangeFilter::reset()
+{
+    _has_published = false;
+    _stats         = stats_t{};
+}
+
+bool ChangeFilter::publish(const uint32_t time, std::initializer_list<float> values, const uint16_t* pixels,
+                           const uint16_t count)
+{
+    const bool compare_pixels = _cfg.pixel_band && pixels && count;
+    if (compare_pixels && count != _pixel_count) {
+        _pixels.reset(new (std::nothrow) uint16_t[count]);
+        _pixel_count   = _pixels ? count : 0;
+        _has_published = false;  // Nothing to compare with
+    }
+
+    // Without the pixels to compare with (allocation failed) every sample is published
+    bool changed{!_has_published || !enabled() || (compare_pixels && !_pixel_count)};
+    if (!changed && _cfg.dead_band == _cfg.dead_band) {
+        uint8_t i{};
+        for (auto v : values) {
+            if (i >= max_values) {
+                break;
+            }
+            // A value turning NaN or back is a change
+            const float last = _values[i++];
+            if ((v != v) != (last != last) || std::fabs(v - last) > _cfg.dead_band) {
+                changed = true;
+                break;
+            }
+        }
+    }
+    if (!changed && compare_pixels && _pixel_count) {
+        // Each pixel against its last published value, so noise within the band is never a change
+        uint32_t over{};
+        for (uint_fast16_t i = 0; i < count; ++i) {
+            const int32_t d = (int32_t)pixels[i] - _pixels[i];
+            if ((d < 0 ? -d : d) > _cfg.pixel_band && ++over > _cfg.pixel_limit) {
+                changed = true;
+                break;
+            }
+        }
+    }
+
+    const bool beat = !changed && _cfg.heartbeat && time - _published_at >= _cfg.heartbeat;
+    if (!changed && !beat) {
+        ++_stats.suppressed;
+        return false;
+    }
+
+    uint8_t i{};
+    for (auto v : values) {
+        if (i >= max_values) {
+            break;
+        }
+        _values[i++] = v;
+    }
+    if (compare_pixels && _pixel_count) {
+        std::memcpy(_pixels.get(), pixels, count * sizeof(uint16_t));
+    }
+    _published_at  = time;
+    _has_published = true;
+    ++_stats.published;
+    _stats.heartbeat += beat;
+    return true;
+}
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
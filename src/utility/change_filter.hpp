@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file change_filter.hpp
+  @brief Dead-band and deduplication of the published samples
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_CHANGE_FILTER_HPP
+#define M5_UNIT_THERMO_UTILITY_CHANGE_FILTER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+/*!
+  @class ChangeFilter
+  @brief Decides whether a sample is worth publishing
+  @details A sample is published when
+  - any of its values moved more than dead_band from the value last published
+  - more than pixel_limit of its pixels moved more than pixel_band from the pixels last published
+  - heartbeat has passed since the last published sample
+  Otherwise it is suppressed and counted. With the default settings every sample is published
+  @code
+  ChangeFilter::config_t cfg{};
+  cfg.dead_band = 0.1f;   // Celsius
+  cfg.heartbeat = 10000;  // At least every 10 seconds
+  ChangeFilter filter{cfg};
+  if (filter.publish(millis(), {celsius})) {
+      send(celsius);
+  }
+  @endcode
+ */
+class ChangeFilter {
+public:
+    //! Values of a sample compared
+    static constexpr uint8_t max_values{4};
+
+    /*!
+      @struct config_t
+      @brief Change filter settings
+     */
+    struct config_t {
+        //! Publish when a value moved more than this from the last published one (NaN: every sample)
+        float dead_band{std::numeric_limits<float>::quiet_NaN()};
+        //! Publish when a pixel moved more than this (raw) from the last published pixels (0: not compared)
+        uint16_t pixel_band{0};
+        //! Pixels allowed to move more than pixel_band before the sample is published
+        uint16_t pixel_limit{0};
+        //! Publish at least this often even if nothing changed (ms, 0: no heartbeat)
+        uint32_t heartbeat{0};
+    };
+
+    /*!
+      @struct stats_t
+      @brief Counters since reset()
+     */
+    struct stats_t {
+        uint32_t published{};   //!< Samples published
+        uint32_t suppressed{};  //!< Samples suppressed
+        uint32_t heartbeat{};   //!< Samples published only by the heartbeat
+    };
+
+    ChangeFilter() = default;
+    explicit ChangeFilter(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    /*!
+      @brief Set the configration
+      @note Resets the filter
+     */
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+        reset();
+    }
+    //! @brief Does the filter suppress anything?
+    inline bool enabled() const
+    {
+        return _cfg.dead_band == _cfg.dead_band || _cfg.pixel_band;
+    }
+    ///@}
+
+    //! @brief Forget the last published sample and the counters, the next sample is published
+    void reset();
+
+    /*!
+      @brief Should the sample be published?
+      @param time Time (ms)
+      @param values Values compared with the dead band, up to max_values
+      @param pixels Pixels compared with the pixel band if config_t::pixel_band (nullptr: none)
+      @param count Number of pixels
+      @return True if published, the sample becomes the last published one
+      @note The last published pixels are copied to the heap on the first call
+     */
+    bool publish(const uint32_t time, std::initializer_list<float> values, const uint16_t* pixels = nullptr,
+                 const uint16_t count = 0);
+
+    //! @brief Counters
+    inline const stats_t& stats() const
+    {
+        return _stats;
+    }
+
+private:
+    config_t _cfg{};
+    float _values[max_values]{};
+    std::unique_ptr<uint16_t[]> _pixels{};  // Last published
+    uint16_t _pixel_count{};
+    uint32_t _published_at{};
+    bool _has_published{};
+    stats_t _stats{};
+};
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,265 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file events.hpp
+  @brief Subscriptions to the events of a unit
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_EVENTS_HPP
+#define M5_UNIT_THERMO_UTILITY_EVENTS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+/*!
+  @class EventSource
+  @brief Handlers of an event of a unit
+  @tparam T Value of the event
+  @details Direct handlers are called from update() with a reference to the value where the unit keeps it,
+  such as the slot of the ring buffer, valid until the handler returns.
+  Deferred handlers get a copy through a queue, called by dispatch() from another task.
+  When the queue is full the event is dropped for the deferred handlers and counted
+  @code
+  unit.onData().subscribe([](const thermal2::Data& d) { frame.merge(d.raw, d.subpage); });
+  unit.onButton().subscribeDeferred([](const uint8_t& bs) { ui.toggle(); }, 4);
+  // Another task
+  for (;;) {
+      unit.onButton().dispatch();
+  }
+  @endcode
+  @note Subscribe and unsubscribe from the task that calls update() or from the handlers
+ */
+template <typename T>
+class EventSource {
+public:
+    using handler_t = std::function<void(const T&)>;
+
+    /*!
+      @struct stats_t
+      @brief Counters
+     */
+    struct stats_t {
+        uint32_t emitted{};     //!< Events
+        uint32_t deferred{};    //!< Events queued for the deferred handlers
+        uint32_t dropped{};     //!< Events dropped for the deferred handlers, the queue was full
+        uint32_t dispatched{};  //!< Events passed to the deferred handlers
+    };
+
+    /*!
+      @brief Call the handler from update()
+      @return Subscription id, 0 if failed
+     */
+    uint16_t subscribe(handler_t handler)
+    {
+        return handler ? _direct.add(next_id(), std::move(handler)) : 0;
+    }
+    /*!
+      @brief Call the handler from dispatch()
+      @param handler Handler
+      @param capacity Events the queue keeps, the largest of the deferred handlers is used
+      @return Subscription id, 0 if failed
+     */
+    uint16_t subscribeDeferred(handler_t handler, const size_t capacity = 4)
+    {
+        if (!handler || !capacity) {
+            return 0;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (capacity > _queue.size()) {
+                // Keep the queued events in order
+                std::vector<T> q(capacity);
+                for (size_t i = 0; i < _size; ++i) {
+                    q[i] = _queue[(_head + i) % _queue.size()];
+                }
+                _queue.swap(q);
+                _head = 0;
+            }
+        }
+        std::lock_guard<std::recursive_mutex> lock(_deferred_mutex);
+        const auto id = _deferred.add(next_id(), std::move(handler));
+        _has_deferred = true;
+        return id;
+    }
+    //! @brief Remove the subscription, also from a handler
+    bool unsubscribe(const uint16_t id)
+    {
+        if (_direct.remove(id)) {
+            return true;
+        }
+        std::lock_guard<std::recursive_mutex> lock(_deferred_mutex);
+        if (_deferred.remove(id)) {
+            _has_deferred = _deferred.count != 0;
+            return true;
+        }
+        return false;
+    }
+    //! @brief Are there any handlers?
+    inline bool subscribed() const
+    {
+        return _direct.count || _has_deferred;
+    }
+
+    /*!
+      @brief Call the direct handlers and queue the value for the deferred ones
+      @note Called by the unit
+     */
+    void emit(const T& value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_stats.emitted;
+        }
+        _direct.call(value);
+        if (_has_deferred) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_size < _queue.size()) {
+                _queue[(_head + _size++) % _queue.size()] = value;
+                ++_stats.deferred;
+            } else {
+                ++_stats.dropped;
+            }
+        }
+    }
+
+    /*!
+      @brief Call the deferred handlers with the queued events
+      @param max Events at most
+      @return Events dispatched
+      @note Call from one task only
+     */
+    size_t dispatch(const size_t max = SIZE_MAX)
+    {
+        size_t n{};
+        while (n < max) {
+            T value{};
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_size) {
+                    break;
+                }
+                value = _queue[_head];
+                _head = (_head + 1) % _queue.size();
+                --_size;
+                ++_stats.dispatched;
+            }
+            std::lock_guard<std::recursive_mutex> lock(_deferred_mutex);
+            _deferred.call(value);
+            ++n;
+        }
+        return n;
+    }
+    //! @brief Events waiting for dispatch()
+    size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _size;
+    }
+    //! @brief Counters
+    stats_t stats() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stats;
+    }
+
+protected:
+    struct subscription_t {
+        uint16_t id{};
+        handler_t handler{};
+        bool removed{};
+    };
+    // Handlers, (un)subscribing while they are called is kept aside until the call returns.
+    // A removed handler may still be running, so it is only marked until then
+    struct handlers_t {
+        std::vector<subscription_t> subscriptions{}, added{};
+        uint16_t count{};
+        uint8_t calling{};
+
+        uint16_t add(const uint16_t id, handler_t&& handler)
+        {
+            subscription_t s{};
+            s.id      = id;
+            s.handler = std::move(handler);
+            // Not into the vector a handler is running from, called from the next event
+            (calling ? added : subscriptions).push_back(std::move(s));
+            ++count;
+            return id;
+        }
+        bool remove(const uint16_t id)
+        {
+            for (auto* v : {&subscriptions, &added}) {
+                for (auto& s : *v) {
+                    if (s.id == id && !s.removed) {
+                        s.removed = true;
+                        --count;
+                        compact();
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+        void call(const T& value)
+        {
+            ++calling;
+            for (size_t i = 0; i < subscriptions.size(); ++i) {
+                if (!subscriptions[i].removed) {
+                    subscriptions[i].handler(value);
+                }
+            }
+            --calling;
+            compact();
+        }
+        void compact()
+        {
+            if (calling || (count == subscriptions.size() && added.empty())) {
+                return;
+            }
+            size_t j{};
+            for (size_t i = 0; i < subscriptions.size(); ++i) {
+                if (!subscriptions[i].removed) {
+                    subscriptions[j++] = std::move(subscriptions[i]);
+                }
+            }
+            subscriptions.resize(j);
+            for (auto& s : added) {
+                if (!s.removed) {
+                    subscriptions.push_back(std::move(s));
+                }
+            }
+            added.clear();
+        }
+    };
+
+    inline uint16_t next_id()
+    {
+        _next_id = _next_id ? _next_id : 1;
+        return _next_id++;
+    }
+
+private:
+    handlers_t _direct{};
+    handlers_t _deferred{};  // Guarded by _deferred_mutex, called from dispatch()
+    std::recursive_mutex _deferred_mutex{};
+    std::atomic<bool> _has_deferred{};
+    uint16_t _next_id{1};
+    mutable std::mutex _mutex{};  // Guards the queue and the counters
+    std::vector<T> _queue{};
+    size_t _head{}, _size{};
+    stats_t _stats{};
+};
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,420 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file pipeline.hpp
+  @brief Compile-time pipeline of stages and sinks for measurement data
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_PIPELINE_HPP
+#define M5_UNIT_THERMO_UTILITY_PIPELINE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+/*!
+  @struct Bytes
+  @brief Encoded bytes passed to the byte sinks
+ */
+struct Bytes {
+    const uint8_t* data{};  //!< Bytes
+    size_t size{};          //!< Length
+
+    Bytes() = default;
+    Bytes(const uint8_t* d, const size_t len) : data{d}, size{len}
+    {
+    }
+};
+
+///@cond
+namespace detail {
+template <typename E>
+auto ready_of(const E& e, int) -> decltype(e.ready())
+{
+    return e.ready();
+}
+template <typename E>
+bool ready_of(const E&, long)
+{
+    return true;
+}
+
+template <typename F, typename T>
+auto call_of(F& f, const T& v, int) -> typename std::enable_if<std::is_same<decltype(f(v)), bool>::value, bool>::type
+{
+    return f(v);
+}
+template <typename F, typename T>
+bool call_of(F& f, const T& v, long)
+{
+    f(v);
+    return true;
+}
+
+template <typename P>
+auto free_of(P& p, int) -> decltype((size_t)p.availableForWrite())
+{
+    return p.availableForWrite();
+}
+template <typename P>
+size_t free_of(P&, long)
+{
+    return std::numeric_limits<size_t>::max();
+}
+}  // namespace detail
+///@endcond
+
+/*!
+  @class Pipeline
+  @brief Chain of stages and sinks, resolved at compile time
+  @tparam Elements Stages and sinks in order
+  @details An element has
+  @code
+  template <typename T, typename Next>
+  bool push(const T& value, Next&& next);  // Pass values on with next(out), false if refused
+  bool ready() const;                      // Optional, can it take a value now?
+  @endcode
+  Every call is resolved by the compiler, so an element not in the list costs nothing and
+  a value of the wrong type for an element is a compile error.
+  Sinks pass the value on too, so that a chain can end in several sinks.
+  When a sink is slow ready() is false, leave the data in the ring buffer of the unit until it is true
+  @code
+  auto pipeline = make_pipeline(filter([](const Data& d) { return !d.torn; }),
+                                callback([](const Data& d) { draw(d); }));
+  while (unit.available() && pipeline.ready()) {
+      pipeline.push(unit.oldest());
+      unit.discard();
+  }
+  @endcode
+ */
+template <typename... Elements>
+class Pipeline {
+public:
+    /*!
+      @struct stats_t
+      @brief Counters
+     */
+    struct stats_t {
+        uint32_t pushed{};   //!< Values pushed
+        uint32_t refused{};  //!< Values an element refused
+    };
+
+    Pipeline() = default;
+    explicit Pipeline(Elements... elements) : _elements{std::move(elements)...}
+    {
+    }
+
+    /*!
+      @brief Push the value through the chain
+      @return False if an element refused it
+     */
+    template <typename T>
+    bool push(const T& value)
+    {
+        ++_stats.pushed;
+        const bool ok = push_at<0>(value);
+        _stats.refused += !ok;
+        return ok;
+    }
+    //! @brief Can every element take a value now?
+    inline bool ready() const
+    {
+        return ready_at<0>();
+    }
+
+    //! @brief The element
+    template <size_t I>
+    inline typename std::tuple_element<I, std::tuple<Elements...>>::type& get()
+    {
+        return std::get<I>(_elements);
+    }
+    //! @brief Counters
+    inline const stats_t& stats() const
+    {
+        return _stats;
+    }
+
+protected:
+    // Passes the output of element I - 1 on to element I
+    template <size_t I>
+    struct next_t {
+        Pipeline* pipeline;
+        template <typename U>
+        inline bool operator()(const U& out) const
+        {
+            return pipeline->template push_at<I>(out);
+        }
+    };
+
+    template <size_t I, typename T>
+    typename std::enable_if<(I < sizeof...(Elements)), bool>::type push_at(const T& value)
+    {
+        return std::get<I>(_elements).push(value, next_t<I + 1>{this});
+    }
+    template <size_t I, typename T>
+    typename std::enable_if<(I == sizeof...(Elements)), bool>::type push_at(const T&)
+    {
+        return true;
+    }
+    template <size_t I>
+    typename std::enable_if<(I < sizeof...(Elements)), bool>::type ready_at() const
+    {
+        return detail::ready_of(std::get<I>(_elements), 0) && ready_at<I + 1>();
+    }
+    template <size_t I>
+    typename std::enable_if<(I == sizeof...(Elements)), bool>::type ready_at() const
+    {
+        return true;
+    }
+
+private:
+    std::tuple<Elements...> _elements{};
+    stats_t _stats{};
+};
+
+//! @brief Make the pipeline of the elements
+template <typename... Elements>
+inline Pipeline<Elements...> make_pipeline(Elements... elements)
+{
+    return Pipeline<Elements...>(std::move(elements)...);
+}
+
+///@name Stages
+///@{
+/*!
+  @class Filter
+  @brief Pass on only the values the predicate is true for
+ */
+template <typename Pred>
+class Filter {
+public:
+    explicit Filter(Pred pred) : _pred{std::move(pred)}
+    {
+    }
+    template <typename T, typename Next>
+    inline bool push(const T& value, Next&& next)
+    {
+        return _pred(value) ? next(value) : true;
+    }
+
+private:
+    Pred _pred;
+};
+template <typename Pred>
+inline Filter<Pred> filter(Pred pred)
+{
+    return Filter<Pred>(std::move(pred));
+}
+
+/*!
+  @class Transform
+  @brief Pass on the result of the function
+ */
+template <typename F>
+class Transform {
+public:
+    explicit Transform(F f) : _f{std::move(f)}
+    {
+    }
+    template <typename T, typename Next>
+    inline bool push(const T& value, Next&& next)
+    {
+        return next(_f(value));
+    }
+
+private:
+    F _f;
+};
+template <typename F>
+inline Transform<F> transform(F f)
+{
+    return Transform<F>(std::move(f));
+}
+
+/*!
+  @class Statistics
+  @brief Minimum, maximum and mean of a value, passed on as it is
+  @tparam F Functor float(const T&) that picks the value
+ */
+template <typename F>
+class Statistics {
+public:
+    explicit Statistics(F f) : _f{std::move(f)}
+    {
+    }
+    template <typename T, typename Next>
+    inline bool push(const T& value, Next&& next)
+    {
+        const float v = _f(value);
+        if (v == v) {  // Not NaN
+            _min = (!_count || v < _min) ? v : _min;
+            _max = (!_count || v > _max) ? v : _max;
+            _sum += v;
+            ++_count;
+        }
+        return next(value);
+    }
+
+    //! @brief Values counted
+    inline uint32_t count() const
+    {
+        return _count;
+    }
+    //! @brief Minimum (NaN if none)
+    inline float minimum() const
+    {
+        return _count ? _min : std::numeric_limits<float>::quiet_NaN();
+    }
+    //! @brief Maximum (NaN if none)
+    inline float maximum() const
+    {
+        return _count ? _max : std::numeric_limits<float>::quiet_NaN();
+    }
+    //! @brief Mean (NaN if none)
+    inline float mean() const
+    {
+        return _count ? (float)(_sum / _count) : std::numeric_limits<float>::quiet_NaN();
+    }
+    //! @brief Forget the values
+    inline void reset()
+    {
+        _count = 0;
+        _sum   = 0;
+    }
+
+private:
+    F _f;
+    uint32_t _count{};
+    float _min{}, _max{};
+    double _sum{};
+};
+template <typename F>
+inline Statistics<F> statistics(F f)
+{
+    return Statistics<F>(std::move(f));
+}
+///@}
+
+///@name Sinks
+///@{
+/*!
+  @class Callback
+  @brief Call the function, refused if it returns false
+ */
+template <typename F>
+class Callback {
+public:
+    explicit Callback(F f) : _f{std::move(f)}
+    {
+    }
+    template <typename T, typename Next>
+    inline bool push(const T& value, Next&& next)
+    {
+        const bool ok = detail::call_of(_f, value, 0);
+        return next(value) && ok;
+    }
+
+private:
+    F _f;
+};
+template <typename F>
+inline Callback<F> callback(F f)
+{
+    return Callback<F>(std::move(f));
+}
+
+/*!
+  @class PortSink
+  @brief Write Bytes to a port such as Serial
+  @tparam Port Type with size_t write(const uint8_t*, size_t), and optionally int availableForWrite()
+  @details Not ready while the port has less room than the largest write expected
+  @warning The room must not exceed the transmit buffer of the port, or the sink is never ready.
+  The Serial of ESP32 Arduino reports only the UART FIFO (128 bytes) for HardwareSerial, or 256 bytes for HWCDC
+  (USB CDC of ESP32-S3/C3), unless setTxBufferSize() was called before begin()
+ */
+template <typename Port>
+class PortSink {
+public:
+    /*!
+      @param port Port
+      @param room Room needed in the transmit buffer to be ready
+     */
+    PortSink(Port& port, const size_t room) : _port{&port}, _room{room}
+    {
+    }
+    //! @brief Has the port room?
+    inline bool ready() const
+    {
+        return detail::free_of(*_port, 0) >= _room;
+    }
+    template <typename Next>
+    inline bool push(const Bytes& bytes, Next&& next)
+    {
+        const bool ok = _port->write(bytes.data, bytes.size) == bytes.size;
+        return next(bytes) && ok;
+    }
+
+private:
+    Port* _port;
+    size_t _room;
+};
+template <typename Port>
+inline PortSink<Port> port_sink(Port& port, const size_t room = 0)
+{
+    return PortSink<Port>(port, room);
+}
+
+/*!
+  @class FileSink
+  @brief Write Bytes to a stdio file, on Linux or on a file system of the ESP32 VFS
+  @details A refused write is taken back, so that the next one starts where it did.
+  Open the file for writing, not for appending
+ */
+class FileSink {
+public:
+    /*!
+      @param fp File opened for writing
+      @param flush Flush after every write, so that a power loss keeps what was written
+     */
+    explicit FileSink(FILE* fp, const bool flush = false) : _fp{fp}, _flush{flush}
+    {
+    }
+    //! @brief Is the file open?
+    inline bool ready() const
+    {
+        return _fp != nullptr;
+    }
+    template <typename Next>
+    inline bool push(const Bytes& bytes, Next&& next)
+    {
+        const size_t n = _fp ? fwrite(bytes.data, 1, bytes.size, _fp) : 0;
+        bool ok        = _fp && n == bytes.size;
+        if (ok && _flush) {
+            ok = fflush(_fp) == 0;
+        }
+        if (!ok && n) {
+            fseek(_fp, -(long)n, SEEK_CUR);
+        }
+        return next(bytes) && ok;
+    }
+
+private:
+    FILE* _fp;
+    bool _flush;
+};
+///@}
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file ready_predictor.cpp
+  @brief Data-ready cadence and phase predictor
+*/
+#include "ready_predictor.hpp"
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+namespace {
+// The millisecond clock wraps at 2^32, so Q8 times are taken modulo 2^40
+constexpr uint32_t time_bits{32 + 8};
+
+inline uint64_t to_q8(const uint32_t ms)
+{
+    return (uint64_t)ms << 8;
+}
+
+// Signed difference a - b of two Q8 times (modulo 2^40)
+inline int64_t elapsed_q8(const uint64_t a, const uint64_t b)
+{
+    return (int64_t)((a - b) << (64 - time_bits)) >> (64 - time_bits);
+}
+}  // namespace
+
+void ReadyPredictor::reset(const uint32_t interval_ms)
+{
+    *this       = ReadyPredictor{_cfg};
+    _nominal_q8 = (interval_ms ? interval_ms : 1) << 8;
+    _period_q8  = _nominal_q8;
+    _backoff_q8 = _cfg.guard_q8;
+}
+
+uint64_t ReadyPredictor::target_q8() const
+{
+    const uint64_t predicted = _ready_q8 + _period_q8;
+    if (_probe) {
+        // Lead by the expected phase uncertainty, not more (every poll inside the lead is a miss)
+        const uint32_t drift = (uint32_t)(_drift_q8 < 0 ? -_drift_q8 : _drift_q8);
+        uint32_t lead        = (_cfg.guard_q8 + drift) << 1;
+        lead                 = lead > (_period_q8 >> 2) ? (_period_q8 >> 2) : lead;
+        return predicted - lead;
+    }
+    return predicted + _cfg.guard_q8;
+}
+
+bool ReadyPredictor::due(const uint32_t now) const
+{
+    // Re-polling within the same millisecond as a miss only adds bus traffic
+    if (_has_miss && elapsed_q8(to_q8(now), _miss_q8) == 0) {
+        return false;
+    }
+    return !_has_ready || elapsed_q8(to_q8(now), target_q8()) >= 0;
+}
+
+uint32_t ReadyPredictor::nextPollAt() const
+{
+    // Round up so that due(nextPollAt()) holds
+    return _has_ready ? (uint32_t)((target_q8() + 255) >> 8) : 0;
+}
+
+void ReadyPredictor::miss(const uint32_t now)
+{
+    ++_stats.polls;
+    ++_stats.misses;
+    _miss_q8  = to_q8(now);
+    _has_miss = true;
+}
+
+void ReadyPredictor::ready(const uint32_t now)
+{
+    ++_stats.polls;
+    const uint64_t now_q8 = to_q8(now);
+
+    if (!_has_ready) {
+        _has_ready = true;
+        if (_has_miss) {
+            _ready_q8  = _miss_q8 + (uint64_t)(elapsed_q8(now_q8, _miss_q8) >> 1);
+            _anchor_q8 = _ready_q8;
+            _brackets  = 1;
+        } else {
+            _ready_q8 = now_q8;
+            _probe    = true;
+        }
+        _has_miss = false;
+        return;
+    }
+
+    // Frames since the previous estimate (frames may have been skipped)
+    const uint32_t k         = frames_between(_ready_q8, now_q8);
+    const uint64_t predicted = _ready_q8 + (uint64_t)k * _period_q8;
+
+    // A miss after the previous ready and close enough to this poll brackets the edge
+    const bool bracketed = _has_miss && elapsed_q8(_miss_q8, _ready_q8) > 0 &&
+                           elapsed_q8(now_q8, _miss_q8) <= (int64_t)(_period_q8 >> 1);
+    _has_miss = false;
+
+    if (bracketed) {
+        const uint64_t est = _miss_q8 + (uint64_t)(elapsed_q8(now_q8, _miss_q8) >> 1);
+        const int64_t err  = elapsed_q8(est, predicted);
+        if (_brackets) {
+            // Period from the span between two bracketed edges, which is far more precise than one frame
+            const int64_t span = elapsed_q8(est, _anchor_q8);
+            const int64_t diff = span / frames_between(_anchor_q8, est) - _period_q8;
+            int64_t p           = (int64_t)_period_q8 + diff / 2;
+            p                   = p < (_nominal_q8 >> 1) ? (_nominal_q8 >> 1) : p;
+            p                   = p > ((int64_t)_nominal_q8 << 1) ? ((int64_t)_nominal_q8 << 1) : p;
+            _period_q8          = (uint32_t)p;
+        }
+        _drift_q8 += (int32_t)((err - _drift_q8) / (1 << _cfg.gain_shift));
+
+        _ready_q8      = est;
+        _anchor_q8     = est;
+        _backoff_q8    = _cfg.guard_q8;
+        _since_bracket = 0;
+        _probe         = false;
+        ++_brackets;
+        return;
+    }
+
+    if (elapsed_q8(predicted, now_q8) > 0) {
+        // Data was ready earlier than predicted, only the upper bound is known
+        _drift_q8 += (int32_t)((elapsed_q8(now_q8, predicted) - _drift_q8) / (1 << _cfg.gain_shift));
+
+        // Step back exponentially until a probe misses and brackets the edge again
+        _ready_q8      = now_q8 - _backoff_q8;
+        _backoff_q8    = (_backoff_q8 << 1) > (_period_q8 >> 2) ? (_period_q8 >> 2) : (_backoff_q8 << 1);
+        _since_bracket = 0;
+        _probe         = true;
+        ++_stats.probes;
+        return;
+    }
+
+    // No information beyond the prediction itself
+    _ready_q8 = predicted;
+    // Probe more often until the period is trusted, so that frame counting between edges stays unambiguous
+    const uint32_t span = (_brackets < 5) ? (1U << _brackets) : _cfg.probe_every;
+    _probe              = (++_since_bracket >= (span < _cfg.probe_every ? span : _cfg.probe_every));
+    if (_probe) {
+        _since_bracket = 0;
+        ++_stats.probes;
+    }
+}
+
+uint32_t ReadyPredictor::frames_between(const uint64_t from_q8, const uint64_t to_q8) const
+{
+    const int64_t elapsed = elapsed_q8(to_q8, from_q8);
+    const uint32_t k      = elapsed > 0 ? (uint32_t)(((uint64_t)elapsed + (_period_q8 >> 1)) / _period_q8) : 1;
+    return k ? k : 1;
+}
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file ready_predictor.hpp
+  @brief Data-ready cadence and phase predictor
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_READY_PREDICTOR_HPP
+#define M5_UNIT_THERMO_UTILITY_READY_PREDICTOR_HPP
+
+#include <cstdint>
+
+namespace m5 {
+namespace unit {
+/*!
+  @namespace thermo
+  @brief Host-side processing helpers for M5Unit-THERMO
+ */
+namespace thermo {
+
+/*!
+  @class ReadyPredictor
+  @brief Learns when a sensor's data becomes ready
+  @details The predictor is fed with the result of every status poll.
+  A poll that found nothing followed by one that found data brackets the ready instant,
+  which corrects both the phase and the period.
+  Without a bracket only an upper bound is known, so an early probe poll is scheduled periodically to re-acquire the
+  edge
+  @note Times are in milliseconds and handled in 64-bit Q8 fixed point internally.
+  Wrap-around of the millisecond clock is tolerated, as are arbitrarily long gaps between polls (up to ~24 days)
+ */
+class ReadyPredictor {
+public:
+    /*!
+      @struct config_t
+      @brief Predictor settings
+     */
+    struct config_t {
+        //! Poll this long after the predicted ready instant (ms, Q8)
+        uint32_t guard_q8{256};
+        //! Frames between early probe polls without a bracketing miss
+        uint32_t probe_every{16};
+        //! Correction gain as a right shift (1/8 by default)
+        uint8_t gain_shift{3};
+    };
+
+    /*!
+      @struct stats_t
+      @brief Poll counters
+     */
+    struct stats_t {
+        uint32_t polls{};   //!< Status polls
+        uint32_t misses{};  //!< Polls that found no data
+        uint32_t probes{};  //!< Early probe polls scheduled
+    };
+
+    ReadyPredictor() = default;
+    explicit ReadyPredictor(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    //! @brief Set the configration
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+    }
+    ///@}
+
+    /*!
+      @brief Forget everything learned and start from the nominal interval
+      @param interval_ms Nominal data interval (ms)
+     */
+    void reset(const uint32_t interval_ms);
+
+    /*!
+      @brief Is it time to poll the status?
+      @param now Current time (ms)
+      @return True if a poll should be issued
+      @note Stays true after a miss, so the next update polls again
+     */
+    bool due(const uint32_t now) const;
+    //! @brief Time of the next scheduled poll (ms)
+    uint32_t nextPollAt() const;
+
+    //! @brief Notify that the poll at @a now found no data
+    void miss(const uint32_t now);
+    //! @brief Notify that the poll at @a now found data
+    void ready(const uint32_t now);
+
+    ///@name Estimation
+    ///@{
+    //! @brief Learned period (ms)
+    inline float period() const
+    {
+        return _period_q8 / 256.0f;
+    }
+    //! @brief Learned period (ms, Q8)
+    inline uint32_t periodQ8() const
+    {
+        return _period_q8;
+    }
+    /*!
+      @brief Smoothed phase drift (ms)
+      @note Positive if data becomes ready later than predicted
+     */
+    inline float drift() const
+    {
+        return _drift_q8 / 256.0f;
+    }
+    //! @brief Is the ready edge bracketed at least twice?
+    inline bool locked() const
+    {
+        return _brackets >= 2;
+    }
+    //! @brief Gets the poll counters
+    inline const stats_t& stats() const
+    {
+        return _stats;
+    }
+    ///@}
+
+protected:
+    uint64_t target_q8() const;
+    uint32_t frames_between(const uint64_t from_q8, const uint64_t to_q8) const;
+
+private:
+    config_t _cfg{};
+    stats_t _stats{};
+    uint32_t _nominal_q8{}, _period_q8{};
+    uint64_t _ready_q8{}, _miss_q8{}, _anchor_q8{};
+    uint32_t _backoff_q8{};
+    int32_t _drift_q8{};
+    uint32_t _since_bracket{}, _brackets{};
+    bool _has_ready{}, _has_miss{}, _probe{};
+};
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file running_statistics.cpp
+  @brief Summary statistics over a sliding window without storing the samples
+*/
+#include "running_statistics.hpp"
+#include <cmath>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+namespace {
+constexpr float nan_value{std::numeric_limits<float>::quiet_NaN()};
+}  // namespace
+
+void RunningStatistics::extremes_t::push(const uint32_t s, const float v, const bool greater)
+{
+    // Drop the values the new one outlives and dominates
+    while (size) {
+        const float back = value[(head + size - 1) % blocks];
+        if (greater ? back > v : back < v) {
+            break;
+        }
+        --size;
+    }
+    const uint8_t tail = (head + size) % blocks;
+    seq[tail]          = s;
+    value[tail]        = v;
+    ++size;
+}
+
+void RunningStatistics::extremes_t::expire(const uint32_t oldest)
+{
+    while (size && (int32_t)(seq[head] - oldest) < 0) {
+        head = (head + 1) % blocks;
+        --size;
+    }
+}
+
+void RunningStatistics::reset()
+{
+    const uint32_t window = _cfg.window ? _cfg.window : 1;
+    _block_len            = (window + blocks - 1) / blocks;
+    _keep                 = (window + _block_len - 1) / _block_len - 1;  // The open block makes up the rest
+    _head = _size = 0;
+    _open         = block_t{};
+    _seq          = 0;
+    _min          = extremes_t{};
+    _max          = extremes_t{};
+    _alpha        = 2.0f / ((_cfg.ewma_window ? _cfg.ewma_window : window) + 1.0f);
+    _ewma         = nan_value;
+    _total        = 0;
+}
+
+void RunningStatistics::push(const float v)
+{
+    if (v != v) {
+        return;
+    }
+    if (_open.count >= _block_len) {
+        close_block();
+    }
+    // Welford
+    ++_open.count;
+    const double d = v - _open.mean;
+    _open.mean += d / _open.count;
+    _open.m2 += d * (v - _open.mean);
+    _open.minimum = (_open.count == 1 || v < _open.minimum) ? v : _open.minimum;
+    _open.maximum = (_open.count == 1 || v > _open.maximum) ? v : _open.maximum;
+
+    _ewma = _total ? _ewma + _alpha * (v - _ewma) : v;
+    ++_total;
+}
+
+void RunningStatistics::close_block()
+{
+    if (_keep) {
+        _closed[(_head + _size) % blocks] = _open;
+        if (_size < _keep) {
+            ++_size;
+        } else {
+            _head = (_head + 1) % blocks;
+        }
+        _min.push(_seq, _open.minimum, false);
+        _max.push(_seq, _open.maximum, true);
+        ++_seq;
+        const uint32_t oldest = _seq - _size;
+        _min.expire(oldest);
+        _max.expire(oldest);
+    }
+    _open = block_t{};
+}
+
+uint32_t RunningStatistics::count() const
+{
+    uint32_t n{_open.count};
+    for (uint8_t i = 0; i < _size; ++i) {
+        n += _closed[(_head + i) % blocks].count;
+    }
+    return n;
+}
+
+float RunningStatistics::mean() const
+{
+    const uint32_t n = count();
+    if (!n) {
+        return nan_value;
+    }
+    double sum{_open.mean * _open.count};
+    for (uint8_t i = 0; i < _size; ++i) {
+        const auto& b = _closed[(_head + i) % blocks];
+        sum += b.mean * b.count;
+    }
+    return (float)(sum / n);
+}
+
+float RunningStatistics::variance() const
+{
+    // Merge the blocks (Chan et al.)
+    block_t m = _open;
+    for (uint8_t i = 0; i < _size; ++i) {
+        const auto& b    = _closed[(_head + i) % blocks];
+        const uint32_t n = m.count + b.count;
+        const double d   = b.mean - m.mean;
+        m.m2 += b.m2 + d * d * ((double)m.count * b.count / n);
+        m.mean += d * b.count / n;
+        m.count = n;
+    }
+    return m.count > 1 ? (float)(m.m2 / (m.count - 1)) : nan_value;
+}
+
+float RunningStatistics::stddev() const
+{
+    const float v = variance();
+    return v == v ? std::sqrt(v) : nan_value;
+}
+
+float RunningStatistics::minimum() const
+{
+    if (!_open.count) {
+        return _min.size ? _min.front() : nan_value;
+    }
+    return (_min.size && _min.front() < _open.minimum) ? _min.front() : _open.minimum;
+}
+
+float RunningStatistics::maximum() const
+{
+    if (!_open.count) {
+        return _max.size ? _max.front() : nan_value;
+    }
+    return (_max.size && _max.front() > _open.maximum) ? _max.front() : _open.maximum;
+}
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
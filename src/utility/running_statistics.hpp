@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file running_statistics.hpp
+  @brief Summary statistics over a sliding window without storing the samples
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_RUNNING_STATISTICS_HPP
+#define M5_UNIT_THERMO_UTILITY_RUNNING_STATISTICS_HPP
+
+#include <cstdint>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+/*!
+  @class RunningStatistics
+  @brief Mean, variance, minimum, maximum and EWMA of the latest samples
+  @details The window is split into blocks, each summarised by Welford's count, mean and sum of squared
+  differences and by its minimum and maximum. A sample only updates the open block, O(1).
+  Closed blocks enter monotonic queues of their minimum and maximum and leave when the window slides past them,
+  so that minimum() and maximum() are O(1), mean() and variance() merge the blocks.
+  The window is exact up to 16 samples, a longer one moves a block at a time and holds the window give or take
+  window / 16 samples. The memory does not depend on the window
+ */
+class RunningStatistics {
+public:
+    //! Blocks of the window
+    static constexpr uint8_t blocks{16};
+
+    /*!
+      @struct config_t
+      @brief Statistics settings
+     */
+    struct config_t {
+        //! Samples of the window (1 -)
+        uint32_t window{1024};
+        //! Samples of the EWMA time constant, alpha = 2 / (N + 1) (0: same as window)
+        uint32_t ewma_window{0};
+    };
+
+    RunningStatistics()
+    {
+        reset();
+    }
+    explicit RunningStatistics(const config_t& cfg) : _cfg{cfg}
+    {
+        reset();
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    /*!
+      @brief Set the configration
+      @note Resets the statistics
+     */
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+        reset();
+    }
+    ///@}
+
+    //! @brief Forget the samples
+    void reset();
+    /*!
+      @brief Add the sample
+      @param v Value, NaN is ignored
+     */
+    void push(const float v);
+
+    ///@name Statistics of the window
+    ///@{
+    //! @brief Samples in the window
+    uint32_t count() const;
+    //! @brief Mean (NaN if none)
+    float mean() const;
+    //! @brief Sample variance (NaN if less than 2 samples)
+    float variance() const;
+    //! @brief Sample standard deviation (NaN if less than 2 samples)
+    float stddev() const;
+    //! @brief Minimum (NaN if none)
+    float minimum() const;
+    //! @brief Maximum (NaN if none)
+    float maximum() const;
+    ///@}
+
+    //! @brief Exponentially weighted moving average (NaN if none)
+    inline float ewma() const
+    {
+        return _ewma;
+    }
+    //! @brief Samples since reset
+    inline uint32_t total() const
+    {
+        return _total;
+    }
+
+protected:
+    struct block_t {
+        uint32_t count{};
+        double mean{}, m2{};
+        float minimum{}, maximum{};
+    };
+    // Monotonic queue of the extremes of the closed blocks in the window
+    struct extremes_t {
+        uint32_t seq[blocks]{};
+        float value[blocks]{};
+        uint8_t head{}, size{};
+
+        void push(const uint32_t s, const float v, const bool greater);
+        void expire(const uint32_t oldest);
+        inline float front() const
+        {
+            return value[head];
+        }
+    };
+
+    void close_block();
+
+private:
+    config_t _cfg{};
+    uint32_t _block_len{1}, _keep{};  // Samples per block, closed blocks in the window
+    block_t _closed[blocks]{};        // Ring of the closed blocks in the window
+    uint8_t _head{}, _size{};
+    block_t _open{};
+    uint32_t _seq{};  // Blocks closed since reset
+    extremes_t _min{}, _max{};
+    float _alpha{}, _ewma{};
+    uint32_t _total{};
+};
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -0,0 +1,327 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*!
+  @file timeseries.hpp
+  @brief Multi-resolution time-series store with a fixed memory budget
+*/
+#ifndef M5_UNIT_THERMO_UTILITY_TIMESERIES_HPP
+#define M5_UNIT_THERMO_UTILITY_TIMESERIES_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+namespace m5 {
+namespace unit {
+namespace thermo {
+
+/*!
+  @struct TimeSeriesPoint
+  @brief Sample or bucket of samples
+ */
+struct TimeSeriesPoint {
+    uint32_t time{};   //!< Time of the sample or the start of the bucket (ms)
+    float minimum{};   //!< Minimum
+    float maximum{};   //!< Maximum
+    float mean{};      //!< Mean
+    uint32_t count{};  //!< Samples, 0 if none
+
+    TimeSeriesPoint() = default;
+    TimeSeriesPoint(const uint32_t t, const float mn, const float mx, const float mv, const uint32_t n)
+        : time{t}, minimum{mn}, maximum{mx}, mean{mv}, count{n}
+    {
+    }
+};
+
+/*!
+  @class TimeSeries
+  @brief Cascaded rings of samples and of min/max/mean buckets
+  @tparam RawCapacity Samples kept at level 0
+  @tparam BucketCapacity Buckets kept at each higher level
+  @tparam Levels Bucket levels (1 - 6)
+  @details Every sample goes into level 0 and into the open bucket of each level, a bucket closes when a sample
+  falls past its interval, so that append is O(Levels) and the history of a level is BucketCapacity intervals.
+  The memory is all in the object, about RawCapacity * 8 + Levels * BucketCapacity * 20 bytes.
+  Use one store for each value, such as the median, average, highest and lowest of Thermal2
+  @code
+  TimeSeries<512, 360> highest;  // 10s: 1h, 1min: 6h, 10min: 2.5days, 1h: 15days, 6h and 24h: 24.8days
+  highest.append(millis(), d.highestTemperature());
+  TimeSeriesPoint pixels[320];
+  highest.query(now - 3600 * 1000, now, pixels, 320);
+  @endcode
+  @note Times are not decreasing, and may wrap around as millis() does after 49.7 days.
+  Times are compared as offsets from the newest sample, so entries older than max_age are dropped
+  and query ranges are within max_age of the newest sample
+ */
+template <uint16_t RawCapacity, uint16_t BucketCapacity, uint8_t Levels = 4>
+class TimeSeries {
+    static_assert(RawCapacity > 0 && BucketCapacity > 0, "Capacity must be positive");
+    static_assert(Levels >= 1 && Levels <= 6, "Levels must be 1 - 6");
+
+public:
+    //! Age of the oldest entry kept (ms, 2^31 - 1: 24.8 days)
+    static constexpr uint32_t max_age{(uint32_t)std::numeric_limits<int32_t>::max()};
+
+    /*!
+      @struct config_t
+      @brief Store settings
+     */
+    struct config_t {
+        //! Interval of the buckets of each level (ms), increasing
+        uint32_t interval_ms[Levels]{};
+
+        config_t()
+        {
+            constexpr uint32_t defaults[6]{10 * 1000, 60 * 1000, 600 * 1000, 3600 * 1000, 6 * 3600 * 1000,
+                                           24 * 3600 * 1000};
+            for (uint8_t i = 0; i < Levels; ++i) {
+                interval_ms[i] = defaults[i];
+            }
+        }
+    };
+
+    TimeSeries() = default;
+    explicit TimeSeries(const config_t& cfg) : _cfg{cfg}
+    {
+    }
+
+    ///@name Settings
+    ///@{
+    //! @brief Gets the configration
+    inline config_t config() const
+    {
+        return _cfg;
+    }
+    /*!
+      @brief Set the configration
+      @note Clears the store
+     */
+    inline void config(const config_t& cfg)
+    {
+        _cfg = cfg;
+        clear();
+    }
+    ///@}
+
+    //! @brief Forget the samples
+    void clear()
+    {
+        _raw_head = _raw_size = 0;
+        _latest   = 0;
+        for (auto& l : _levels) {
+            l.head = l.size = 0;
+            l.open          = TimeSeriesPoint{};
+        }
+    }
+
+    /*!
+      @brief Add the sample
+      @param time Time (ms), not before the last one
+      @param value Value, NaN is ignored
+     */
+    void append(const uint32_t time, const float value)
+    {
+        if (value != value) {
+            return;
+        }
+        _latest         = time;
+        _raw[_raw_head] = raw_t{time, value};
+        _raw_head       = (_raw_head + 1) % RawCapacity;
+        _raw_size += (_raw_size < RawCapacity);
+
+        for (uint8_t i = 0; i < Levels; ++i) {
+            auto& l            = _levels[i];
+            const uint32_t iv  = _cfg.interval_ms[i] ? _cfg.interval_ms[i] : 1;
+            const uint32_t beg = time - time % iv;
+            if (l.open.count && l.open.time != beg) {
+                close(l);
+            }
+            if (!l.open.count) {
+                l.open = TimeSeriesPoint{beg, value, value, 0.0f, 0};
+                l.sum  = 0;
+            }
+            l.open.minimum = value < l.open.minimum ? value : l.open.minimum;
+            l.open.maximum = value > l.open.maximum ? value : l.open.maximum;
+            l.sum += value;
+            ++l.open.count;
+        }
+        expire();
+    }
+
+    //! @brief Number of entries of the level (0: samples), including the open bucket
+    size_t size(const uint8_t level) const
+    {
+        return level ? (level <= Levels ? _levels[level - 1].size + (_levels[level - 1].open.count != 0) : 0)
+                     : _raw_size;
+    }
+    /*!
+      @brief Entry of the level, oldest first
+      @param level Level (0: samples)
+      @param index Index (0 - size(level) - 1)
+     */
+    TimeSeriesPoint at(const uint8_t level, const size_t index) const
+    {
+        if (!level) {
+            const raw_t& r = _raw[(_raw_head + RawCapacity - _raw_size + index) % RawCapacity];
+            return TimeSeriesPoint{r.time, r.value, r.value, r.value, 1};
+        }
+        const auto& l = _levels[level - 1];
+        if (index >= l.size) {
+            TimeSeriesPoint p = l.open;
+            p.mean            = p.count ? (float)(l.sum / p.count) : 0.0f;
+            return p;
+        }
+        return l.ring[(l.head + BucketCapacity - l.size + index) % BucketCapacity];
+    }
+    //! @brief Is the level full, so that older entries may have been dropped?
+    bool full(const uint8_t level) const
+    {
+        return level ? (level <= Levels && _levels[level - 1].size == BucketCapacity) : _raw_size == RawCapacity;
+    }
+    //! @brief Time of the oldest entry of the level, or the newest sample if none
+    uint32_t oldest(const uint8_t level) const
+    {
+        return size(level) ? at(level, 0).time : _latest;
+    }
+
+    /*!
+      @brief The level to draw the range at the width
+      @details The coarsest level still holding at least one entry per pixel, or a coarser one if the range
+      starts before its oldest entry and the level has lost that history.
+      A range starting before the first sample stays at the level, as every level starts with the first sample
+     */
+    uint8_t level(const uint32_t from, const uint32_t to, const uint16_t width) const
+    {
+        const uint32_t pixel = width ? (to - from) / width : 0;
+        uint8_t lv{};
+        while (lv < Levels && _cfg.interval_ms[lv] <= pixel) {
+            ++lv;
+        }
+        while (lv < Levels && size(lv + 1) && offset(oldest(lv)) > offset(from) &&
+               (full(lv) || oldest(lv) - oldest(lv + 1) > _cfg.interval_ms[lv])) {
+            ++lv;
+        }
+        return lv;
+    }
+
+    /*!
+      @brief Aggregate the range into pixels
+      @details A bucket that starts before from but covers it goes into the first pixel
+      @param from Start time (ms)
+      @param to End time (ms), after from
+      @param[out] out Pixels (width), count 0 where there is no data
+      @param width Pixels
+      @return Level used
+     */
+    uint8_t query(const uint32_t from, const uint32_t to, TimeSeriesPoint* out, const uint16_t width) const
+    {
+        if (!out || !width || offset(to) <= offset(from)) {
+            return 0;
+        }
+        const double span = (double)(to - from) / width;
+        for (uint16_t x = 0; x < width; ++x) {
+            out[x] = TimeSeriesPoint{from + (uint32_t)(span * x), 0.0f, 0.0f, 0.0f, 0};
+        }
+
+        const uint8_t lv = level(from, to, width);
+        const size_t n   = size(lv);
+        // First entry at or after from by binary search, the entries are in time order
+        size_t lo{}, hi{n};
+        while (lo < hi) {
+            const size_t mid = (lo + hi) >> 1;
+            if (offset(at(lv, mid).time) < offset(from)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        // The bucket before may start before from but cover it
+        if (lv && lo && (int64_t)offset(at(lv, lo - 1).time) + _cfg.interval_ms[lv - 1] > offset(from)) {
+            --lo;
+        }
+        int32_t px{-1};
+        double sum{};
+        for (size_t i = lo; i < n; ++i) {
+            const TimeSeriesPoint p = at(lv, i);
+            if (offset(p.time) >= offset(to)) {
+                break;
+            }
+            const int64_t d = (int64_t)offset(p.time) - offset(from);
+            int32_t x       = d > 0 ? (int32_t)(d / span) : 0;
+            x               = x < width ? x : width - 1;
+            if (x != px) {
+                if (px >= 0) {
+                    out[px].mean = (float)(sum / out[px].count);
+                }
+                px  = x;
+                sum = 0;
+            }
+            TimeSeriesPoint& o = out[px];
+            o.minimum          = (!o.count || p.minimum < o.minimum) ? p.minimum : o.minimum;
+            o.maximum          = (!o.count || p.maximum > o.maximum) ? p.maximum : o.maximum;
+            sum += (double)p.mean * p.count;
+            o.count += p.count;
+        }
+        if (px >= 0) {
+            out[px].mean = (float)(sum / out[px].count);
+        }
+        return lv;
+    }
+
+private:
+    struct raw_t {
+        uint32_t time;
+        float value;
+    };
+    struct level_t {
+        TimeSeriesPoint ring[BucketCapacity]{};
+        uint16_t head{}, size{};
+        TimeSeriesPoint open{};  // Bucket being filled
+        double sum{};
+    };
+
+    // Offset from the newest sample, exact for the entries kept and times within max_age
+    inline int32_t offset(const uint32_t time) const
+    {
+        return (int32_t)(time - _latest);
+    }
+
+    // Drop the entries older than max_age, whose offset would be ambiguous
+    void expire()
+    {
+        while (_raw_size && _latest - at(0, 0).time > max_age) {
+            --_raw_size;
+        }
+        for (auto& l : _levels) {
+            while (l.size && _latest - l.ring[(l.head + BucketCapacity - l.size) % BucketCapacity].time > max_age) {
+                --l.size;
+            }
+        }
+    }
+
+    void close(level_t& l)
+    {
+        l.open.mean    = (float)(l.sum / l.open.count);
+        l.ring[l.head] = l.open;
+        l.head         = (l.head + 1) % BucketCapacity;
+        l.size += (l.size < BucketCapacity);
+        l.open.count = 0;
+    }
+
+    config_t _cfg{};
+    raw_t _raw[RawCapacity]{};
+    uint16_t _raw_head{}, _raw_size{};
+    uint32_t _latest{};  // Time of the newest sample
+    level_t _levels[Levels]{};
+};
+
+template <uint16_t RawCapacity, uint16_t BucketCapacity, uint8_t Levels>
+constexpr uint32_t TimeSeries<RawCapacity, BucketCapacity, Levels>::max_age;
+
+}  // namespace thermo
+}  // namespace unit
+}  // namespace m5
+#endif
@@ -13,8 +13,13 @@
 #include <googletest/test_template.hpp>
 #include <googletest/test_helper.hpp>
 #include <unit/unit_Thermal2.hpp>
+#include <thermal2/temporal_filter.hpp>
+#include <thermal2/pixel_health.hpp>
+#include <thermal2/roi.hpp>
+#include <algorithm>
 #include <cmath>
 #include <random>
+#include <vector>
 
 using namespace m5::unit::googletest;
 using namespace m5::unit;
@@ -503,6 +508,10 @@ TEST_P(TestThermal2, Periodic)
     EXPECT_FALSE(unit->empty());
     EXPECT_TRUE(unit->full());
 
+    auto& fs = unit->frameStatistics();
+    EXPECT_GE(fs.received, STORED_SIZE);
+    EXPECT_LE(fs.torn, fs.received);
+
     uint32_t cnt{STORED_SIZE / 2};
     while (cnt-- && unit->available()) {
         auto d = unit->oldest();
@@ -522,6 +531,154 @@ TEST_P(TestThermal2, Periodic)
     EXPECT_FALSE(unit->full());
 }
 
+TEST_P(TestThermal2, NoiseFilter)
+{
+    SCOPED_TRACE(ustr);
+
+    // Mean temporal standard deviation of the subpage 0 pixels (raw) over the frames
+    auto temporal_noise = [this](const uint32_t frames, TemporalFilter* filter) {
+        std::vector<double> sum(subpage_pixels), sum2(subpage_pixels);
+        Frame frame{};
+        uint32_t cnt{};
+        auto timeout_at = m5::utility::millis() + frames * unit->interval() * 4;
+        unit->flush();
+        while (cnt < frames && m5::utility::millis() <= timeout_at) {
+            unit->update();
+            if (!unit->updated()) {
+                continue;
+            }
+            auto d = unit->oldest();
+            unit->discard();
+            frame.merge(d.raw, d.subpage);
+            if (filter) {
+                filter->apply(frame, d.subpage);
+            }
+            if (d.subpage) {
+                continue;
+            }
+            for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+                const double v = frame.raw[subpage_to_frame_index(0, i)];
+                sum[i] += v;
+                sum2[i] += v * v;
+            }
+            ++cnt;
+        }
+        double sd{};
+        for (uint_fast16_t i = 0; cnt && i < subpage_pixels; ++i) {
+            const double mean = sum[i] / cnt;
+            sd += std::sqrt(std::fmax(sum2[i] / cnt - mean * mean, 0.0));
+        }
+        return cnt ? sd / subpage_pixels : 0.0;
+    };
+
+    constexpr uint32_t FRAMES{32};
+    uint8_t level{};
+    EXPECT_TRUE(unit->readNoiseFilterLevel(level));
+
+    EXPECT_TRUE(unit->stopPeriodicMeasurement());
+    EXPECT_TRUE(unit->startPeriodicMeasurement(Refresh::Rate16Hz));
+
+    // Firmware filter levels
+    constexpr uint8_t levels[] = {0, 4, 8, 15};
+    double fw_noise[4]{};
+    for (uint_fast8_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(unit->writeNoiseFilterLevel(levels[i]));
+        fw_noise[i] = temporal_noise(FRAMES, nullptr);
+        EXPECT_GT(fw_noise[i], 0.0);
+        M5_LOGI("Firmware level:%2u noise:%.2f", levels[i], fw_noise[i]);
+    }
+    // Host filter on unfiltered data, against the firmware level of the nearest noise
+    EXPECT_TRUE(unit->writeNoiseFilterLevel(0));
+    for (auto&& alpha : {128, 64, 32}) {
+        TemporalFilter::config_t cfg{};
+        cfg.alpha = (uint16_t)alpha;
+        TemporalFilter tf(cfg);
+        temporal_noise(4, &tf);  // Settle
+        auto sd = temporal_noise(FRAMES, &tf);
+        EXPECT_GT(sd, 0.0);
+        EXPECT_LT(sd, fw_noise[0]);
+        uint_fast8_t nearest{};
+        for (uint_fast8_t i = 1; i < 4; ++i) {
+            nearest = std::fabs(fw_noise[i] - sd) < std::fabs(fw_noise[nearest] - sd) ? i : nearest;
+        }
+        M5_LOGI("Host alpha:%3d noise:%.2f, as firmware level:%2u (%.2f)", alpha, sd, levels[nearest],
+                fw_noise[nearest]);
+    }
+
+    EXPECT_TRUE(unit->writeNoiseFilterLevel(level));
+}
+
+TEST_P(TestThermal2, PixelHealth)
+{
+    SCOPED_TRACE(ustr);
+
+    PixelHealth ph{};
+    ph.mark(0);  // Manual mark is interpolated
+    unit->setPixelHealth(&ph);
+    EXPECT_EQ(unit->pixelHealth(), &ph);
+
+    unit->flush();
+    auto elapsed = test_periodic(unit.get(), STORED_SIZE);
+    EXPECT_NE(elapsed, 0);
+
+    while (unit->available()) {
+        auto d = unit->oldest();
+        EXPECT_LE(d.lowest_temperature, d.median_temperature);
+        EXPECT_LE(d.median_temperature, d.highest_temperature);
+        EXPECT_LE(d.lowest_temperature, d.average_temperature);
+        EXPECT_LE(d.average_temperature, d.highest_temperature);
+        EXPECT_FALSE(d.lowest_diff_x == 0 && d.lowest_diff_y == 0);
+        EXPECT_FALSE(d.highest_diff_x == 0 && d.highest_diff_y == 0);
+        unit->discard();
+    }
+    unit->setPixelHealth(nullptr);
+    EXPECT_EQ(unit->pixelHealth(), nullptr);
+}
+
+TEST_P(TestThermal2, RoiEngine)
+{
+    SCOPED_TRACE(ustr);
+
+    RoiEngine roi{};
+    ASSERT_TRUE(roi.add("all", Rect{0, 0, frame_width, frame_height}));
+    unit->setRoiEngine(&roi);
+    EXPECT_EQ(unit->roiEngine(), &roi);
+
+    // The statistics seen from onData belong to the subpage emitted
+    uint32_t emitted{}, matched{};
+    auto id = unit->onData().subscribe([&](const Data& d) {
+        ++emitted;
+        if (d.roi_sequence && d.roi_sequence == roi.sequence()) {
+            // The frame includes the subpage
+            const auto& s = roi.rois().front().stats;
+            auto mm       = std::minmax_element(d.raw, d.raw + subpage_pixels);
+            matched += (s.count == frame_pixels && s.lowest <= *mm.first && s.highest >= *mm.second);
+        }
+    });
+
+    unit->flush();
+    auto elapsed = test_periodic(unit.get(), STORED_SIZE);
+    EXPECT_NE(elapsed, 0);
+    unit->onData().unsubscribe(id);
+
+    // The first subpage after start has no frame to complete
+    EXPECT_GE(roi.sequence(), STORED_SIZE - 1);
+    EXPECT_GE(matched + 1, emitted);
+    uint32_t latest{};
+    while (unit->available()) {
+        auto d = unit->oldest();
+        if (d.roi_sequence) {
+            EXPECT_GT(d.roi_sequence, latest);
+            latest = d.roi_sequence;
+        }
+        unit->discard();
+    }
+    EXPECT_EQ(latest, roi.sequence());
+
+    unit->setRoiEngine(nullptr);
+    EXPECT_EQ(unit->roiEngine(), nullptr);
+}
+
 TEST_P(TestThermal2, I2CAddress)
 {
     SCOPED_TRACE(ustr);
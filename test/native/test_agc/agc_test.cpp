@@ -0,0 +1,284 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for Agc
+*/
+#include <gtest/gtest.h>
+#include <thermal2/agc.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t room_raw{(22 + 64) * 128};  // 22 celsius
+constexpr uint16_t body_raw{(33 + 64) * 128};  // 33 celsius
+
+// Room with a person in the middle
+void scene(uint16_t* frame, std::mt19937& rng, const float noise = 40.0f)
+{
+    std::normal_distribution<float> n(0.0f, noise);
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            const bool body            = (x >= 12 && x < 20 && y >= 4);
+            const float room           = room_raw + x * 4.0f;  // Slight gradient along the wall
+            frame[y * frame_width + x] = (uint16_t)((body ? body_raw : room) + n(rng));
+        }
+    }
+}
+
+bool monotonic(const Agc& agc)
+{
+    for (uint16_t i = 1; i < agc.size(); ++i) {
+        if (agc.lut()[i] < agc.lut()[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Agc::config_t make_config(const AgcMode mode)
+{
+    Agc::config_t cfg{};
+    cfg.mode         = mode;
+    cfg.smooth_shift = 0;
+    return cfg;
+}
+
+}  // namespace
+
+TEST(Agc, Linear)
+{
+    uint16_t frame[frame_pixels]{};
+    std::mt19937 rng(1);
+    scene(frame, rng);
+    const uint16_t lowest  = *std::min_element(frame, frame + frame_pixels);
+    const uint16_t highest = *std::max_element(frame, frame + frame_pixels);
+
+    Histogram h;
+    h.build(frame);
+    Agc agc(make_config(AgcMode::Linear));
+    EXPECT_TRUE(agc.update(h));
+
+    const int32_t width = 1 << h.config().shift;
+    EXPECT_NEAR(agc.low(), lowest, width);
+    EXPECT_NEAR(agc.high(), highest, width);
+    EXPECT_LE(agc.size(), 1024);
+    EXPECT_TRUE(monotonic(agc));
+    EXPECT_EQ(agc.index(0), 0);
+    EXPECT_EQ(agc.index(0xFFFF), 255);
+    EXPECT_EQ(agc.index(agc.low()), 0);
+    EXPECT_EQ(agc.index(agc.high()), 255);
+
+    // Same as the division of the linear stretch
+    for (uint32_t raw = agc.low(); raw <= agc.high(); raw += 7) {
+        const int32_t expected = (raw - agc.low()) * 255 / (agc.high() - agc.low());
+        EXPECT_NEAR(agc.index(raw), expected, 1) << raw;
+    }
+
+    // Explicit range
+    agc.update(1000, 1100);
+    EXPECT_EQ(agc.high() - agc.low(), agc.config().min_span);  // Widened around the middle
+    EXPECT_LE(agc.low(), 1000);
+    EXPECT_GE(agc.high(), 1100);
+    agc.update(1000, 5000);
+    EXPECT_EQ(agc.index(1000), 0);
+    EXPECT_EQ(agc.index(3000), 128);
+    EXPECT_EQ(agc.index(5000), 255);
+}
+
+TEST(Agc, Percentile)
+{
+    uint16_t frame[frame_pixels]{};
+    std::mt19937 rng(2);
+    scene(frame, rng);
+    // A few very hot pixels (a lamp) must not squash the scene
+    constexpr uint16_t lamp_raw{(90 + 64) * 128};
+    frame[0] = lamp_raw;
+    frame[1] = lamp_raw;
+    frame[2] = lamp_raw;
+
+    Histogram h;
+    h.build(frame);
+    Agc linear(make_config(AgcMode::Linear));
+    Agc clipped(make_config(AgcMode::Percentile));
+    linear.update(h);
+    clipped.update(h);
+
+    EXPECT_GT(linear.high(), lamp_raw - 64);
+    EXPECT_LT(clipped.high(), body_raw + 256);
+    EXPECT_TRUE(monotonic(clipped));
+    // The person is the top of the palette, the lamp saturates
+    EXPECT_GT(clipped.index(body_raw), 200);
+    EXPECT_LT(linear.index(body_raw), 64);
+    EXPECT_EQ(clipped.index(frame[0]), 255);
+}
+
+TEST(Agc, Equalize)
+{
+    uint16_t frame[frame_pixels]{};
+    std::mt19937 rng(3);
+    scene(frame, rng);
+
+    Histogram h;
+    h.build(frame);
+    Agc linear(make_config(AgcMode::Percentile));
+    auto cfg = make_config(AgcMode::Equalize);
+    Agc eq(cfg);
+    cfg.clip_q4 = 0;
+    Agc eq_full(cfg);
+    linear.update(h);
+    eq.update(h);
+    eq_full.update(h);
+
+    EXPECT_TRUE(monotonic(eq));
+    EXPECT_TRUE(monotonic(eq_full));
+    EXPECT_EQ(eq.index(eq.low()), 0);
+    EXPECT_EQ(eq.index(eq.high()), 255);
+
+    // Palette indexes used by the room, equalisation spends more of the palette on the crowded part
+    std::set<uint8_t> used_linear, used_eq, used_full;
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            if (x >= 12 && x < 20 && y >= 4) {
+                continue;
+            }
+            const uint16_t raw = frame[y * frame_width + x];
+            used_linear.insert(linear.index(raw));
+            used_eq.insert(eq.index(raw));
+            used_full.insert(eq_full.index(raw));
+        }
+    }
+    EXPECT_GT(used_eq.size(), used_linear.size());
+    EXPECT_GT(used_full.size(), used_linear.size());
+}
+
+TEST(Agc, Range)
+{
+    // Uniform scene does not stretch the noise over the palette
+    uint16_t frame[frame_pixels]{};
+    std::mt19937 rng(4);
+    std::normal_distribution<float> n(room_raw, 8.0f);
+    for (auto&& v : frame) {
+        v = (uint16_t)n(rng);
+    }
+    Histogram h;
+    h.build(frame);
+    Agc agc(make_config(AgcMode::Percentile));
+    agc.update(h);
+    EXPECT_GE(agc.high() - agc.low(), agc.config().min_span);
+    EXPECT_NEAR(agc.index(room_raw), 128, 24);
+
+    // Smoothing follows a step of the scene gradually
+    auto cfg         = agc.config();
+    cfg.smooth_shift = 2;
+    agc.config(cfg);
+    agc.update(h);
+    const uint16_t before = agc.high();
+    for (auto&& v : frame) {
+        v += 1280;
+    }
+    h.build(frame);
+    agc.update(h);
+    EXPECT_GT(agc.high(), before);
+    EXPECT_LT(agc.high(), before + 1280);
+    for (int i = 0; i < 64; ++i) {
+        agc.update(h);
+    }
+    EXPECT_NEAR(agc.high(), before + 1280, 8);
+
+    // Empty histogram
+    Histogram empty;
+    EXPECT_FALSE(agc.update(empty));
+}
+
+TEST(Agc, Colorize)
+{
+    uint16_t frame[frame_pixels]{};
+    std::mt19937 rng(5);
+    scene(frame, rng);
+    Histogram h;
+    h.build(frame);
+    Agc agc(make_config(AgcMode::Equalize));
+    agc.update(h);
+
+    uint16_t palette[256]{};
+    for (int i = 0; i < 256; ++i) {
+        palette[i] = (uint16_t)(i * 257);
+    }
+    uint16_t colors[Agc::max_entries]{};
+    agc.colorize(colors, palette);
+    uint8_t idx[frame_pixels]{};
+    agc.map(idx, frame, frame_pixels);
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        EXPECT_EQ(colors[agc.entry(frame[i])], palette[idx[i]]);
+        EXPECT_EQ(idx[i], agc.index(frame[i]));
+    }
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Agc, DISABLED_Benchmark)
+{
+    uint16_t frame[frame_pixels]{};
+    std::mt19937 rng(6);
+    scene(frame, rng);
+    Histogram h;
+    h.build(frame);
+    uint16_t palette[256]{};
+    for (auto&& c : palette) {
+        c = (uint16_t)rng();
+    }
+    uint16_t colors[Agc::max_entries]{};
+    uint16_t out[frame_pixels]{};
+    constexpr uint32_t loops{20000};
+    uint32_t guard{};
+
+    for (auto mode : {AgcMode::Percentile, AgcMode::Equalize}) {
+        Agc agc(make_config(mode));
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < loops; ++i) {
+            agc.update(h);
+            agc.colorize(colors, palette);
+            guard += agc.size();
+        }
+        auto elapsed    = std::chrono::high_resolution_clock::now() - start;
+        const double us = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+        printf("%s update+colorize:%.2f us\n", mode == AgcMode::Equalize ? "Equalize  " : "Percentile", us);
+    }
+
+    // Per pixel colour, table lookup against the division of the linear stretch
+    Agc agc(make_config(AgcMode::Percentile));
+    agc.update(h);
+    agc.colorize(colors, palette);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        for (uint_fast16_t p = 0; p < frame_pixels; ++p) {
+            out[p] = colors[agc.entry(frame[p])];
+        }
+        guard += out[i % frame_pixels];
+    }
+    auto elapsed     = std::chrono::high_resolution_clock::now() - start;
+    const double us0 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    volatile int32_t diff = agc.high() - agc.low() + 1;
+    const int32_t lowest  = agc.low();
+    start                 = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        const int32_t d = diff;
+        for (uint_fast16_t p = 0; p < frame_pixels; ++p) {
+            const int32_t v = ((frame[p] - lowest) * 256) / d;
+            out[p]          = palette[(v < 0) ? 0 : (v > 255) ? 255 : v];
+        }
+        guard += out[i % frame_pixels];
+    }
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us1 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+    printf("Frame colours lut:%.2f us division:%.2f us\n", us0, us1);
+    EXPECT_GT(guard, 0U);
+}
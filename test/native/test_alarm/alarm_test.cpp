@@ -0,0 +1,285 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for AlarmEngine
+*/
+#include <gtest/gtest.h>
+#include <utility/alarm.hpp>
+#include <thermal2/roi_alarm.hpp>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace m5::unit::thermo;
+
+namespace {
+
+constexpr float nan_value{std::numeric_limits<float>::quiet_NaN()};
+
+// Temperature at the time: flat, then rising from onset at the rate (per second)
+float ramp(const uint32_t t, const uint32_t onset, const float rate)
+{
+    return 25.0f + (t > onset ? (t - onset) * rate / 1000.0f : 0.0f);
+}
+
+// Time of the first raise on the channel, 0 if none
+uint32_t first_raise(AlarmEngine& alarms, const uint8_t ch, const std::vector<float>& values, const uint32_t step)
+{
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (alarms.push(ch, i * step, values[i]) && alarms.event().raised) {
+            return i * step;
+        }
+    }
+    return 0;
+}
+
+// Heating at 0.2 Celsius per second from 25 after the onset, 5 minutes
+std::vector<float> heating(const uint32_t onset, const uint32_t step)
+{
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 0.2f);
+    std::vector<float> values{};
+    for (uint32_t t = 0; t < 300000; t += step) {
+        values.push_back(ramp(t, onset, 0.2f) + noise(rng));
+    }
+    return values;
+}
+
+// Time each of threshold, rate of rise and CUSUM raised first
+void push_heating(const std::vector<float>& values, const uint32_t step, uint32_t at[3])
+{
+    AlarmEngine::config_t high{}, rise{}, change{};
+    high.high          = 60.0f;
+    rise.rise_rate     = 0.1f;
+    change.cusum_limit = 10.0f;
+    change.cusum_drift = 0.5f;
+
+    AlarmEngine alarms{};
+    const uint8_t ch[3]{alarms.add(high), alarms.add(rise), alarms.add(change)};
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (uint8_t c = 0; c < 3; ++c) {
+            if (alarms.push(ch[c], i * step, values[i]) && alarms.event().raised && !at[c]) {
+                at[c] = i * step;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Alarm, Channels)
+{
+    AlarmEngine alarms{};
+    EXPECT_FALSE(alarms.push(0, 0, 1.0f));
+    AlarmEngine::config_t cfg{};
+    cfg.high = 40.0f;
+    EXPECT_EQ(alarms.add(cfg), 0);
+    EXPECT_EQ(alarms.add(AlarmEngine::config_t{}), 1);
+    EXPECT_EQ(alarms.channels(), 2U);
+    EXPECT_FLOAT_EQ(alarms.config(0).high, 40.0f);
+    EXPECT_TRUE(std::isnan(alarms.config(1).high));
+    EXPECT_FALSE(alarms.config(2, cfg));
+    EXPECT_TRUE(std::isnan(alarms.rate(0)));
+
+    // Channel without conditions never raises
+    for (uint32_t t = 0; t < 100; ++t) {
+        EXPECT_FALSE(alarms.push(1, t * 100, 100.0f));
+    }
+    EXPECT_FALSE(alarms.active(1));
+    alarms.clear();
+    EXPECT_EQ(alarms.channels(), 0U);
+    EXPECT_EQ(alarms.stats().samples, 0U);
+}
+
+TEST(Alarm, Threshold)
+{
+    AlarmEngine alarms{};
+    AlarmEngine::config_t cfg{};
+    cfg.high            = 40.0f;
+    cfg.high_hysteresis = 2.0f;
+    cfg.debounce        = 3;
+    cfg.release         = 2;
+    const auto ch       = alarms.add(cfg);
+
+    // A single spike is debounced
+    EXPECT_FALSE(alarms.push(ch, 0, 39.0f));
+    EXPECT_FALSE(alarms.push(ch, 100, 45.0f));
+    EXPECT_FALSE(alarms.push(ch, 200, 37.0f));  // Below the hysteresis
+    EXPECT_FALSE(alarms.active(ch));
+
+    EXPECT_FALSE(alarms.push(ch, 300, 41.0f));
+    EXPECT_FALSE(alarms.push(ch, 400, 39.5f));  // Within the hysteresis, still above
+    EXPECT_TRUE(alarms.push(ch, 500, 40.5f));
+    EXPECT_TRUE(alarms.active(ch));
+    EXPECT_EQ(alarms.causes(ch), alarm_cause_high);
+    EXPECT_TRUE(alarms.event().raised);
+    EXPECT_EQ(alarms.event().onset, 300U);
+    EXPECT_EQ(alarms.event().latency(), 200U);
+
+    // Chatter around the threshold does not clear it
+    for (uint32_t t = 600; t < 2000; t += 100) {
+        EXPECT_FALSE(alarms.push(ch, t, (t / 100) & 1 ? 39.0f : 40.5f));
+    }
+    EXPECT_FALSE(alarms.push(ch, 2000, 37.0f));
+    EXPECT_TRUE(alarms.push(ch, 2100, 36.0f));
+    EXPECT_FALSE(alarms.active(ch));
+    EXPECT_FALSE(alarms.event().raised);
+    EXPECT_EQ(alarms.causes(ch), 0);
+    EXPECT_EQ(alarms.stats().raised, 1U);
+    EXPECT_EQ(alarms.stats().cleared, 1U);
+    EXPECT_EQ(alarms.stats().max_latency, 200U);
+}
+
+TEST(Alarm, RateOfRise)
+{
+    AlarmEngine alarms{};
+    AlarmEngine::config_t cfg{};
+    cfg.rise_rate   = 0.5f;
+    cfg.rise_window = 8000;
+    cfg.debounce    = 2;
+    const auto ch   = alarms.add(cfg);
+
+    // 16Hz, slow drift for a minute then 1 Celsius per second
+    std::vector<float> values{};
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.2f);
+    for (uint32_t t = 0; t < 120000; t += 62) {
+        values.push_back(ramp(t, 0, 0.01f) + ramp(t, 60000, 1.0f) - 25.0f + noise(rng));
+    }
+    const uint32_t raised = first_raise(alarms, ch, values, 62);
+    ASSERT_GT(raised, 60000U);
+    EXPECT_LT(raised, 60000U + 8000U);
+    EXPECT_EQ(alarms.event().causes, alarm_cause_rise);
+    EXPECT_NEAR(alarms.rate(ch), 1.0f, 0.5f);
+
+    // Flat again clears it
+    for (uint32_t t = 120000; t < 140000; t += 62) {
+        alarms.push(ch, t, 90.0f);
+    }
+    EXPECT_FALSE(alarms.active(ch));
+    EXPECT_NEAR(alarms.rate(ch), 0.0f, 0.05f);
+}
+
+TEST(Alarm, Cusum)
+{
+    AlarmEngine::config_t cfg{};
+    cfg.cusum_limit = 5.0f;
+    cfg.cusum_drift = 0.5f;
+    cfg.debounce    = 1;
+
+    std::mt19937 rng(4);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+
+    // Noise alone for an hour at 4Hz, no false alarm
+    {
+        AlarmEngine alarms{};
+        const auto ch = alarms.add(cfg);
+        for (uint32_t t = 0; t < 3600 * 1000; t += 250) {
+            alarms.push(ch, t, 30.0f + noise(rng));
+        }
+        EXPECT_EQ(alarms.stats().raised, 0U);
+    }
+    // A step of 2 Celsius at 100s
+    {
+        AlarmEngine alarms{};
+        const auto ch = alarms.add(cfg);
+        std::vector<float> values{};
+        for (uint32_t t = 0; t < 200000; t += 250) {
+            values.push_back(30.0f + (t >= 100000 ? 2.0f : 0.0f) + noise(rng));
+        }
+        const uint32_t raised = first_raise(alarms, ch, values, 250);
+        ASSERT_GE(raised, 100000U);
+        EXPECT_LT(raised, 100000U + 2000U);
+        EXPECT_EQ(alarms.event().causes, alarm_cause_change);
+        // The onset is the change point
+        EXPECT_NEAR((double)alarms.event().onset, 100000.0, 750.0);
+        EXPECT_EQ(alarms.event().latency(), raised - alarms.event().onset);
+    }
+    // A step of 2 Celsius at 100s to a plateau raises once and clears
+    {
+        AlarmEngine alarms{};
+        const auto ch = alarms.add(cfg);
+        uint32_t cleared_at{};
+        float max_s{};
+        for (uint32_t t = 0; t < 400000; t += 250) {
+            if (alarms.push(ch, t, 30.0f + (t >= 100000 ? 2.0f : 0.0f) + noise(rng)) && !alarms.event().raised) {
+                cleared_at = t;
+            }
+            max_s = std::fmax(max_s, alarms.cusum(ch));
+        }
+        EXPECT_EQ(alarms.stats().raised, 1U);
+        EXPECT_EQ(alarms.stats().cleared, 1U);
+        EXPECT_FALSE(alarms.active(ch));
+        EXPECT_GT(cleared_at, 100000U);
+        EXPECT_LT(cleared_at, 100000U + 10000U);
+        EXPECT_LE(max_s, cfg.cusum_limit);
+    }
+}
+
+TEST(Alarm, Roi)
+{
+    using namespace m5::unit::thermal2;
+    RoiEngine engine{};
+    EXPECT_TRUE(engine.add("panel", Rect{0, 0, 8, 8}));
+    EXPECT_TRUE(engine.add("motor", Rect{16, 8, 8, 8}));
+
+    AlarmEngine alarms{};
+    AlarmEngine::config_t cfg{};
+    cfg.high = 50.0f;
+    alarms.add(cfg);
+    alarms.add(cfg);
+
+    uint16_t frame[frame_pixels]{};
+    std::vector<std::string> raised{};
+    for (uint32_t i = 0; i < 40; ++i) {
+        for (uint_fast16_t p = 0; p < frame_pixels; ++p) {
+            frame[p] = (25 + 64) * 128;
+        }
+        frame[10 * frame_width + 20] = (uint16_t)((30 + i + 64) * 128);  // Motor heating 1 Celsius per frame
+        engine.process(frame);
+        push_roi_alarms(alarms, engine, i * 500, [&raised](const AlarmEvent& e, const RoiEngine::Roi& r) {
+            if (e.raised) {
+                raised.push_back(r.name);
+            }
+        });
+    }
+    ASSERT_EQ(raised.size(), 1U);
+    EXPECT_EQ(raised[0], "motor");
+    EXPECT_TRUE(alarms.active(1));
+    EXPECT_FALSE(alarms.active(0));
+}
+
+TEST(Alarm, EarlyDetection)
+{
+    // Heating at 0.2 Celsius per second from 25, with a static threshold at 60
+    constexpr uint32_t onset{30000}, step{125};
+    const auto values = heating(onset, step);
+    uint32_t at[3]{};
+    push_heating(values, step, at);
+    ASSERT_TRUE(at[0] && at[1] && at[2]);
+    // Rate of rise and CUSUM raise before the threshold
+    EXPECT_LT(at[1], at[0]);
+    EXPECT_LT(at[2], at[0]);
+    EXPECT_GT(at[1], onset);
+    EXPECT_GT(at[2], onset);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Alarm, DISABLED_Benchmark)
+{
+    constexpr uint32_t onset{30000}, step{125};
+    const auto values = heating(onset, step);
+    uint32_t at[3]{};
+    const auto started = std::chrono::high_resolution_clock::now();
+    push_heating(values, step, at);
+    const auto elapsed_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+    printf("Latency from the onset: threshold %u ms, rate of rise %u ms, CUSUM %u ms, %.1f ns/sample\n", at[0] - onset,
+           at[1] - onset, at[2] - onset, (double)elapsed_ns / (values.size() * 3));
+}
@@ -0,0 +1,354 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for AsyncLog
+*/
+#include <gtest/gtest.h>
+#include <utility/async_log.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace m5::unit::thermo;
+
+namespace {
+
+// Storage that stalls like a page erase every few writes
+struct slow_backend_t : public LogBackend {
+    std::vector<uint8_t> data{};
+    uint32_t stall_ms{}, every{1}, writes{}, syncs{};
+
+    bool write(const uint8_t* d, const size_t len) override
+    {
+        if (stall_ms && (writes++ % every) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(stall_ms));
+        }
+        data.insert(data.end(), d, d + len);
+        return true;
+    }
+    bool sync() override
+    {
+        ++syncs;
+        return true;
+    }
+};
+
+// Storage whose writes do not return until released
+struct gated_backend_t : public LogBackend {
+    std::vector<uint8_t> data{};
+    std::mutex mutex{};
+    std::condition_variable cv{};
+    uint32_t entered{};
+    bool released{};
+
+    bool write(const uint8_t* d, const size_t len) override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++entered;
+        cv.notify_all();
+        cv.wait(lock, [this]() { return released; });
+        data.insert(data.end(), d, d + len);
+        return true;
+    }
+    void wait_entered(const uint32_t n)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this, n]() { return entered >= n; });
+    }
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+        cv.notify_all();
+    }
+};
+
+// Record of the sequence number repeated, so that a cut record is found
+std::vector<uint8_t> make_record(const uint32_t seq, const size_t len)
+{
+    std::vector<uint8_t> r(len);
+    for (size_t i = 0; i < len; ++i) {
+        r[i] = (uint8_t)(seq + i);
+    }
+    std::memcpy(r.data(), &seq, 4);
+    return r;
+}
+
+// Sequence numbers of the whole records, false if a record is broken
+bool parse(const std::vector<uint8_t>& data, const size_t len, std::vector<uint32_t>& seqs)
+{
+    seqs.clear();
+    if (data.size() % len) {
+        return false;
+    }
+    for (size_t pos = 0; pos < data.size(); pos += len) {
+        uint32_t seq{};
+        std::memcpy(&seq, data.data() + pos, 4);
+        if (std::memcmp(data.data() + pos, make_record(seq, len).data(), len)) {
+            return false;
+        }
+        seqs.push_back(seq);
+    }
+    return true;
+}
+
+std::string temp_path()
+{
+    char name[] = "/tmp/async_log_XXXXXX";
+    const int fd = mkstemp(name);
+    if (fd >= 0) {
+        close(fd);
+    }
+    return name;
+}
+
+}  // namespace
+
+TEST(AsyncLog, Settings)
+{
+    slow_backend_t backend{};
+    AsyncLog log{};
+    EXPECT_FALSE(log.isBegun());
+    EXPECT_FALSE(log.append((const uint8_t*)"x", 1));
+
+    auto cfg    = log.config();
+    cfg.buffers = 1;
+    log.config(cfg);
+    EXPECT_FALSE(log.begin(backend));
+    cfg.buffers   = 3;
+    cfg.alignment = 48;
+    log.config(cfg);
+    EXPECT_FALSE(log.begin(backend));
+    cfg.alignment = 512;
+    log.config(cfg);
+    EXPECT_TRUE(log.begin(backend));
+    EXPECT_TRUE(log.isBegun());
+    EXPECT_EQ(log.room(), (size_t)cfg.buffer_size * 3);
+    log.end();
+    EXPECT_FALSE(log.isBegun());
+}
+
+TEST(AsyncLog, File)
+{
+    const auto path = temp_path();
+    PosixFileBackend file{};
+    ASSERT_TRUE(file.open(path.c_str(), false));
+
+    AsyncLog::config_t cfg{};
+    cfg.buffer_size = 1000;  // Records across the buffers
+    cfg.overflow    = AsyncLog::Overflow::Block;
+    AsyncLog log{cfg};
+    ASSERT_TRUE(log.begin(file));
+    constexpr size_t len{77};
+    for (uint32_t i = 0; i < 500; ++i) {
+        EXPECT_TRUE(log.append(make_record(i, len).data(), len));
+    }
+    log.flush(true);
+    EXPECT_EQ(log.stats().records, 500U);
+    EXPECT_EQ(log.stats().bytes, 500U * len);
+    EXPECT_EQ(log.stats().dropped, 0U);
+    EXPECT_EQ(log.stats().errors, 0U);
+    log.end();
+    file.close();
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<uint32_t> seqs{};
+    ASSERT_TRUE(parse(data, len, seqs));
+    ASSERT_EQ(seqs.size(), 500U);
+    for (uint32_t i = 0; i < seqs.size(); ++i) {
+        EXPECT_EQ(seqs[i], i);
+    }
+
+    // Appended to the file
+    ASSERT_TRUE(file.open(path.c_str()));
+    ASSERT_TRUE(log.begin(file));
+    EXPECT_TRUE(log.append(make_record(500, len).data(), len));
+    log.end();
+    file.close();
+    std::ifstream in2(path, std::ios::binary);
+    data.assign((std::istreambuf_iterator<char>(in2)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+    EXPECT_EQ(data.size(), 501U * len);
+}
+
+TEST(AsyncLog, Overflow)
+{
+    constexpr size_t len{100};
+    constexpr uint32_t count{300};
+
+    // Drop newest keeps whole records
+    {
+        slow_backend_t backend{};
+        backend.stall_ms = 20;
+        AsyncLog::config_t cfg{};
+        cfg.buffer_size = 1024;
+        cfg.buffers     = 2;
+        cfg.overflow    = AsyncLog::Overflow::DropNewest;
+        AsyncLog log{cfg};
+        ASSERT_TRUE(log.begin(backend));
+        uint32_t refused{};
+        for (uint32_t i = 0; i < count; ++i) {
+            refused += !log.append(make_record(i, len).data(), len);
+        }
+        log.end();
+        const auto st = log.stats();
+        EXPECT_GT(st.dropped, 0U);
+        EXPECT_EQ(st.dropped, refused);
+        EXPECT_EQ(st.records + st.dropped, count);
+        std::vector<uint32_t> seqs{};
+        ASSERT_TRUE(parse(backend.data, len, seqs));
+        EXPECT_EQ(seqs.size(), st.records);
+        for (size_t i = 1; i < seqs.size(); ++i) {
+            EXPECT_LT(seqs[i - 1], seqs[i]);
+        }
+    }
+    // Drop oldest keeps the latest bytes
+    {
+        slow_backend_t backend{};
+        backend.stall_ms = 20;
+        AsyncLog::config_t cfg{};
+        cfg.buffer_size = 1000;
+        cfg.buffers     = 4;
+        cfg.overflow    = AsyncLog::Overflow::DropOldest;
+        AsyncLog log{cfg};
+        ASSERT_TRUE(log.begin(backend));
+        for (uint32_t i = 0; i < count; ++i) {
+            log.append(make_record(i, len).data(), len);
+        }
+        log.end();
+        const auto st = log.stats();
+        EXPECT_GT(st.dropped_bytes, 0U);
+        EXPECT_EQ(backend.data.size(), st.bytes - st.dropped_bytes);
+        std::vector<uint32_t> seqs{};
+        ASSERT_TRUE(parse(backend.data, len, seqs));  // Buffers hold whole records here
+        EXPECT_EQ(seqs.back(), count - 1);
+    }
+    // Block loses nothing
+    {
+        slow_backend_t backend{};
+        backend.stall_ms = 5;
+        AsyncLog::config_t cfg{};
+        cfg.buffer_size = 1024;
+        cfg.overflow    = AsyncLog::Overflow::Block;
+        AsyncLog log{cfg};
+        ASSERT_TRUE(log.begin(backend));
+        for (uint32_t i = 0; i < count; ++i) {
+            EXPECT_TRUE(log.append(make_record(i, len).data(), len));
+        }
+        // Larger than the room left after a partly filled buffer
+        EXPECT_TRUE(log.append(make_record(count, 2000).data(), 2000));
+        log.end();
+        const auto st = log.stats();
+        EXPECT_EQ(st.dropped, 0U);
+        EXPECT_GT(st.blocked, 0U);
+        EXPECT_EQ(backend.data.size(), count * len + 2000);
+        EXPECT_EQ(backend.syncs, 1U);
+    }
+}
+
+TEST(AsyncLog, Stall)
+{
+    // Subpage packets while the storage is held in a write, like a page erase
+    constexpr size_t len{800};
+    const auto record = make_record(0, len);
+
+    gated_backend_t backend{};
+    AsyncLog::config_t cfg{};
+    cfg.buffer_size = 10 * len;
+    cfg.buffers     = 4;
+    AsyncLog log{cfg};
+    ASSERT_TRUE(log.begin(backend));
+
+    // The first full buffer goes to the storage, which does not return
+    for (uint32_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(log.append(record.data(), len));
+    }
+    backend.wait_entered(1);
+
+    // The other buffers take the records without waiting for it
+    for (uint32_t i = 0; i < 30; ++i) {
+        EXPECT_TRUE(log.append(record.data(), len));
+    }
+    EXPECT_EQ(log.room(), 0U);
+    EXPECT_FALSE(log.ready());
+    EXPECT_FALSE(log.append(record.data(), len));
+    auto st = log.stats();
+    EXPECT_EQ(st.records, 40U);
+    EXPECT_EQ(st.blocked, 0U);
+    EXPECT_EQ(st.dropped, 1U);
+    EXPECT_EQ(st.written, 0U);
+    EXPECT_EQ(st.max_queued, 4U);
+    EXPECT_EQ(backend.entered, 1U);
+
+    // Everything taken is written once the storage returns
+    backend.release();
+    log.end();
+    st = log.stats();
+    EXPECT_EQ(st.written, 4U);
+    EXPECT_EQ(st.errors, 0U);
+    EXPECT_EQ(backend.data.size(), 40 * len);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(AsyncLog, DISABLED_Benchmark)
+{
+    // Subpage packets to a file, written in the loop and through the log
+    constexpr size_t len{800};
+    constexpr uint32_t count{4096};
+    const auto record = make_record(0, len);
+    const auto path   = temp_path();
+
+    PosixFileBackend direct{};
+    ASSERT_TRUE(direct.open(path.c_str(), false));
+    uint32_t direct_max_us{};
+    auto started = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto at = std::chrono::steady_clock::now();
+        EXPECT_TRUE(direct.write(record.data(), len));
+        if ((i & 63) == 63) {
+            direct.sync();  // As often as the log syncs a buffer
+        }
+        direct_max_us = std::max<uint32_t>(
+            direct_max_us,
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - at).count());
+    }
+    const double direct_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    direct.close();
+
+    PosixFileBackend file{};
+    ASSERT_TRUE(file.open(path.c_str(), false));
+    AsyncLog::config_t cfg{};
+    cfg.buffer_size = 64 * len;
+    cfg.buffers     = 4;
+    cfg.overflow    = AsyncLog::Overflow::Block;
+    cfg.sync_each   = true;
+    AsyncLog log{cfg};
+    ASSERT_TRUE(log.begin(file));
+    started = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; ++i) {
+        EXPECT_TRUE(log.append(record.data(), len));
+    }
+    log.end();
+    const double log_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    file.close();
+    std::remove(path.c_str());
+
+    const auto st = log.stats();
+    EXPECT_EQ(st.bytes, (uint64_t)count * len);
+    printf("Write in loop: %.1f ms, max %u us\n", direct_ms, direct_max_us);
+    printf("AsyncLog: %.1f ms, append max %u us, write max %u us, queued max %u, blocked %u\n", log_ms,
+           st.max_append_us, st.max_write_us, st.max_queued, st.blocked);
+}
@@ -0,0 +1,229 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for BackgroundModel
+
+  Replays recorded frames (raw uint16_t little endian, 768 per frame).
+  Set THERMO_REPLAY to the path of a recording to replay it as well
+*/
+#include <gtest/gtest.h>
+#include <thermal2/background.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t room_raw{(22 + 64) * 128};  // 22 celsius
+constexpr uint16_t body_raw{(32 + 64) * 128};  // 32 celsius (clothed)
+
+using replay_function_t = std::function<void(const uint32_t, const uint16_t*)>;
+
+uint32_t replay(const char* path, const replay_function_t& func)
+{
+    FILE* fp = std::fopen(path, "rb");
+    if (!fp) {
+        return 0;
+    }
+    uint8_t buf[frame_pixels * 2]{};
+    uint16_t frame[frame_pixels]{};
+    uint32_t cnt{};
+    while (std::fread(buf, sizeof(buf), 1, fp) == 1) {
+        for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+            frame[i] = buf[i * 2] | (buf[i * 2 + 1] << 8);
+        }
+        func(cnt++, frame);
+    }
+    std::fclose(fp);
+    return cnt;
+}
+
+constexpr uint32_t frames_total{600};
+constexpr uint32_t enter_at{150};
+constexpr uint32_t sit_at{190};
+constexpr uint32_t leave_at{450};
+
+// Room with a slow ambient drift. A person walks into zone "desk", sits still, then leaves
+struct scenario_t {
+    static void person(const uint32_t t, float& cx, float& cy)
+    {
+        // Walks from the door (x:0) to the desk (x:8), sits, walks back
+        cy = 12.0f;
+        if (t < sit_at) {
+            cx = (t - enter_at) * 0.2f;
+        } else if (t < leave_at) {
+            cx = 8.0f;
+        } else {
+            cx = 8.0f - (t - leave_at) * 0.2f;
+        }
+    }
+    static bool present(const uint32_t t)
+    {
+        return t >= enter_at && t < leave_at + 40;
+    }
+
+    static bool write(const char* path)
+    {
+        FILE* fp = std::fopen(path, "wb");
+        if (!fp) {
+            return false;
+        }
+        std::default_random_engine rng{};
+        std::normal_distribution<float> noise(0.0f, 10.0f);
+        uint8_t buf[frame_pixels * 2]{};
+        for (uint32_t t = 0; t < frames_total; ++t) {
+            const float drift = 64.0f * t / frames_total;  // 0.5 celsius over the recording
+            float cx{}, cy{};
+            person(t, cx, cy);
+            for (int y = 0; y < frame_height; ++y) {
+                for (int x = 0; x < frame_width; ++x) {
+                    float v = room_raw + x * 6 + y * 3 + drift + noise(rng);
+                    if (x >= 26 && y < 6) {
+                        v += 640;  // Radiator, always warm
+                    }
+                    if (present(t) && std::fabs(x - cx) <= 1.5f && std::fabs(y - cy) <= 3.0f) {
+                        v = body_raw + noise(rng);
+                    }
+                    const uint16_t u                   = (uint16_t)std::lround(v);
+                    buf[(y * frame_width + x) * 2]     = u & 0xFF;
+                    buf[(y * frame_width + x) * 2 + 1] = u >> 8;
+                }
+            }
+            std::fwrite(buf, sizeof(buf), 1, fp);
+        }
+        std::fclose(fp);
+        return true;
+    }
+};
+
+}  // namespace
+
+TEST(Background, Replay)
+{
+    const char* path = "test_background_replay.bin";
+    ASSERT_TRUE(scenario_t::write(path));
+
+    BackgroundModel bg{};
+    EXPECT_TRUE(bg.addZone("door", Rect{0, 8, 3, 8}));
+    EXPECT_TRUE(bg.addZone("desk", Rect{6, 8, 5, 8}, 6));
+    EXPECT_TRUE(bg.addZone("radiator", Rect{24, 0, 8, 8}));
+    EXPECT_FALSE(bg.addZone("desk", Rect{0, 0, 1, 1}));
+
+    uint32_t false_fg{}, missed{}, desk_on{}, desk_wrong{};
+    const auto frames = replay(path, [&](const uint32_t t, const uint16_t* frame) {
+        bg.process(frame);
+        auto desk = bg.findZone("desk");
+        auto rad  = bg.findZone("radiator");
+        ASSERT_NE(desk, nullptr);
+        ASSERT_NE(rad, nullptr);
+        EXPECT_FALSE(rad->occupied) << t;
+
+        if (!scenario_t::present(t)) {
+            false_fg += bg.foregroundCount();
+        } else if (t >= sit_at && t < leave_at) {
+            // Sitting still must stay foreground
+            missed += !desk->occupied;
+            desk_on += desk->occupied;
+        }
+        // Desk empty long after leaving
+        if (t > leave_at + 80) {
+            desk_wrong += desk->occupied;
+        }
+    });
+    std::remove(path);
+
+    EXPECT_EQ(frames, frames_total);
+    EXPECT_EQ(bg.frames(), frames_total);
+    EXPECT_EQ(missed, 0U);
+    EXPECT_EQ(desk_on, leave_at - sit_at);
+    EXPECT_EQ(desk_wrong, 0U);
+    // Sporadic noise pixels only
+    EXPECT_LT(false_fg, frames_total / 10);
+
+    // A recording given by the environment
+    if (const char* rec = std::getenv("THERMO_REPLAY")) {
+        BackgroundModel model{};
+        uint32_t fg{}, changed{};
+        const auto n = replay(rec, [&](const uint32_t, const uint16_t* frame) {
+            fg += model.process(frame);
+            changed += model.changedCount();
+        });
+        printf("%s: %u frames, mean foreground %.2f, mean changed %.2f\n", rec, n, n ? (double)fg / n : 0.0,
+               n ? (double)changed / n : 0.0);
+    }
+}
+
+TEST(Background, Basic)
+{
+    BackgroundModel bg{};
+    uint16_t frame[frame_pixels]{};
+    std::fill(std::begin(frame), std::end(frame), room_raw);
+
+    EXPECT_EQ(bg.process(frame), 0);
+    EXPECT_EQ(bg.mean(0), room_raw);
+    EXPECT_EQ(bg.variance(0), bg.config().min_variance);
+
+    // Hot pixel
+    frame[5 * frame_width + 7] = body_raw;
+    EXPECT_EQ(bg.process(frame), 1);
+    EXPECT_TRUE(bg.isForeground(7, 5));
+    EXPECT_EQ(bg.mask()[5], 1U << 7);
+    EXPECT_EQ(bg.changedCount(), 1);
+
+    // Cold pixel is ignored unless hot_only is false
+    frame[5 * frame_width + 7] = room_raw - 1280;
+    EXPECT_EQ(bg.process(frame), 0);
+    EXPECT_EQ(bg.changedCount(), 1);
+    auto cfg     = bg.config();
+    cfg.hot_only = false;
+    bg.config(cfg);
+    EXPECT_EQ(bg.process(frame), 1);
+
+    // Reset takes the next frame as the background
+    bg.reset();
+    EXPECT_EQ(bg.process(frame), 0);
+    EXPECT_EQ(bg.mean(5 * frame_width + 7), room_raw - 1280);
+    EXPECT_EQ(bg.frames(), 1U);
+
+    EXPECT_TRUE(bg.removeZone("none") == false);
+    EXPECT_TRUE(bg.addZone("all", Rect{0, 0, 32, 24}));
+    frame[0] = body_raw;
+    bg.process(frame);
+    EXPECT_EQ(bg.findZone("all")->count, 1);
+    EXPECT_FALSE(bg.findZone("all")->occupied);  // min_pixels 2
+    EXPECT_TRUE(bg.removeZone("all"));
+    EXPECT_TRUE(bg.zones().empty());
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Background, DISABLED_Benchmark)
+{
+    std::default_random_engine rng{};
+    std::normal_distribution<float> noise(0.0f, 10.0f);
+    uint16_t frames[8][frame_pixels]{};
+    for (auto&& f : frames) {
+        for (auto&& v : f) {
+            v = (uint16_t)std::lround(room_raw + noise(rng));
+        }
+    }
+    BackgroundModel bg{};
+    for (int i = 0; i < 16; ++i) {
+        bg.addZone(std::to_string(i).c_str(), Rect{(uint8_t)(i * 2), 4, 4, 8});
+    }
+    constexpr uint32_t loops{5000};
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        bg.process(frames[i & 7]);
+    }
+    auto elapsed    = std::chrono::high_resolution_clock::now() - start;
+    const double us = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+    printf("%.2f us/frame (16 zones)\n", us);
+}
@@ -0,0 +1,246 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for BlobDetector and BlobTracker
+*/
+#include <gtest/gtest.h>
+#include <thermal2/blob.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t cold{(20 + 64) * 128};
+constexpr uint16_t hot{(36 + 64) * 128};
+
+// Flood fill
+std::vector<Blob> reference(const uint16_t* frame, const uint16_t threshold, const bool eight)
+{
+    std::vector<Blob> out;
+    std::vector<bool> seen(frame_pixels);
+    for (int start = 0; start < frame_pixels; ++start) {
+        if (seen[start] || frame[start] < threshold) {
+            continue;
+        }
+        Blob b{};
+        uint32_t sx{}, sy{};
+        int x0{99}, y0{99}, x1{-1}, y1{-1};
+        std::vector<int> stack{start};
+        seen[start] = true;
+        while (!stack.empty()) {
+            const int idx = stack.back();
+            stack.pop_back();
+            const int x = idx % frame_width, y = idx / frame_width;
+            ++b.area;
+            sx += x;
+            sy += y;
+            if (frame[idx] > b.peak) {
+                b.peak   = frame[idx];
+                b.peak_x = x;
+                b.peak_y = y;
+            }
+            x0 = std::min(x0, x);
+            y0 = std::min(y0, y);
+            x1 = std::max(x1, x);
+            y1 = std::max(y1, y);
+            for (int j = -1; j <= 1; ++j) {
+                for (int i = -1; i <= 1; ++i) {
+                    if ((!i && !j) || (!eight && i && j)) {
+                        continue;
+                    }
+                    const int xx = x + i, yy = y + j;
+                    if (xx < 0 || yy < 0 || xx >= frame_width || yy >= frame_height) {
+                        continue;
+                    }
+                    const int n = yy * frame_width + xx;
+                    if (!seen[n] && frame[n] >= threshold) {
+                        seen[n] = true;
+                        stack.push_back(n);
+                    }
+                }
+            }
+        }
+        b.cx     = (float)sx / b.area;
+        b.cy     = (float)sy / b.area;
+        b.bounds = Rect{(uint8_t)x0, (uint8_t)y0, (uint8_t)(x1 - x0 + 1), (uint8_t)(y1 - y0 + 1)};
+        out.push_back(b);
+    }
+    return out;
+}
+
+bool less_blob(const Blob& a, const Blob& b)
+{
+    return std::make_tuple(a.area, a.bounds.x, a.bounds.y, a.bounds.w, a.bounds.h) <
+           std::make_tuple(b.area, b.bounds.x, b.bounds.y, b.bounds.w, b.bounds.h);
+}
+
+void draw(uint16_t* frame, const float cx, const float cy, const float r)
+{
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            const float d = std::hypot(x - cx, y - cy);
+            if (d <= r) {
+                frame[y * frame_width + x] = hot - (uint16_t)(d * 64);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Blob, Detector)
+{
+    std::default_random_engine rng{};
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    uint16_t frame[frame_pixels]{};
+
+    for (auto&& eight : {true, false}) {
+        BlobDetector::config_t cfg{};
+        cfg.threshold       = hot - 1000;
+        cfg.eight_connected = eight;
+        BlobDetector bd(cfg);
+
+        for (uint32_t n = 0; n < 200; ++n) {
+            const float density = 0.1f + 0.8f * u(rng);
+            for (auto&& v : frame) {
+                v = (u(rng) < density) ? hot - (uint16_t)(u(rng) * 900) : cold;
+            }
+            auto ref = reference(frame, cfg.threshold, eight);
+            std::sort(ref.begin(), ref.end(), [](const Blob& a, const Blob& b) { return less_blob(b, a); });
+
+            const uint8_t cnt = bd.detect(frame);
+            EXPECT_EQ(cnt, std::min<size_t>(ref.size(), BlobDetector::max_blobs));
+            EXPECT_EQ(bd.overflow(), ref.size() > BlobDetector::max_blobs ? ref.size() - BlobDetector::max_blobs : 0);
+            if (ref.size() > BlobDetector::max_blobs) {
+                // Kept the largest
+                EXPECT_EQ(bd.blobs()[cnt - 1].area, ref[cnt - 1].area);
+                continue;
+            }
+            std::vector<Blob> got(bd.blobs(), bd.blobs() + cnt);
+            std::sort(got.begin(), got.end(), [](const Blob& a, const Blob& b) { return less_blob(b, a); });
+            for (uint8_t i = 0; i < cnt; ++i) {
+                EXPECT_EQ(got[i].area, ref[i].area);
+                EXPECT_FLOAT_EQ(got[i].cx, ref[i].cx);
+                EXPECT_FLOAT_EQ(got[i].cy, ref[i].cy);
+                EXPECT_EQ(got[i].peak, ref[i].peak);
+                EXPECT_EQ(frame[got[i].peak_y * frame_width + got[i].peak_x], ref[i].peak);
+                EXPECT_EQ(got[i].bounds.x, ref[i].bounds.x);
+                EXPECT_EQ(got[i].bounds.y, ref[i].bounds.y);
+                EXPECT_EQ(got[i].bounds.w, ref[i].bounds.w);
+                EXPECT_EQ(got[i].bounds.h, ref[i].bounds.h);
+            }
+            // Descending order of area
+            EXPECT_TRUE(std::is_sorted(bd.blobs(), bd.blobs() + cnt,
+                                       [](const Blob& a, const Blob& b) { return a.area > b.area; }));
+        }
+    }
+
+    // U shape merges late
+    BlobDetector bd{BlobDetector::config_t{hot - 1000, 1, true}};
+    std::fill(std::begin(frame), std::end(frame), cold);
+    for (int y = 2; y < 10; ++y) {
+        frame[y * frame_width + 3] = hot;
+        frame[y * frame_width + 9] = hot;
+    }
+    for (int x = 3; x <= 9; ++x) {
+        frame[10 * frame_width + x] = hot;
+    }
+    EXPECT_EQ(bd.detect(frame), 1);
+    EXPECT_EQ(bd.blobs()[0].area, 8 * 2 + 7);
+    EXPECT_EQ(bd.blobs()[0].bounds.w, 7);
+    EXPECT_EQ(bd.blobs()[0].bounds.h, 9);
+
+    // min_area
+    auto cfg     = bd.config();
+    cfg.min_area = 24;
+    bd.config(cfg);
+    EXPECT_EQ(bd.detect(frame), 0);
+}
+
+TEST(Blob, Tracker)
+{
+    BlobDetector bd{BlobDetector::config_t{hot - 512, 1, true}};
+    BlobTracker bt{};
+    uint16_t frame[frame_pixels]{};
+
+    uint16_t id_a{}, id_b{}, id_c{};
+    for (int t = 0; t < 20; ++t) {
+        std::fill(std::begin(frame), std::end(frame), cold);
+        draw(frame, 4 + t * 0.8f, 6, 2);    // A moves right
+        draw(frame, 26 - t * 0.8f, 18, 2);  // B moves left
+        if (t < 8 || (t >= 10 && t < 12) || t >= 17) {
+            draw(frame, 16, 4 + (t % 2), 1.5f);  // C flickers
+        }
+        bd.detect(frame);
+        bt.update(bd);
+
+        auto find_near = [&bd](const float x, const float y) -> const Blob* {
+            for (uint8_t i = 0; i < bd.size(); ++i) {
+                if (std::hypot(bd.blobs()[i].cx - x, bd.blobs()[i].cy - y) < 2.0f) {
+                    return &bd.blobs()[i];
+                }
+            }
+            return nullptr;
+        };
+        auto a = find_near(4 + t * 0.8f, 6);
+        auto b = find_near(26 - t * 0.8f, 18);
+        ASSERT_NE(a, nullptr);
+        ASSERT_NE(b, nullptr);
+        EXPECT_NE(a->id, 0);
+        EXPECT_NE(b->id, 0);
+        if (!t) {
+            id_a = a->id;
+            id_b = b->id;
+        }
+        EXPECT_EQ(a->id, id_a) << t;
+        EXPECT_EQ(b->id, id_b) << t;
+        auto c = find_near(16, 4.5f);
+        if (c) {
+            if (t == 0) {
+                id_c = c->id;
+            }
+            if (t == 10) {
+                EXPECT_EQ(c->id, id_c);  // Missed 2 frames
+            }
+            if (t == 17) {
+                EXPECT_NE(c->id, id_c);  // Missed 5 frames
+            }
+        }
+    }
+    bt.reset();
+    EXPECT_TRUE(std::all_of(bt.tracks(), bt.tracks() + BlobTracker::max_tracks,
+                            [](const BlobTracker::Track& t) { return t.id == 0; }));
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Blob, DISABLED_Benchmark)
+{
+    std::default_random_engine rng{};
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    uint16_t frame[frame_pixels]{};
+    BlobDetector bd{BlobDetector::config_t{hot - 1000, 1, true}};
+    BlobTracker bt{};
+
+    for (auto&& density : {0.05f, 0.3f, 0.5f, 1.0f}) {
+        for (auto&& v : frame) {
+            v = (u(rng) < density) ? hot : cold;
+        }
+        constexpr uint32_t loops{1000};
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t l = 0; l < loops; ++l) {
+            bd.detect(frame);
+            bt.update(bd);
+        }
+        auto elapsed    = std::chrono::high_resolution_clock::now() - start;
+        const double us = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+        printf("density:%.2f blobs:%2u overflow:%3u %8.2f us/frame\n", density, bd.size(), bd.overflow(), us);
+    }
+}
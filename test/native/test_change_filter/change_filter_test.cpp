@@ -0,0 +1,213 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for ChangeFilter
+*/
+#include <gtest/gtest.h>
+#include <utility/change_filter.hpp>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermo;
+
+namespace {
+
+constexpr float nan_value{std::numeric_limits<float>::quiet_NaN()};
+
+}  // namespace
+
+TEST(ChangeFilter, Disabled)
+{
+    ChangeFilter f;
+    EXPECT_FALSE(f.enabled());
+    for (uint32_t t = 0; t < 100; ++t) {
+        EXPECT_TRUE(f.publish(t, {25.0f}));
+    }
+    EXPECT_EQ(f.stats().published, 100U);
+    EXPECT_EQ(f.stats().suppressed, 0U);
+}
+
+TEST(ChangeFilter, DeadBand)
+{
+    ChangeFilter::config_t cfg{};
+    cfg.dead_band = 0.5f;
+    ChangeFilter f{cfg};
+    EXPECT_TRUE(f.enabled());
+
+    EXPECT_TRUE(f.publish(0, {25.0f, 30.0f}));  // First
+    EXPECT_FALSE(f.publish(1, {25.4f, 30.0f}));
+    EXPECT_FALSE(f.publish(2, {24.6f, 30.4f}));
+    // Compared with the last published, not the last sample, so a slow drift is published
+    EXPECT_TRUE(f.publish(3, {25.6f, 30.0f}));
+    EXPECT_FALSE(f.publish(4, {25.6f, 29.7f}));
+    EXPECT_TRUE(f.publish(5, {25.6f, 29.0f}));  // The second value
+
+    // NaN and back are changes
+    EXPECT_TRUE(f.publish(6, {nan_value, 29.0f}));
+    EXPECT_FALSE(f.publish(7, {nan_value, 29.0f}));
+    EXPECT_TRUE(f.publish(8, {25.6f, 29.0f}));
+
+    EXPECT_EQ(f.stats().published, 5U);
+    EXPECT_EQ(f.stats().suppressed, 4U);
+
+    // The next sample is published after reset
+    f.reset();
+    EXPECT_TRUE(f.publish(9, {25.6f, 29.0f}));
+    EXPECT_EQ(f.stats().published, 1U);
+}
+
+TEST(ChangeFilter, Heartbeat)
+{
+    ChangeFilter::config_t cfg{};
+    cfg.dead_band = 1.0f;
+    cfg.heartbeat = 1000;
+    ChangeFilter f{cfg};
+
+    uint32_t published{};
+    for (uint32_t t = 0; t < 10000; t += 100) {
+        published += f.publish(t, {25.0f});
+    }
+    // First, then every second
+    EXPECT_EQ(published, 10U);
+    EXPECT_EQ(f.stats().heartbeat, 9U);
+
+    // A change restarts the heartbeat
+    EXPECT_TRUE(f.publish(10050, {30.0f}));
+    EXPECT_FALSE(f.publish(10900, {30.0f}));
+    EXPECT_TRUE(f.publish(11050, {30.0f}));
+
+    // Across the wrap around of the time
+    f.reset();
+    EXPECT_TRUE(f.publish(0xFFFFFF00U, {25.0f}));
+    EXPECT_FALSE(f.publish(0x00000100U, {25.0f}));
+    EXPECT_TRUE(f.publish(0x00000300U, {25.0f}));
+}
+
+TEST(ChangeFilter, Pixels)
+{
+    // A static scene: unaligned pixels with Gaussian noise (8 raw: 0.06 celsius)
+    std::vector<uint16_t> scene(384), frame(384);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> pixel(0x3000, 0x3F00);
+    std::normal_distribution<float> noise(0.0f, 8.0f);
+    for (auto& p : scene) {
+        p = (uint16_t)pixel(rng);
+    }
+    auto generate = [&]() {
+        for (size_t i = 0; i < frame.size(); ++i) {
+            frame[i] = (uint16_t)std::lround(scene[i] + noise(rng));
+        }
+    };
+
+    ChangeFilter::config_t cfg{};
+    cfg.pixel_band  = 64;  // 0.5 celsius
+    cfg.pixel_limit = 2;
+    ChangeFilter f{cfg};
+    EXPECT_TRUE(f.enabled());
+
+    generate();
+    EXPECT_TRUE(f.publish(0, {}, frame.data(), frame.size()));
+    constexpr uint32_t count{1000};
+    for (uint32_t t = 1; t <= count; ++t) {
+        generate();
+        EXPECT_FALSE(f.publish(t, {}, frame.data(), frame.size())) << t;
+    }
+    EXPECT_EQ(f.stats().suppressed, count);
+
+    // Pixels up to the limit moved
+    generate();
+    frame[10] += 200;
+    frame[200] += 200;
+    EXPECT_FALSE(f.publish(count + 1, {}, frame.data(), frame.size()));
+    // One more is a change
+    frame[300] -= 200;
+    EXPECT_TRUE(f.publish(count + 2, {}, frame.data(), frame.size()));
+
+    // Any pixel with no limit
+    cfg.pixel_limit = 0;
+    f.config(cfg);
+    generate();
+    EXPECT_TRUE(f.publish(0, {}, frame.data(), frame.size()));
+    generate();
+    EXPECT_FALSE(f.publish(1, {}, frame.data(), frame.size()));
+    frame[383] += 100;
+    EXPECT_TRUE(f.publish(2, {}, frame.data(), frame.size()));
+
+    // Compared with the last published, so a slow drift is published
+    f.reset();
+    uint32_t published{};
+    for (uint32_t t = 0; t < 100; ++t) {
+        for (auto& p : scene) {
+            p += 4;
+        }
+        generate();
+        published += f.publish(t, {}, frame.data(), frame.size());
+    }
+    EXPECT_GE(published, 400U / cfg.pixel_band);  // Drifted 400 raw
+    EXPECT_LE(published, 25U);
+
+    // Pixels without a band are not compared
+    ChangeFilter values{};
+    EXPECT_FALSE(values.enabled());
+    EXPECT_TRUE(values.publish(0, {}, frame.data(), frame.size()));
+}
+
+TEST(ChangeFilter, Idle)
+{
+    // A mostly idle monitor: noise around a constant with an occasional event
+    ChangeFilter::config_t cfg{};
+    cfg.dead_band = 0.3f;
+    cfg.heartbeat = 10 * 1000;
+    ChangeFilter f{cfg};
+
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    constexpr uint32_t interval{250}, count{4 * 3600};  // 1 hour at 4 Hz
+    uint32_t published{};
+    float last{}, max_error{};
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t t = i * interval;
+        const float v    = 25.0f + noise(rng) + ((i / 1200) % 2 ? 5.0f : 0.0f);
+        if (f.publish(t, {v})) {
+            last = v;
+            ++published;
+        }
+        max_error = std::fmax(max_error, std::fabs(v - last));
+    }
+    EXPECT_LE(max_error, cfg.dead_band);
+    // Mostly the heartbeat (360 in the hour), under 4% of the samples
+    EXPECT_LT(published, count / 25);
+    EXPECT_GE(f.stats().heartbeat * 10, published * 9);
+    EXPECT_EQ(f.stats().published + f.stats().suppressed, count);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(ChangeFilter, DISABLED_Benchmark)
+{
+    constexpr int count{1 << 14};
+    std::vector<uint16_t> frame(384);
+    for (size_t i = 0; i < frame.size(); ++i) {
+        frame[i] = (uint16_t)(0x3000 + i);
+    }
+    ChangeFilter::config_t cfg{};
+    cfg.dead_band  = 0.1f;
+    cfg.pixel_band = 16;
+    ChangeFilter f{cfg};
+
+    auto started = std::chrono::high_resolution_clock::now();
+    uint32_t published{};
+    for (int i = 0; i < count; ++i) {
+        frame[i % 384] ^= (i & 1) << 8;
+        published += f.publish(i, {25.0f, 26.0f, 20.0f, 30.0f}, frame.data(), frame.size());
+    }
+    const auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+    EXPECT_NE(published, 0U);
+    printf("ChangeFilter: publish with 384 pixels %.1f ns\n", (double)ns / count);
+}
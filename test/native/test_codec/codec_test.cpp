@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for DeltaEncoder/DeltaDecoder
+*/
+#include <gtest/gtest.h>
+#include <thermal2/codec.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(22 + 64) * 128};
+
+// Subpages of a room with sensor noise and a person walking through, as recorded at 8Hz
+std::vector<std::vector<uint16_t>> record(const int count, const float noise, const uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> n(0.0f, noise);
+    std::vector<std::vector<uint16_t>> pages;
+    for (int f = 0; f < count; ++f) {
+        const uint8_t sp = f & 1;
+        const float cx   = (f % 160) * 0.25f - 4.0f;
+        std::vector<uint16_t> page(subpage_pixels);
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            const uint16_t idx = subpage_to_frame_index(sp, i);
+            const int x        = idx % frame_width, y = idx / frame_width;
+            const float body   = (std::fabs(x - cx) < 3.0f && y > 4) ? 1500.0f : 0.0f;
+            page[i]            = (uint16_t)(base_raw + x * 6 + y * 4 + body + n(rng));
+        }
+        pages.push_back(page);
+    }
+    return pages;
+}
+
+}  // namespace
+
+TEST(Codec, RoundTrip)
+{
+    const auto pages = record(200, 6.0f, 1);
+    DeltaEncoder enc;
+    DeltaDecoder dec;
+    uint8_t block[codec_max_block_size]{};
+    uint16_t raw[subpage_pixels]{};
+    uint32_t keys{};
+
+    for (size_t f = 0; f < pages.size(); ++f) {
+        const size_t len = enc.encode(block, pages[f].data(), f & 1);
+        ASSERT_GT(len, 0U);
+        ASSERT_LE(len, codec_max_block_size);
+        keys += (block[0] & codec_flag_keyframe) != 0;
+        EXPECT_EQ(block[0] & codec_flag_subpage, f & 1);
+
+        uint8_t sp{0xFF};
+        EXPECT_EQ(dec.decode(block, len, raw, sp), len) << f;
+        EXPECT_EQ(sp, f & 1);
+        EXPECT_EQ(std::memcmp(raw, pages[f].data(), sizeof(raw)), 0) << f;
+    }
+    // The first of each subpage and every 32nd
+    EXPECT_EQ(keys, 2U * ((100 + 31) / 32));
+
+    EXPECT_EQ(enc.encode(nullptr, raw, 0), 0U);
+    EXPECT_EQ(dec.decode(nullptr, 1, raw, *block), 0U);
+}
+
+TEST(Codec, Keyframe)
+{
+    const auto pages = record(80, 6.0f, 2);
+    DeltaEncoder::config_t cfg{};
+    cfg.keyframe_interval = 0;
+    DeltaEncoder enc(cfg);
+    DeltaDecoder dec;
+    uint8_t block[codec_max_block_size]{};
+    uint16_t raw[subpage_pixels]{};
+    uint8_t sp{};
+
+    // A decoder joining late waits for a keyframe
+    for (int f = 0; f < 10; ++f) {
+        enc.encode(block, pages[f].data(), f & 1);
+    }
+    size_t len = enc.encode(block, pages[10].data(), 0);
+    EXPECT_FALSE(block[0] & codec_flag_keyframe);
+    EXPECT_EQ(dec.decode(block, len, raw, sp), 0U);
+    EXPECT_FALSE(dec.synced(0));
+
+    enc.requestKeyframe();
+    len = enc.encode(block, pages[11].data(), 1);
+    EXPECT_TRUE(block[0] & codec_flag_keyframe);
+    EXPECT_EQ(dec.decode(block, len, raw, sp), len);
+    EXPECT_TRUE(dec.synced(1));
+    EXPECT_FALSE(dec.synced(0));
+    len = enc.encode(block, pages[12].data(), 0);
+    EXPECT_EQ(dec.decode(block, len, raw, sp), len);
+    EXPECT_EQ(std::memcmp(raw, pages[12].data(), sizeof(raw)), 0);
+
+    // Truncated, out of sync until the next keyframe
+    len = enc.encode(block, pages[13].data(), 1);
+    EXPECT_EQ(dec.decode(block, len / 2, raw, sp), 0U);
+    EXPECT_FALSE(dec.synced(1));
+    len = enc.encode(block, pages[15].data(), 1);
+    EXPECT_EQ(dec.decode(block, len, raw, sp), 0U);
+
+    dec.invalidate();
+    EXPECT_FALSE(dec.synced(0));
+}
+
+TEST(Codec, Stored)
+{
+    // White noise does not compress
+    std::mt19937 rng(3);
+    uint16_t noise[subpage_pixels]{};
+    for (auto&& r : noise) {
+        r = (uint16_t)rng();
+    }
+    DeltaEncoder enc;
+    DeltaDecoder dec;
+    uint8_t block[codec_max_block_size]{};
+    uint16_t raw[subpage_pixels]{};
+    uint8_t sp{};
+    size_t len = enc.encode(block, noise, 1);
+    EXPECT_EQ(len, codec_max_block_size);
+    EXPECT_TRUE(block[0] & codec_flag_stored);
+    EXPECT_EQ(dec.decode(block, len, raw, sp), len);
+    EXPECT_EQ(std::memcmp(raw, noise, sizeof(raw)), 0);
+
+    // Then deltas from it
+    noise[5] += 3;
+    len = enc.encode(block, noise, 1);
+    EXPECT_LT(len, 64U);
+    EXPECT_EQ(dec.decode(block, len, raw, sp), len);
+    EXPECT_EQ(std::memcmp(raw, noise, sizeof(raw)), 0);
+
+    // Extremes wrap around
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        noise[i] = (i & 1) ? 0 : 0xFFFF;
+    }
+    len = enc.encode(block, noise, 1);
+    EXPECT_EQ(dec.decode(block, len, raw, sp), len);
+    EXPECT_EQ(std::memcmp(raw, noise, sizeof(raw)), 0);
+}
+
+TEST(Codec, Ratio)
+{
+    const float noises[] = {2.0f, 6.0f, 16.0f};
+    for (auto&& noise : noises) {
+        SCOPED_TRACE(noise);
+        const auto pages = record(960, noise, 4);
+        DeltaEncoder enc;
+        uint8_t block[codec_max_block_size]{};
+        size_t total{};
+        for (size_t f = 0; f < pages.size(); ++f) {
+            total += enc.encode(block, pages[f].data(), f & 1);
+        }
+        const double ratio = (double)pages.size() * subpage_pixels * 2 / total;
+        EXPECT_GT(ratio, 1.5);
+    }
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Codec, DISABLED_Benchmark)
+{
+    const float noises[] = {2.0f, 6.0f, 16.0f};
+    for (auto&& noise : noises) {
+        const auto pages = record(960, noise, 4);
+        DeltaEncoder enc;
+        DeltaDecoder dec;
+        std::vector<uint8_t> blocks(pages.size() * codec_max_block_size);
+        std::vector<size_t> lens(pages.size());
+        uint16_t raw[subpage_pixels]{};
+        uint8_t sp{};
+        size_t total{}, pos{};
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t f = 0; f < pages.size(); ++f) {
+            lens[f] = enc.encode(blocks.data() + f * codec_max_block_size, pages[f].data(), f & 1);
+            total += lens[f];
+        }
+        auto elapsed     = std::chrono::high_resolution_clock::now() - start;
+        const double us0 = std::chrono::duration<double, std::micro>(elapsed).count() / pages.size();
+
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t f = 0; f < pages.size(); ++f) {
+            pos += dec.decode(blocks.data() + f * codec_max_block_size, lens[f], raw, sp);
+        }
+        elapsed          = std::chrono::high_resolution_clock::now() - start;
+        const double us1 = std::chrono::duration<double, std::micro>(elapsed).count() / pages.size();
+
+        const double ratio = (double)pages.size() * subpage_pixels * 2 / total;
+        printf("noise:%4.1f block:%.1f bytes ratio:%.2f encode:%.2f us decode:%.2f us\n", noise,
+               (double)total / pages.size(), ratio, us0, us1);
+        EXPECT_EQ(pos, total);
+    }
+}
@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for Deinterlacer
+*/
+#include <gtest/gtest.h>
+#include <thermal2/deinterlace.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(25 + 64) * 128};
+constexpr uint16_t hot_raw{(35 + 64) * 128};
+
+// Hot disc moving to the right, one position per subpage
+void render(uint16_t* frame, const uint32_t t, const float speed, std::default_random_engine& rng)
+{
+    std::normal_distribution<float> noise(0.0f, 6.0f);
+    const float cx = 4.0f + speed * t;
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            const float d              = std::hypot(x - cx, y - 12.0f);
+            const float v              = d < 4.0f ? hot_raw : base_raw + x * 8;
+            frame[y * frame_width + x] = (uint16_t)std::lround(v + noise(rng));
+        }
+    }
+}
+
+void extract(uint16_t* raw, const uint16_t* frame, const uint8_t sp)
+{
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        raw[i] = frame[subpage_to_frame_index(sp, i)];
+    }
+}
+
+// Mean absolute error against the scene at the time of the fresh subpage
+double error(const uint16_t* out, const uint16_t* truth)
+{
+    double e{};
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        e += std::fabs((double)out[i] - truth[i]);
+    }
+    return e / frame_pixels;
+}
+
+// Checkerboard component of the error (2x2 blocks), the artefact itself
+double comb(const uint16_t* out, const uint16_t* truth)
+{
+    double e{};
+    for (int y = 0; y + 1 < frame_height; ++y) {
+        for (int x = 0; x + 1 < frame_width; ++x) {
+            auto err = [&](const int xx, const int yy) {
+                return (double)out[yy * frame_width + xx] - truth[yy * frame_width + xx];
+            };
+            e += std::fabs(err(x, y) - err(x + 1, y) - err(x, y + 1) + err(x + 1, y + 1)) * 0.25;
+        }
+    }
+    return e / ((frame_width - 1) * (frame_height - 1));
+}
+
+struct result_t {
+    double naive{}, deinterlaced{};
+    double naive_comb{}, deinterlaced_comb{};
+};
+
+result_t run(const float speed)
+{
+    std::default_random_engine rng{};
+    Deinterlacer di{};
+    Frame naive{};
+    uint16_t truth[frame_pixels]{}, out[frame_pixels]{}, raw[subpage_pixels]{};
+    result_t r{};
+    uint32_t cnt{};
+    for (uint32_t t = 0; t < 30; ++t) {
+        const uint8_t sp = t & 1;
+        render(truth, t, speed, rng);
+        extract(raw, truth, sp);
+        naive.merge(raw, sp);
+        di.process(raw, sp, out);
+        if (t >= 4) {
+            r.naive += error(naive.raw, truth);
+            r.deinterlaced += error(out, truth);
+            r.naive_comb += comb(naive.raw, truth);
+            r.deinterlaced_comb += comb(out, truth);
+            ++cnt;
+        }
+    }
+    r.naive /= cnt;
+    r.deinterlaced /= cnt;
+    r.naive_comb /= cnt;
+    r.deinterlaced_comb /= cnt;
+    return r;
+}
+
+}  // namespace
+
+TEST(Deinterlace, Still)
+{
+    // Still scene keeps the full resolution, exactly the naive merge
+    std::default_random_engine rng{};
+    Deinterlacer di{};
+    Frame naive{};
+    uint16_t frame[frame_pixels]{}, out[frame_pixels]{}, raw[subpage_pixels]{};
+    render(frame, 0, 0.0f, rng);
+    for (uint32_t t = 0; t < 6; ++t) {
+        const uint8_t sp = t & 1;
+        extract(raw, frame, sp);
+        naive.merge(raw, sp);
+        di.process(raw, sp, out);
+        if (t >= 2) {
+            EXPECT_TRUE(std::equal(std::begin(out), std::end(out), naive.raw)) << t;
+        }
+    }
+    EXPECT_TRUE(std::equal(std::begin(out), std::end(out), di.merged()));
+
+    // The first subpage is interpolated, never zero
+    Deinterlacer first{};
+    extract(raw, frame, 1);
+    first.process(raw, 1, out);
+    EXPECT_TRUE(std::none_of(std::begin(out), std::end(out), [](const uint16_t v) { return v == 0; }));
+    Frame f{};
+    first.reset();
+    first.process(raw, 1, f);
+    EXPECT_TRUE(f.complete());
+    EXPECT_EQ(f.subpage, 1);
+}
+
+TEST(Deinterlace, Motion)
+{
+    // Mean absolute error and its checkerboard component against the scene at the time of the fresh subpage
+    for (auto&& speed : {0.0f, 0.25f, 0.5f, 1.0f, 2.0f}) {
+        auto r = run(speed);
+        if (speed == 0.0f) {
+            EXPECT_DOUBLE_EQ(r.deinterlaced, r.naive);
+            continue;
+        }
+        EXPECT_LT(r.deinterlaced_comb, r.naive_comb) << speed;
+        if (speed >= 1.0f) {
+            EXPECT_LT(r.deinterlaced * 1.3, r.naive) << speed;
+        }
+    }
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Deinterlace, DISABLED_Benchmark)
+{
+    std::default_random_engine rng{};
+    Deinterlacer di{};
+    uint16_t frame[frame_pixels]{}, out[frame_pixels]{}, raw[2][subpage_pixels]{};
+    render(frame, 0, 0.0f, rng);
+    extract(raw[0], frame, 0);
+    render(frame, 4, 1.0f, rng);
+    extract(raw[1], frame, 1);
+
+    constexpr uint32_t loops{10000};
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        di.process(raw[i & 1], i & 1, out);
+    }
+    auto elapsed    = std::chrono::high_resolution_clock::now() - start;
+    const double us = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+    printf("%.2f us/subpage\n", us);
+    EXPECT_NE(out[0], 0);
+
+    // Mean absolute error and its checkerboard component against the scene at the time of the fresh subpage
+    printf("%8s %10s %14s %10s %14s\n", "speed", "naive", "deinterlaced", "comb", "comb(di)");
+    for (auto&& speed : {0.0f, 0.25f, 0.5f, 1.0f, 2.0f}) {
+        auto r = run(speed);
+        printf("%8.2f %10.2f %14.2f %10.2f %14.2f\n", speed, r.naive, r.deinterlaced, r.naive_comb,
+               r.deinterlaced_comb);
+    }
+}
@@ -0,0 +1,261 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for EventSource
+*/
+#include <gtest/gtest.h>
+#include <utility/events.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace m5::unit::thermo;
+
+namespace {
+
+struct frame_t {
+    uint32_t seq{};
+    uint16_t pixel[64]{};
+};
+
+}  // namespace
+
+TEST(EventSource, Direct)
+{
+    EventSource<int> es;
+    EXPECT_FALSE(es.subscribed());
+    EXPECT_EQ(es.subscribe(nullptr), 0U);
+
+    std::vector<int> a, b;
+    auto ida = es.subscribe([&a](const int& v) { a.push_back(v); });
+    auto idb = es.subscribe([&b](const int& v) { b.push_back(v * 10); });
+    EXPECT_NE(ida, 0U);
+    EXPECT_NE(ida, idb);
+    EXPECT_TRUE(es.subscribed());
+
+    // The handler sees the value where the caller keeps it
+    int slot{1};
+    const int* seen{};
+    auto idc = es.subscribe([&seen](const int& v) { seen = &v; });
+    es.emit(slot);
+    EXPECT_EQ(seen, &slot);
+    EXPECT_TRUE(es.unsubscribe(idc));
+    EXPECT_FALSE(es.unsubscribe(idc));
+
+    es.emit(2);
+    EXPECT_EQ(a, (std::vector<int>{1, 2}));
+    EXPECT_EQ(b, (std::vector<int>{10, 20}));
+    // Direct handlers only, nothing queued
+    EXPECT_EQ(es.pending(), 0U);
+    EXPECT_EQ(es.dispatch(), 0U);
+
+    EXPECT_TRUE(es.unsubscribe(ida));
+    es.emit(3);
+    EXPECT_EQ(a.size(), 2U);
+    EXPECT_EQ(b.size(), 3U);
+    EXPECT_TRUE(es.unsubscribe(idb));
+    EXPECT_FALSE(es.subscribed());
+    EXPECT_EQ(es.stats().emitted, 3U);
+}
+
+TEST(EventSource, UnsubscribeInHandler)
+{
+    EventSource<int> es;
+    int calls_a{}, calls_b{};
+    uint16_t ida{};
+    ida = es.subscribe([&](const int&) {
+        ++calls_a;
+        es.unsubscribe(ida);
+    });
+    es.subscribe([&](const int&) { ++calls_b; });
+    es.emit(0);
+    es.emit(0);
+    EXPECT_EQ(calls_a, 1);
+    EXPECT_EQ(calls_b, 2);
+
+    // Subscribing from a handler is called from the next event
+    int calls_c{};
+    bool once{};
+    es.subscribe([&](const int&) {
+        if (!once) {
+            once = true;
+            es.subscribe([&](const int&) { ++calls_c; });
+        }
+    });
+    es.emit(0);
+    EXPECT_EQ(calls_c, 0);
+    es.emit(0);
+    EXPECT_EQ(calls_c, 1);
+}
+
+TEST(EventSource, UnsubscribeSelf)
+{
+    // The handler keeps using what it captured after removing itself
+    EventSource<int> es;
+    std::vector<int> seen{};
+    uint16_t id{};
+    const std::vector<int> captured{1, 2, 3};
+    id = es.subscribe([&es, &id, &seen, captured](const int&) {
+        es.unsubscribe(id);
+        seen = captured;
+    });
+    es.emit(0);
+    EXPECT_EQ(seen, captured);
+    EXPECT_FALSE(es.subscribed());
+    seen.clear();
+    es.emit(0);
+    EXPECT_TRUE(seen.empty());
+
+    // Replaced by another handler from inside, the replacement is called from the next event
+    int calls_old{}, calls_new{};
+    const std::vector<int> tag{7};
+    id = es.subscribe([&es, &id, &calls_old, &calls_new, tag](const int&) {
+        ++calls_old;
+        const uint16_t old = id;
+        id                 = es.subscribe([&calls_new](const int&) { ++calls_new; });
+        es.unsubscribe(old);
+        calls_old += tag[0] - 7;
+    });
+    es.emit(0);
+    EXPECT_EQ(calls_old, 1);
+    EXPECT_EQ(calls_new, 0);
+    EXPECT_TRUE(es.subscribed());
+    es.emit(0);
+    es.emit(0);
+    EXPECT_EQ(calls_old, 1);
+    EXPECT_EQ(calls_new, 2);
+    EXPECT_TRUE(es.unsubscribe(id));
+    EXPECT_FALSE(es.subscribed());
+}
+
+TEST(EventSource, Deferred)
+{
+    EventSource<int> es;
+    std::vector<int> direct, deferred;
+    es.subscribe([&direct](const int& v) { direct.push_back(v); });
+    es.subscribeDeferred([&deferred](const int& v) { deferred.push_back(v); }, 2);
+    es.emit(1);
+    es.emit(2);
+    EXPECT_EQ(direct, (std::vector<int>{1, 2}));
+    EXPECT_TRUE(deferred.empty());
+    EXPECT_EQ(es.pending(), 2U);
+
+    // Full, dropped for the deferred handler only
+    es.emit(3);
+    EXPECT_EQ(direct.size(), 3U);
+    EXPECT_EQ(es.stats().dropped, 1U);
+
+    EXPECT_EQ(es.dispatch(1), 1U);
+    EXPECT_EQ(deferred, (std::vector<int>{1}));
+    es.emit(4);
+
+    // Growing the queue keeps the order
+    es.subscribeDeferred([](const int&) {}, 8);
+    for (int i = 5; i < 10; ++i) {
+        es.emit(i);
+    }
+    EXPECT_EQ(es.dispatch(), 7U);
+    EXPECT_EQ(deferred, (std::vector<int>{1, 2, 4, 5, 6, 7, 8, 9}));
+
+    auto s = es.stats();
+    EXPECT_EQ(s.emitted, 9U);
+    EXPECT_EQ(s.deferred, 8U);
+    EXPECT_EQ(s.dropped, 1U);
+    EXPECT_EQ(s.dispatched, 8U);
+}
+
+TEST(EventSource, AnotherTask)
+{
+    EventSource<frame_t> es;
+    std::atomic<bool> done{};
+    uint32_t received{}, last{}, torn{};
+    bool ordered{true};
+    es.subscribeDeferred(
+        [&](const frame_t& f) {
+            ordered &= !received || f.seq > last;
+            last = f.seq;
+            for (auto p : f.pixel) {
+                torn += p != (uint16_t)f.seq;
+            }
+            ++received;
+        },
+        8);
+
+    std::thread consumer([&] {
+        while (!done) {
+            if (!es.dispatch()) {
+                std::this_thread::yield();
+            }
+        }
+        es.dispatch();
+    });
+
+    constexpr uint32_t count{20000};
+    frame_t f{};
+    for (uint32_t i = 1; i <= count; ++i) {
+        f.seq = i;
+        for (auto& p : f.pixel) {
+            p = (uint16_t)i;
+        }
+        es.emit(f);
+    }
+    done = true;
+    consumer.join();
+
+    auto s = es.stats();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(torn, 0U);
+    EXPECT_EQ(received, s.dispatched);
+    EXPECT_EQ(s.deferred + s.dropped, count);
+    EXPECT_EQ(es.pending(), 0U);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(EventSource, DISABLED_Benchmark)
+{
+    constexpr int count{1 << 20};
+    EventSource<frame_t> es;
+    frame_t f{};
+    uint64_t sum{};
+    es.subscribe([&sum](const frame_t& v) { sum += v.pixel[0]; });
+
+    auto started = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) {
+        f.pixel[0] = (uint16_t)i;
+        es.emit(f);
+    }
+    const auto direct_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+
+    // Unsubscribed, what a unit pays in update() for each new data
+    EventSource<frame_t> none;
+    started = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) {
+        if (none.subscribed()) {
+            none.emit(f);
+        }
+    }
+    const auto none_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+
+    EventSource<frame_t> deferred;
+    deferred.subscribeDeferred([&sum](const frame_t& v) { sum += v.pixel[0]; }, 16);
+    started = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) {
+        deferred.emit(f);
+        deferred.dispatch();
+    }
+    const auto deferred_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+
+    EXPECT_NE(sum, 0U);
+    printf("EventSource: none %.2f ns, direct %.2f ns, deferred emit and dispatch %.2f ns per event\n",
+           (double)none_ns / count, (double)direct_ns / count, (double)deferred_ns / count);
+}
@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for Histogram
+*/
+#include <gtest/gtest.h>
+#include <thermal2/histogram.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr float percents[] = {0.0f, 1.0f, 5.0f, 25.0f, 50.0f, 75.0f, 95.0f, 99.0f, 100.0f};
+
+void random_frame(uint16_t* frame, std::mt19937& rng)
+{
+    std::normal_distribution<float> room((22 + 64) * 128, 200);
+    std::normal_distribution<float> hot((36 + 64) * 128, 100);
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        const float v = (rng() % 8) ? room(rng) : hot(rng);
+        frame[i]      = (uint16_t)std::max(0.0f, std::min(65535.0f, v));
+    }
+}
+
+uint16_t reference(const uint16_t* frame, const float p)
+{
+    std::vector<uint16_t> v(frame, frame + frame_pixels);
+    const size_t k = (size_t)(p * (frame_pixels - 1) / 100.0f);
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+void extract(uint16_t* raw, const uint16_t* frame, const uint8_t sp)
+{
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        raw[i] = frame[subpage_to_frame_index(sp, i)];
+    }
+}
+
+}  // namespace
+
+TEST(Histogram, Exact)
+{
+    std::mt19937 rng(1);
+    uint16_t frame[frame_pixels]{};
+    random_frame(frame, rng);
+
+    Histogram::config_t cfg{};
+    cfg.lower = 0;
+    cfg.shift = 0;
+    cfg.bins  = 4096;
+    // Pixels above the range go to the last bin, so shift the frame into it
+    for (auto&& v : frame) {
+        v = (uint16_t)(v - ((20 + 64) * 128 - 1024));
+    }
+    Histogram h(cfg);
+    h.build(frame);
+    EXPECT_EQ(h.total(), frame_pixels);
+    for (auto&& p : percents) {
+        EXPECT_EQ(h.percentile(p), reference(frame, p)) << p;
+    }
+}
+
+TEST(Histogram, Binned)
+{
+    std::mt19937 rng(2);
+    uint16_t frame[frame_pixels]{};
+    Histogram h;
+    const uint32_t width = 1U << h.config().shift;
+
+    for (int n = 0; n < 50; ++n) {
+        random_frame(frame, rng);
+        h.build(frame);
+        uint16_t out[sizeof(percents) / sizeof(percents[0])]{};
+        h.percentiles(out, percents, sizeof(percents) / sizeof(percents[0]));
+        for (size_t i = 0; i < sizeof(percents) / sizeof(percents[0]); ++i) {
+            const int32_t ref = reference(frame, percents[i]);
+            EXPECT_LT(std::abs((int32_t)out[i] - ref), (int32_t)width) << percents[i];
+            EXPECT_EQ(out[i], h.percentile(percents[i]));
+        }
+    }
+}
+
+TEST(Histogram, Incremental)
+{
+    std::mt19937 rng(3);
+    uint16_t frame[frame_pixels]{};
+    uint16_t raw[subpage_pixels]{};
+    Histogram inc, full;
+    Frame assembled{};
+
+    EXPECT_EQ(inc.total(), 0);
+    EXPECT_EQ(inc.percentile(50.0f), 0);
+
+    for (int n = 0; n < 100; ++n) {
+        const uint8_t sp = n & 1;
+        random_frame(frame, rng);
+        extract(raw, frame, sp);
+        inc.merge(raw, sp);
+        assembled.merge(raw, sp);
+
+        EXPECT_EQ(inc.total(), n ? frame_pixels : subpage_pixels);
+        if (!assembled.complete()) {
+            continue;
+        }
+        full.build(assembled);
+        for (uint16_t b = 0; b < full.bins(); ++b) {
+            ASSERT_EQ(inc.count(b), full.count(b)) << n << ":" << b;
+        }
+    }
+
+    // Same through the Frame overload
+    Histogram other;
+    Frame f{};
+    for (int n = 0; n < 10; ++n) {
+        random_frame(frame, rng);
+        extract(raw, frame, n & 1);
+        f.merge(raw, n & 1);
+        other.update(f);
+    }
+    full.build(f);
+    for (auto&& p : percents) {
+        EXPECT_EQ(other.percentile(p), full.percentile(p));
+    }
+
+    // Changing the binning keeps the pixels
+    auto cfg  = other.config();
+    cfg.shift = 0;
+    cfg.lower = 0;
+    cfg.bins  = 4096;
+    other.config(cfg);
+    EXPECT_EQ(other.total(), frame_pixels);
+    other.reset();
+    EXPECT_EQ(other.total(), 0);
+}
+
+TEST(Histogram, Range)
+{
+    uint16_t frame[frame_pixels]{};
+    Histogram h;
+    const auto cfg = h.config();
+    std::fill(frame, frame + frame_pixels / 2, 0);
+    std::fill(frame + frame_pixels / 2, frame + frame_pixels, 0xFFFF);
+    h.build(frame);
+    EXPECT_EQ(h.count(0), frame_pixels / 2);
+    EXPECT_EQ(h.count(h.bins() - 1), frame_pixels / 2);
+    EXPECT_GE(h.percentile(0.0f), cfg.lower);
+    EXPECT_LT(h.percentile(100.0f), h.lower(h.bins()));
+    EXPECT_EQ(h.below(cfg.lower), 0);
+    EXPECT_EQ(h.below(cfg.lower + (1U << cfg.shift)), frame_pixels / 2);
+    EXPECT_EQ(h.below(0xFFFF), frame_pixels / 2);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Histogram, DISABLED_Benchmark)
+{
+    std::mt19937 rng(4);
+    uint16_t frame[frame_pixels]{};
+    uint16_t raw[2][subpage_pixels]{};
+    random_frame(frame, rng);
+    extract(raw[0], frame, 0);
+    extract(raw[1], frame, 1);
+
+    Histogram h;
+    constexpr uint32_t loops{20000};
+    uint16_t out[sizeof(percents) / sizeof(percents[0])]{};
+    uint32_t guard{};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        h.build(frame);
+        guard += h.count(i & 255);
+    }
+    auto elapsed     = std::chrono::high_resolution_clock::now() - start;
+    const double us0 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        h.merge(raw[i & 1], i & 1);
+        guard += h.count(i & 255);
+    }
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us1 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        h.percentiles(out, percents, sizeof(percents) / sizeof(percents[0]));
+        guard += out[4];
+    }
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us2 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        guard += reference(frame, 50.0f);
+    }
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us3 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    printf("build:%.2f us merge:%.2f us percentiles(9):%.2f us nth_element(1):%.2f us\n", us0, us1, us2, us3);
+    EXPECT_GT(guard, 0U);
+}
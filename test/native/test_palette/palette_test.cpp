@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for palettes
+*/
+#include <gtest/gtest.h>
+#include <thermal2/palette.hpp>
+#include <cstdlib>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+using P565 = Palettes<PaletteFormat::RGB565>;
+
+// Made by the compiler
+static_assert(P565::grayscale[0] == 0x0000, "Not constexpr");
+static_assert(P565::grayscale[255] == 0xFFFF, "Not constexpr");
+static_assert(Palettes<PaletteFormat::RGB888>::iron[255] == 0xFFFFFF, "Not constexpr");
+static_assert(Palettes<PaletteFormat::ARGB8888>::cam[255] == 0xFFFF0000, "Not constexpr");
+static_assert(Palettes<PaletteFormat::RGB565BE>::cam[255] == 0x00F8, "Not constexpr");
+
+// Every 32nd entry (and the last) of the RGB565 tables formerly pasted into SmoothDraw
+constexpr uint16_t golden_samples[]    = {0x0004, 0x386D, 0x8133, 0xCA29, 0xFB80, 0xFD60, 0xFF04, 0xFFD2, 0xFFFF};
+constexpr uint16_t rainbow_samples[]   = {0x0009, 0x01F3, 0x039B, 0x4547, 0xD6A0, 0xFD62, 0xF907, 0xFB2E, 0xFF5A};
+constexpr uint16_t grayscale_samples[] = {0x0000, 0x2103, 0x4207, 0x630B, 0x840F, 0xA513, 0xC617, 0xE71B, 0xFFFF};
+constexpr uint16_t ironblack_samples[] = {0xFFFF, 0xBDF7, 0x7BEF, 0x39E7, 0x0001, 0x7011, 0xE1C6, 0xF541, 0xFFE3};
+constexpr uint16_t cam_samples[]       = {0x480F, 0x0011, 0x02D3, 0x0572, 0x05E6, 0x3E60, 0xBEE0, 0xEC00, 0xF800};
+
+void compare(const Palette<PaletteFormat::RGB565>& p, const uint16_t* samples, const char* name)
+{
+    for (int i = 0; i < 9; ++i) {
+        const uint8_t idx = (i < 8) ? i * 32 : 255;
+        const uint16_t a  = p[idx];
+        const uint16_t b  = samples[i];
+        // Within 2 steps of RGB565 for every channel
+        EXPECT_LE(std::abs((a >> 11) - (b >> 11)), 2) << name << ":" << (int)idx;
+        EXPECT_LE(std::abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F)), 2) << name << ":" << (int)idx;
+        EXPECT_LE(std::abs((a & 0x1F) - (b & 0x1F)), 2) << name << ":" << (int)idx;
+    }
+}
+
+}  // namespace
+
+TEST(Palette, Builtin)
+{
+    compare(P565::iron, golden_samples, "iron");
+    compare(P565::rainbow, rainbow_samples, "rainbow");
+    compare(P565::grayscale, grayscale_samples, "grayscale");
+    compare(P565::iron_black, ironblack_samples, "iron_black");
+    compare(P565::cam, cam_samples, "cam");
+
+    EXPECT_EQ(P565::high_contrast[0], 0x0000);
+    EXPECT_EQ(P565::high_contrast[36], 0x001F);
+    EXPECT_EQ(P565::high_contrast[255], 0xFFFF);
+    EXPECT_EQ(P565::iron.size(), 256U);
+    EXPECT_EQ(P565::iron.data()[128], P565::iron[128]);
+}
+
+TEST(Palette, Formats)
+{
+    using P888  = Palettes<PaletteFormat::RGB888>;
+    using PARGB = Palettes<PaletteFormat::ARGB8888>;
+    using P565S = Palettes<PaletteFormat::RGB565BE>;
+    for (int i = 0; i < 256; ++i) {
+        const uint32_t c = P888::rainbow[i];
+        const uint16_t e = ((c >> 19) << 11) | (((c >> 10) & 0x3F) << 5) | ((c >> 3) & 0x1F);
+        EXPECT_EQ(P565::rainbow[i], e) << i;
+        EXPECT_EQ(PARGB::rainbow[i], 0xFF000000U | c) << i;
+        EXPECT_EQ(P565S::rainbow[i], (uint16_t)((e >> 8) | (e << 8))) << i;
+    }
+    // Grayscale is linear
+    for (int i = 0; i < 256; ++i) {
+        EXPECT_EQ(P888::grayscale[i], (uint32_t)i * 0x010101U) << i;
+    }
+}
+
+TEST(Palette, Custom)
+{
+    constexpr PaletteStop fire[] = {{0, 0x00, 0x00, 0x00}, {128, 0xFF, 0x00, 0x00}, {255, 0xFF, 0xFF, 0x00}};
+    constexpr auto p             = make_palette<PaletteFormat::RGB888>(fire);
+    static_assert(p[128] == 0xFF0000, "Not constexpr");
+    EXPECT_EQ(p[0], 0x000000U);
+    EXPECT_EQ(p[64], 0x800000U);
+    EXPECT_EQ(p[255], 0xFFFF00U);
+    for (int i = 1; i < 256; ++i) {
+        EXPECT_GE(p[i], p[i - 1]) << i;
+    }
+
+    // Stops not at the ends extend the end colours
+    constexpr PaletteStop mid[] = {{64, 0x00, 0x00, 0xFF}, {192, 0xFF, 0x00, 0x00}};
+    constexpr auto q            = make_palette<PaletteFormat::RGB888>(mid);
+    EXPECT_EQ(q[0], 0x0000FFU);
+    EXPECT_EQ(q[64], 0x0000FFU);
+    EXPECT_EQ(q[192], 0xFF0000U);
+    EXPECT_EQ(q[255], 0xFF0000U);
+
+    constexpr PaletteStop one[] = {{0, 0x12, 0x34, 0x56}};
+    constexpr auto r            = make_palette<PaletteFormat::RGB888>(one);
+    EXPECT_EQ(r[0], 0x123456U);
+    EXPECT_EQ(r[255], 0x123456U);
+}
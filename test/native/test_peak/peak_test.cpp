@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for sub-pixel peak
+*/
+#include <gtest/gtest.h>
+#include <thermal2/peak.hpp>
+#include <chrono>
+#include <cmath>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(25 + 64) * 128};
+constexpr float amplitude{1280.0f};
+
+// Gaussian hot spot, returns the true peak
+float render(uint16_t* frame, const float cx, const float cy, const float sigma = 1.2f)
+{
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            const float d2             = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+            frame[y * frame_width + x] =
+                (uint16_t)std::lround(base_raw + amplitude * std::exp(-d2 / (2 * sigma * sigma)));
+        }
+    }
+    return base_raw + amplitude;
+}
+
+void extract(uint16_t* raw, const uint16_t* frame, const uint8_t sp)
+{
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        raw[i] = frame[subpage_to_frame_index(sp, i)];
+    }
+}
+
+}  // namespace
+
+TEST(Peak, Frame)
+{
+    uint16_t frame[frame_pixels]{};
+    SubpixelPeak p{};
+
+    for (auto&& fit : {PeakFit::Quadratic, PeakFit::Centroid}) {
+        float max_err{};
+        for (float cy = 3.0f; cy <= 20.0f; cy += 0.37f) {
+            for (float cx = 3.0f; cx <= 28.0f; cx += 0.29f) {
+                const float peak = render(frame, cx, cy);
+                const uint8_t px = (uint8_t)std::lround(cx);
+                const uint8_t py = (uint8_t)std::lround(cy);
+                ASSERT_TRUE(subpixel_peak(p, frame, px, py, fit));
+                EXPECT_EQ(p.px, px);
+                EXPECT_EQ(p.py, py);
+                max_err = std::fmax(max_err, std::hypot(p.x - cx, p.y - cy));
+                // Closer than the pixel itself
+                const uint16_t c = frame[py * frame_width + px];
+                EXPECT_GE(p.value, c);
+                EXPECT_LE(std::fabs(p.value - peak), std::fabs(c - peak) + 0.5f);
+                EXPECT_NEAR(p.value, peak, amplitude * 0.08f);
+            }
+        }
+        EXPECT_LT(max_err, fit == PeakFit::Quadratic ? 0.1f : 0.3f);
+    }
+
+    // Climbs to the local maximum from a stale coordinate
+    render(frame, 10.3f, 12.6f);
+    EXPECT_TRUE(subpixel_peak(p, frame, 8, 11));
+    EXPECT_EQ(p.px, 10);
+    EXPECT_EQ(p.py, 13);
+    EXPECT_NEAR(p.x, 10.3f, 0.25f);
+    EXPECT_NEAR(p.y, 12.6f, 0.25f);
+
+    // Corner (no neighbours on one side)
+    render(frame, 0.0f, 0.0f);
+    EXPECT_TRUE(subpixel_peak(p, frame, 0, 0));
+    EXPECT_FLOAT_EQ(p.x, 0.0f);
+    EXPECT_FLOAT_EQ(p.y, 0.0f);
+
+    // Flat
+    std::fill(std::begin(frame), std::end(frame), base_raw);
+    EXPECT_TRUE(subpixel_peak(p, frame, 5, 5, PeakFit::Centroid));
+    EXPECT_FLOAT_EQ(p.x, 5.0f);
+    EXPECT_FLOAT_EQ(p.y, 5.0f);
+    EXPECT_FLOAT_EQ(p.value, base_raw);
+
+    EXPECT_FALSE(subpixel_peak(p, frame, 32, 0));
+    EXPECT_FALSE(subpixel_peak(p, frame, 0, 24));
+}
+
+TEST(Peak, Subpage)
+{
+    uint16_t frame[frame_pixels]{}, raw[subpage_pixels]{};
+    SubpixelPeak p{};
+
+    for (auto&& fit : {PeakFit::Quadratic, PeakFit::Centroid}) {
+        float max_err{};
+        for (float cy = 3.0f; cy <= 20.0f; cy += 0.37f) {
+            for (float cx = 3.0f; cx <= 28.0f; cx += 0.29f) {
+                render(frame, cx, cy, 1.5f);
+                for (uint8_t sp = 0; sp < 2; ++sp) {
+                    extract(raw, frame, sp);
+                    // The nearest pixel of the subpage
+                    uint8_t px = (uint8_t)std::lround(cx);
+                    uint8_t py = (uint8_t)std::lround(cy);
+                    if (!is_subpage_pixel(sp, px, py)) {
+                        EXPECT_FALSE(subpixel_peak(p, raw, sp, px, py, fit));
+                        px += (cx > px) ? 1 : -1;
+                    }
+                    ASSERT_TRUE(subpixel_peak(p, raw, sp, px, py, fit));
+                    max_err = std::fmax(max_err, std::hypot(p.x - cx, p.y - cy));
+                }
+            }
+        }
+        EXPECT_LT(max_err, fit == PeakFit::Quadratic ? 0.3f : 0.4f);
+    }
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Peak, DISABLED_Benchmark)
+{
+    uint16_t frame[frame_pixels]{};
+    render(frame, 15.4f, 11.7f);
+    SubpixelPeak p{};
+    constexpr uint32_t loops{100000};
+    float guard{};
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        subpixel_peak(p, frame, 15, 12);
+        guard += p.x;
+    }
+    const double ns =
+        std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / loops;
+    printf("%.1f ns/call\n", ns);
+    EXPECT_GT(guard, 0.0f);
+}
@@ -0,0 +1,351 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for Pipeline
+*/
+#include <gtest/gtest.h>
+#include <thermal2/stages.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace m5::unit::thermo;
+using namespace m5::unit::thermal2;
+
+namespace {
+
+// Lookalikes of the Data of the units
+struct ncir2_data_t {
+    int16_t celsius;
+    inline float temperature() const
+    {
+        return celsius;
+    }
+};
+struct mlx_data_t {
+    float object;
+    inline float objectTemperature() const
+    {
+        return object;
+    }
+};
+struct thermal2_data_t {
+    uint8_t subpage{};
+    uint16_t temp[8]{};
+    uint16_t raw[subpage_pixels]{};
+    bool torn{};
+};
+
+// Port with a transmit buffer drained by hand
+struct port_t {
+    std::vector<uint8_t> written{};
+    size_t capacity{4096}, queued{};
+
+    int availableForWrite() const
+    {
+        return (int)(capacity - queued);
+    }
+    size_t write(const uint8_t* data, const size_t len)
+    {
+        const size_t n = std::min(len, capacity - queued);
+        written.insert(written.end(), data, data + n);
+        queued += n;
+        return n;
+    }
+};
+
+struct fake_clock_t {
+    uint32_t* now;
+    uint32_t operator()() const
+    {
+        return *now;
+    }
+};
+
+void fill(thermal2_data_t& d, const uint8_t subpage, const int t)
+{
+    d.subpage = subpage;
+    d.temp[0] = 0x1000 + t;
+    for (uint16_t i = 0; i < subpage_pixels; ++i) {
+        d.raw[i] = (uint16_t)(11000 + i * 3 + t * 5);
+    }
+}
+
+}  // namespace
+
+TEST(Pipeline, Chain)
+{
+    std::vector<float> out{};
+    auto p = make_pipeline(filter([](const ncir2_data_t& d) { return d.celsius >= 0; }),
+                           transform([](const ncir2_data_t& d) { return d.temperature() * 2; }),
+                           callback([&out](const float v) { out.push_back(v); }));
+    for (int16_t c : {-3, 1, 5, -1, 7}) {
+        EXPECT_TRUE(p.push(ncir2_data_t{c}));
+    }
+    EXPECT_EQ(out, (std::vector<float>{2, 10, 14}));
+    EXPECT_EQ(p.stats().pushed, 5U);
+    EXPECT_EQ(p.stats().refused, 0U);
+
+    // Refused by a callback
+    uint32_t calls{}, after{};
+    auto q = make_pipeline(callback([&calls](const int v) {
+                               ++calls;
+                               return v != 2;
+                           }),
+                           callback([&after](const int) { ++after; }));
+    EXPECT_TRUE(q.push(1));
+    EXPECT_FALSE(q.push(2));
+    EXPECT_EQ(calls, 2U);
+    EXPECT_EQ(after, 2U);  // A sink passes on even when refusing
+    EXPECT_EQ(q.stats().refused, 1U);
+}
+
+TEST(Pipeline, Statistics)
+{
+    auto p = make_pipeline(statistics([](const mlx_data_t& d) { return d.objectTemperature(); }),
+                           filter([](const mlx_data_t& d) { return d.object > 30.f; }),
+                           statistics([](const mlx_data_t& d) { return d.objectTemperature(); }));
+    EXPECT_TRUE(std::isnan(p.get<0>().mean()));
+    for (float v : {25.f, 40.f, NAN, 35.f, 20.f}) {
+        p.push(mlx_data_t{v});
+    }
+    auto& all = p.get<0>();
+    EXPECT_EQ(all.count(), 4U);
+    EXPECT_FLOAT_EQ(all.minimum(), 20.f);
+    EXPECT_FLOAT_EQ(all.maximum(), 40.f);
+    EXPECT_FLOAT_EQ(all.mean(), 30.f);
+    auto& hot = p.get<2>();
+    EXPECT_EQ(hot.count(), 2U);
+    EXPECT_FLOAT_EQ(hot.mean(), 37.5f);
+    all.reset();
+    EXPECT_EQ(all.count(), 0U);
+}
+
+TEST(Pipeline, BackPressure)
+{
+    uint32_t now{};
+    port_t port{};
+    port.capacity = stream_packet_size * 3;
+    auto p        = make_pipeline(stream_stage(fake_clock_t{&now}, true), port_sink(port, stream_packet_size));
+
+    // Subpages wait while the port is full, as they would in the ring buffer of the unit
+    std::vector<thermal2_data_t> ring(40);
+    for (size_t i = 0; i < ring.size(); ++i) {
+        fill(ring[i], i & 1, (int)i);
+    }
+    size_t head{};
+    StreamDecoder decoder{};
+    uint32_t decoded{};
+    while (head < ring.size()) {
+        while (head < ring.size() && p.ready()) {
+            ++now;
+            EXPECT_TRUE(p.push(ring[head++]));
+        }
+        EXPECT_LE(port.queued, port.capacity);
+        for (auto b : port.written) {
+            if (decoder.push(b)) {
+                EXPECT_EQ(0, std::memcmp(decoder.packet().raw, ring[decoded].raw, sizeof(ring[decoded].raw)));
+                ++decoded;
+            }
+        }
+        port.written.clear();
+        port.queued = 0;  // Drained
+    }
+    EXPECT_EQ(decoded, ring.size());
+    EXPECT_EQ(p.stats().refused, 0U);
+    EXPECT_EQ(decoder.stats().dropped, 0U);
+
+    // A refused packet makes the next ones keyframes
+    port.capacity = 16;
+    EXPECT_FALSE(p.push(ring[0]));
+    port.capacity = 4096;
+    decoder.reset();
+    for (auto b : port.written) {
+        decoder.push(b);
+    }
+    port.written.clear();
+    port.queued = 0;
+    EXPECT_TRUE(p.push(ring[1]));
+    EXPECT_TRUE(p.push(ring[2]));
+    uint32_t packets{};
+    for (auto b : port.written) {
+        packets += decoder.push(b);
+    }
+    EXPECT_EQ(packets, 2U);
+    EXPECT_EQ(decoder.stats().unsynced, 0U);
+}
+
+TEST(Pipeline, FileSink)
+{
+    FILE* fp = std::tmpfile();
+    ASSERT_NE(fp, nullptr);
+
+    uint32_t now{};
+    RecordingHeader header{};
+    header.refresh_rate = 4;
+    auto p = make_pipeline(filter([](const thermal2_data_t& d) { return !d.torn; }),
+                           recording_stage(fake_clock_t{&now}, header), FileSink(fp, true));
+    EXPECT_TRUE(p.ready());
+
+    thermal2_data_t d{};
+    uint32_t kept{};
+    for (int i = 0; i < 100; ++i) {
+        fill(d, i & 1, i);
+        d.torn = (i % 10) == 9;
+        kept += !d.torn;
+        now = i * 125;
+        EXPECT_TRUE(p.push(d));
+    }
+    EXPECT_TRUE(p.get<1>().finish(p.get<2>()));
+
+    std::vector<uint8_t> bytes((size_t)std::ftell(fp));
+    std::rewind(fp);
+    ASSERT_EQ(std::fread(bytes.data(), 1, bytes.size(), fp), bytes.size());
+    std::fclose(fp);
+    EXPECT_EQ(bytes.size(), p.get<1>().writer().offset());
+
+    RecordingReader reader{};
+    ASSERT_TRUE(reader.open(bytes.data(), bytes.size()));
+    EXPECT_EQ(reader.header().refresh_rate, 4);
+    EXPECT_TRUE(reader.header().compressed);
+    RecordedSubpage s{};
+    uint32_t count{};
+    while (reader.next(s)) {
+        EXPECT_FALSE(s.torn());
+        ++count;
+    }
+    EXPECT_EQ(count, kept);
+    EXPECT_EQ(s.timestamp, 98U * 125);
+    EXPECT_EQ(s.raw[10], 11000 + 30 + 98 * 5);
+}
+
+TEST(Pipeline, RecordingRefused)
+{
+    // A file that refuses the header once and some of the subpages
+    std::vector<uint8_t> file{};
+    uint32_t writes{}, refused{};
+    auto sink = [&](const Bytes& b) {
+        if (writes++ % 7 == 0) {
+            ++refused;
+            return false;
+        }
+        file.insert(file.end(), b.data, b.data + b.size);
+        return true;
+    };
+
+    uint32_t now{};
+    RecordingWriter::config_t cfg{};
+    cfg.sync_interval = 4;
+    cfg.index_entries = 2;
+    auto p = make_pipeline(recording_stage(fake_clock_t{&now}, RecordingHeader{}, cfg), callback(sink));
+
+    thermal2_data_t d{};
+    EXPECT_FALSE(p.push(d));  // The header
+    std::vector<int> kept{};
+    for (int i = 0; i < 100; ++i) {
+        fill(d, i & 1, i);
+        now = i * 125;
+        if (p.push(d)) {
+            kept.push_back(i);
+        }
+    }
+    EXPECT_TRUE(p.get<0>().finish(p.get<1>()));
+    EXPECT_GT(refused, 10U);
+    EXPECT_EQ(file.size(), p.get<0>().writer().offset());
+
+    // Every subpage taken decodes, none of the refused ones
+    RecordingReader reader{};
+    ASSERT_TRUE(reader.open(file.data(), file.size()));
+    RecordedSubpage s{};
+    size_t count{};
+    while (reader.next(s)) {
+        ASSERT_LT(count, kept.size());
+        EXPECT_EQ(s.timestamp, (uint32_t)kept[count] * 125);
+        EXPECT_EQ(s.raw[10], 11000 + 30 + kept[count] * 5);
+        ++count;
+    }
+    EXPECT_EQ(count, kept.size());
+    EXPECT_TRUE(reader.seek(kept[kept.size() / 2] * 125));
+    ASSERT_TRUE(reader.next(s));
+    EXPECT_LE(s.timestamp, (uint32_t)kept[kept.size() / 2] * 125);
+}
+
+TEST(Pipeline, ByHand)
+{
+    // The chain gives what the same work written by hand does
+    double sum{}, sum2{}, total{};
+    uint32_t count{};
+    float lo{}, hi{};
+    auto p = make_pipeline(filter([](const ncir2_data_t& d) { return d.celsius >= 0; }),
+                           statistics([](const ncir2_data_t& d) { return d.temperature(); }),
+                           callback([&sum](const ncir2_data_t& d) { sum += d.celsius; }));
+    for (int i = 0; i < 4096; ++i) {
+        const int16_t v = (int16_t)((i * 37) % 200) - 50;
+        p.push(ncir2_data_t{v});
+        if (v >= 0) {
+            lo = (!count || v < lo) ? v : lo;
+            hi = (!count || v > hi) ? v : hi;
+            total += v;
+            ++count;
+            sum2 += v;
+        }
+    }
+    EXPECT_EQ(sum, sum2);
+    EXPECT_EQ(p.get<1>().count(), count);
+    EXPECT_FLOAT_EQ(p.get<1>().mean(), (float)(total / count));
+    EXPECT_FLOAT_EQ(p.get<1>().maximum(), hi);
+    EXPECT_FLOAT_EQ(p.get<1>().minimum(), lo);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Pipeline, DISABLED_Benchmark)
+{
+    // Compile-time chain against the same work written by hand
+    std::vector<int16_t> values(1 << 20);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = (int16_t)((i * 37) % 200) - 50;
+    }
+
+    auto started = std::chrono::high_resolution_clock::now();
+    double sum{};
+    auto p = make_pipeline(filter([](const ncir2_data_t& d) { return d.celsius >= 0; }),
+                           statistics([](const ncir2_data_t& d) { return d.temperature(); }),
+                           callback([&sum](const ncir2_data_t& d) { sum += d.celsius; }));
+    for (auto v : values) {
+        p.push(ncir2_data_t{v});
+    }
+    const auto pipeline_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+
+    started = std::chrono::high_resolution_clock::now();
+    double sum2{}, total{};
+    uint32_t count{};
+    float lo{}, hi{};
+    for (auto v : values) {
+        if (v >= 0) {
+            lo = (!count || v < lo) ? v : lo;
+            hi = (!count || v > hi) ? v : hi;
+            total += v;
+            ++count;
+            sum2 += v;
+        }
+    }
+    const auto hand_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+
+    EXPECT_EQ(sum, sum2);
+    EXPECT_EQ(p.get<1>().count(), count);
+    EXPECT_FLOAT_EQ(p.get<1>().mean(), (float)(total / count));
+    EXPECT_FLOAT_EQ(p.get<1>().maximum(), hi);
+    EXPECT_FLOAT_EQ(p.get<1>().minimum(), lo);
+    printf("Pipeline: %.2f ns/value, by hand: %.2f ns/value\n", (double)pipeline_ns / values.size(),
+           (double)hand_ns / values.size());
+}
@@ -0,0 +1,286 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for PixelHealth
+*/
+#include <gtest/gtest.h>
+#include <thermal2/pixel_health.hpp>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(25 + 64) * 128};  // 25 celsius
+
+constexpr uint16_t dead_idx{2 * frame_width + 3};
+constexpr uint16_t stuck_idx{12 * frame_width + 20};
+constexpr uint16_t popping_idx{15 * frame_width + 7};
+constexpr uint16_t noisy_idx{20 * frame_width + 30};
+constexpr uint16_t edge_idx{0};                       // Popping corner, fewer neighbours
+constexpr uint16_t hot_idx{18 * frame_width + 26};     // Real hot object, not a fault
+constexpr uint32_t hot_from{48};                      // Appears after the warm-up
+constexpr uint16_t hot_delta{1280};                   // 10 celsius
+constexpr uint_fast8_t walker_w{6}, walker_h{8};      // Person walking across rows 2-9
+
+class MemoryStorage : public PixelHealthStorage {
+public:
+    bool load(uint32_t* bitmap) override
+    {
+        if (!saved) {
+            return false;
+        }
+        std::memcpy(bitmap, data, sizeof(data));
+        return true;
+    }
+    bool save(const uint32_t* bitmap) override
+    {
+        std::memcpy(data, bitmap, sizeof(data));
+        saved = true;
+        return true;
+    }
+    uint32_t data[frame_height]{};
+    bool saved{};
+};
+
+// Slowly drifting gradient scene with a hot object, a person walking across and a few broken pixels
+struct scene_t {
+    std::default_random_engine rng{};
+    std::normal_distribution<float> noise{0.0f, 8.0f};
+    std::normal_distribution<float> wild{0.0f, 128.0f};
+    std::bernoulli_distribution pop{0.5};
+    bool broken{true};
+    bool popping{true};
+
+    uint16_t truth(const uint32_t t, const uint_fast16_t idx) const
+    {
+        const uint_fast8_t x = idx % frame_width;
+        const uint_fast8_t y = idx / frame_width;
+        uint16_t v           = base_raw + x * 16 + y * 8 + (t % 64) * 2;
+        if (idx == hot_idx && t >= hot_from) {
+            v += hot_delta;
+        }
+        const int_fast16_t wx = (int_fast16_t)(t % 48) - walker_w;
+        if (x >= wx && x < wx + walker_w && y >= 2 && y < 2 + walker_h) {
+            v += hot_delta;
+        }
+        return v;
+    }
+    void generate(const uint32_t t, uint16_t* frame)
+    {
+        for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+            frame[i] = (uint16_t)std::lround(truth(t, i) + noise(rng));
+        }
+        if (broken) {
+            frame[dead_idx]  = 0;
+            frame[stuck_idx] = truth(0, stuck_idx);
+            frame[noisy_idx] = (uint16_t)std::lround(truth(t, noisy_idx) + wild(rng));
+            if (popping) {
+                frame[popping_idx] += pop(rng) ? 1280 : 0;
+                frame[edge_idx] += pop(rng) ? 1280 : 0;
+            }
+        }
+    }
+};
+
+void extract(uint16_t* raw, const uint16_t* frame, const uint8_t sp)
+{
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        raw[i] = frame[subpage_to_frame_index(sp, i)];
+    }
+}
+
+void feed(PixelHealth& ph, scene_t& scene, const uint32_t frames)
+{
+    uint16_t frame[frame_pixels]{}, raw[subpage_pixels]{};
+    for (uint32_t t = 0; t < frames; ++t) {
+        scene.generate(t, frame);
+        for (uint8_t sp = 0; sp < 2; ++sp) {
+            extract(raw, frame, sp);
+            ph.update(raw, sp);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(PixelHealth, Detection)
+{
+    PixelHealth ph{};
+    scene_t scene{};
+
+    // Nothing during the warm-up
+    feed(ph, scene, ph.config().warmup);
+    EXPECT_EQ(ph.count(), 0U);
+    EXPECT_FALSE(ph.dirty());
+
+    feed(ph, scene, 160);
+    EXPECT_TRUE(ph.dirty());
+    EXPECT_EQ(ph.count(), 5U);
+    EXPECT_EQ(ph.reason(dead_idx), PixelHealth::Reason::Dead);
+    EXPECT_EQ(ph.reason(stuck_idx), PixelHealth::Reason::Stuck);
+    EXPECT_EQ(ph.reason(popping_idx), PixelHealth::Reason::Outlier);
+    EXPECT_EQ(ph.reason(noisy_idx), PixelHealth::Reason::Noisy);
+    EXPECT_EQ(ph.reason(edge_idx), PixelHealth::Reason::Outlier);
+    EXPECT_TRUE(ph.isBad(3, 2));
+    EXPECT_FALSE(ph.isBad(4, 2));
+    // The hot object and the person are real
+    EXPECT_FALSE(ph.isBad(hot_idx));
+    for (uint_fast8_t y = 2; y < 2 + walker_h + 2; ++y) {
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            const uint_fast16_t idx = y * frame_width + x;
+            if (idx != dead_idx) {
+                EXPECT_FALSE(ph.isBad(idx)) << (int)x << "," << (int)y;
+            }
+        }
+    }
+
+    // Popping stops, the learned flags expire but dead and stuck stay
+    scene.popping = false;
+    feed(ph, scene, 160);
+    EXPECT_EQ(ph.count(), 3U);
+    EXPECT_EQ(ph.reason(popping_idx), PixelHealth::Reason::None);
+    EXPECT_EQ(ph.reason(edge_idx), PixelHealth::Reason::None);
+    EXPECT_EQ(ph.reason(dead_idx), PixelHealth::Reason::Dead);
+    EXPECT_EQ(ph.reason(stuck_idx), PixelHealth::Reason::Stuck);
+    EXPECT_EQ(ph.reason(noisy_idx), PixelHealth::Reason::Noisy);
+
+    // Manual marks are sticky
+    ph.mark(popping_idx);
+    feed(ph, scene, 64);
+    EXPECT_EQ(ph.reason(popping_idx), PixelHealth::Reason::Manual);
+
+    // A healthy scene with the same seed flags nothing
+    PixelHealth healthy{};
+    scene_t clean{};
+    clean.broken = false;
+    feed(healthy, clean, 256);
+    EXPECT_EQ(healthy.count(), 0U);
+
+    // Learning disabled
+    PixelHealth::config_t cfg{};
+    cfg.learn = false;
+    PixelHealth manual(cfg);
+    scene_t scene2{};
+    feed(manual, scene2, 128);
+    EXPECT_EQ(manual.count(), 0U);
+}
+
+TEST(PixelHealth, Interpolation)
+{
+    PixelHealth ph{};
+    scene_t scene{};
+    feed(ph, scene, 216);  // The person is away from the broken pixels
+    ASSERT_EQ(ph.count(), 5U);
+
+    uint16_t frame[frame_pixels]{};
+    scene.generate(216, frame);
+    uint16_t raw[2][subpage_pixels]{};
+    for (uint8_t sp = 0; sp < 2; ++sp) {
+        extract(raw[sp], frame, sp);
+        ph.update(raw[sp], sp);
+        ph.interpolate(raw[sp], sp);
+    }
+    // Full frame
+    uint16_t full[frame_pixels]{};
+    std::memcpy(full, frame, sizeof(full));
+    ph.interpolate(full);
+
+    for (auto&& idx : {dead_idx, stuck_idx, popping_idx, noisy_idx, edge_idx}) {
+        EXPECT_NEAR(full[idx], scene.truth(216, idx), 32) << idx;
+        const uint8_t sp = ((idx % frame_width) + (idx / frame_width)) & 1;
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            if (subpage_to_frame_index(sp, i) == idx) {
+                EXPECT_NEAR(raw[sp][i], scene.truth(216, idx), 32) << idx;
+            }
+        }
+    }
+    // Good pixels are left as is
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        if (!ph.isBad(i)) {
+            EXPECT_EQ(full[i], frame[i]);
+        }
+    }
+
+    // Summary without the bad pixels, the hot object is still the highest
+    FrameSummary s{}, all{};
+    EXPECT_TRUE(ph.summarize(s));
+    EXPECT_TRUE(summarize(all, frame));
+    EXPECT_EQ(s.count, frame_pixels - 5);
+    EXPECT_EQ(all.count, frame_pixels);
+    EXPECT_EQ(all.lowest, 0);
+    EXPECT_NE(s.lowest, 0);
+    EXPECT_EQ(s.highest, frame[hot_idx]);
+    EXPECT_EQ(s.highest_x + s.highest_y * frame_width, hot_idx);
+}
+
+TEST(PixelHealth, Summary)
+{
+    uint16_t frame[frame_pixels]{};
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        frame[i] = 1000 + i;
+    }
+    frame[5 * frame_width + 6] = 5000;
+    FrameSummary s{};
+    EXPECT_TRUE(summarize(s, frame));
+    EXPECT_EQ(s.lowest, 1000);
+    EXPECT_EQ(s.lowest_x, 0);
+    EXPECT_EQ(s.lowest_y, 0);
+    EXPECT_EQ(s.highest, 5000);
+    EXPECT_EQ(s.highest_x, 6);
+    EXPECT_EQ(s.highest_y, 5);
+    EXPECT_EQ(s.most_diff, 5000);
+    EXPECT_EQ(s.median, 1000 + 385);  // 1166 was replaced
+
+    uint32_t mask[frame_height]{};
+    std::fill(std::begin(mask), std::end(mask), 0xFFFFFFFF);
+    EXPECT_FALSE(summarize(s, frame, mask));
+    EXPECT_EQ(s.count, 0);
+    mask[5] = ~(1U << 6);
+    EXPECT_TRUE(summarize(s, frame, mask));
+    EXPECT_EQ(s.count, 1);
+    EXPECT_EQ(s.median, 5000);
+    EXPECT_EQ(s.average, 5000);
+}
+
+TEST(PixelHealth, Storage)
+{
+    PixelHealth ph{};
+    MemoryStorage storage{};
+    FrameSummary s{};
+    EXPECT_FALSE(ph.assembled());
+    EXPECT_FALSE(ph.summarize(s));
+
+    EXPECT_FALSE(ph.load(storage));
+
+    ph.mark(100);
+    ph.mark(767);
+    ph.mark(768);  // Out of range
+    EXPECT_EQ(ph.count(), 2U);
+    EXPECT_TRUE(ph.dirty());
+    EXPECT_EQ(ph.reason(100), PixelHealth::Reason::Manual);
+
+    EXPECT_TRUE(ph.save(storage));
+    EXPECT_FALSE(ph.dirty());
+
+    PixelHealth restored{};
+    EXPECT_TRUE(restored.load(storage));
+    EXPECT_FALSE(restored.dirty());
+    EXPECT_EQ(restored.count(), 2U);
+    EXPECT_TRUE(restored.isBad(100));
+    EXPECT_TRUE(restored.isBad(31, 23));
+    EXPECT_TRUE(std::equal(ph.bitmap(), ph.bitmap() + frame_height, restored.bitmap()));
+
+    restored.mark(100, false);
+    EXPECT_TRUE(restored.dirty());
+    EXPECT_FALSE(restored.isBad(100));
+    EXPECT_EQ(restored.reason(100), PixelHealth::Reason::None);
+
+    restored.clear();
+    EXPECT_EQ(restored.count(), 0U);
+}
@@ -0,0 +1,176 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for ReadyPredictor
+*/
+#include <gtest/gtest.h>
+#include <utility/ready_predictor.hpp>
+#include <cmath>
+#include <random>
+
+using namespace m5::unit::thermo;
+
+namespace {
+
+// Sensor that raises a ready flag every period_us (with jitter), cleared on read
+struct sensor_t {
+    uint32_t period_us;
+    uint32_t offset_us;
+    int32_t jitter_us;
+    std::default_random_engine rng{};
+    uint64_t next_us{};
+    bool flag{};
+    uint64_t ready_at_us{};
+
+    void start()
+    {
+        next_us = offset_us;
+    }
+    void step(const uint64_t now_us)
+    {
+        if (now_us >= next_us) {
+            flag        = true;
+            ready_at_us = next_us;
+            std::uniform_int_distribution<int32_t> dist(-jitter_us, jitter_us);
+            next_us += period_us + (jitter_us ? dist(rng) : 0);
+        }
+    }
+};
+
+struct result_t {
+    uint32_t polls{}, reads{};
+    double latency_ms{};
+};
+
+// Drive with a 250us update loop, like a busy loop()
+template <typename F>
+result_t run(sensor_t& s, const uint32_t duration_ms, F&& poll_due, ReadyPredictor* rp)
+{
+    result_t r{};
+    s.start();
+    for (uint64_t now_us = 0; now_us < duration_ms * 1000ULL; now_us += 250) {
+        s.step(now_us);
+        const uint32_t now = now_us / 1000;
+        if (!poll_due(now)) {
+            continue;
+        }
+        ++r.polls;
+        if (s.flag) {
+            s.flag = false;
+            ++r.reads;
+            r.latency_ms += (now_us - s.ready_at_us) / 1000.0;
+            if (rp) {
+                rp->ready(now);
+            }
+        } else if (rp) {
+            rp->miss(now);
+        }
+    }
+    r.latency_ms /= r.reads ? r.reads : 1;
+    return r;
+}
+
+}  // namespace
+
+TEST(ReadyPredictor, Basic)
+{
+    ReadyPredictor rp;
+    rp.reset(100);
+    EXPECT_TRUE(rp.due(0));
+    EXPECT_FLOAT_EQ(rp.period(), 100.f);
+    EXPECT_FALSE(rp.locked());
+
+    rp.miss(10);
+    rp.ready(12);
+    EXPECT_FALSE(rp.due(12));
+    EXPECT_FALSE(rp.due(100));
+    EXPECT_TRUE(rp.due(rp.nextPollAt()));
+    EXPECT_EQ(rp.stats().polls, 2U);
+    EXPECT_EQ(rp.stats().misses, 1U);
+
+    rp.reset(100);
+    EXPECT_EQ(rp.stats().polls, 0U);
+    EXPECT_TRUE(rp.due(0));
+}
+
+TEST(ReadyPredictor, Cadence)
+{
+    // Nominal 1000/64 = 15ms, actual 15.625ms
+    sensor_t s{15625, 3300, 0};
+    ReadyPredictor rp;
+    rp.reset(15);
+    auto pr = run(s, 10 * 1000, [&rp](const uint32_t now) { return rp.due(now); }, &rp);
+
+    // Fixed interval polling as UnitThermal2 used to do
+    sensor_t s2{15625, 3300, 0};
+    uint32_t latest{};
+    bool polled{};
+    auto fr = run(
+        s2, 10 * 1000,
+        [&](const uint32_t now) {
+            if (!polled || now >= latest + 15) {
+                polled = true;
+                if (s2.flag) {
+                    latest = now;
+                }
+                return true;
+            }
+            return false;
+        },
+        nullptr);
+
+    EXPECT_NEAR(rp.period(), 15.625f, 0.2f);
+    EXPECT_TRUE(rp.locked());
+    EXPECT_GE(pr.reads + 2, fr.reads);
+    EXPECT_LT(pr.polls, fr.polls);
+    EXPECT_LT(pr.latency_ms, 2.0);
+    EXPECT_LT(rp.stats().misses * 4, rp.stats().polls);
+}
+
+TEST(ReadyPredictor, Drift)
+{
+    for (auto&& period_us : {480000U, 500000U, 521000U}) {
+        sensor_t s{period_us, 123000, 1000};
+        ReadyPredictor rp;
+        rp.reset(500);
+        auto r = run(s, 120 * 1000, [&rp](const uint32_t now) { return rp.due(now); }, &rp);
+        EXPECT_NEAR(rp.period(), period_us / 1000.f, 2.0f) << period_us;
+        EXPECT_LT(std::fabs(rp.drift()), 10.0f) << period_us;
+        EXPECT_LT(r.latency_ms, 15.0) << period_us;
+        EXPECT_LT(r.polls, r.reads * 3) << period_us;
+        EXPECT_GE(r.reads + 1, 120 * 1000 * 1000U / period_us) << period_us;
+    }
+}
+
+TEST(ReadyPredictor, LongGap)
+{
+    // Locks before the millisecond clock wraps, then pauses for hours as a stopped measurement does
+    for (auto&& start : {0U, 0xFFFF0000U}) {
+        ReadyPredictor rp;
+        rp.reset(500);
+        uint32_t now = start;
+        for (int i = 0; i < 100; ++i) {
+            now = start + i * 500;
+            rp.miss(now - 2);
+            rp.ready(now);
+        }
+        EXPECT_TRUE(rp.locked()) << start;
+        EXPECT_FALSE(rp.due(now + 100)) << start;
+
+        for (auto&& gap : {3U * 3600 * 1000, 7U * 3600 * 1000, 20U * 24 * 3600 * 1000}) {
+            const uint32_t resumed = now + gap;
+            EXPECT_TRUE(rp.due(resumed)) << start << ',' << gap;
+            for (int i = 0; i < 20; ++i) {
+                now = resumed + i * 500;
+                rp.miss(now - 2);
+                rp.ready(now);
+            }
+            EXPECT_NEAR(rp.period(), 500.f, 2.0f) << start << ',' << gap;
+            EXPECT_FALSE(rp.due(now + 100)) << start << ',' << gap;
+            EXPECT_TRUE(rp.due(now + 502)) << start << ',' << gap;
+        }
+    }
+}
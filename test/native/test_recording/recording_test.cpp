@@ -0,0 +1,263 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for RecordingWriter/RecordingReader
+*/
+#include <gtest/gtest.h>
+#include <thermal2/recording.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(22 + 64) * 128};
+
+struct subpage_t {
+    uint32_t timestamp{};
+    uint8_t subpage{};
+    uint16_t temp[8]{};
+    uint16_t raw[subpage_pixels]{};
+};
+
+std::vector<subpage_t> make_subpages(const int count, const uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> n(0.0f, 8.0f);
+    std::vector<subpage_t> v(count);
+    for (int f = 0; f < count; ++f) {
+        auto& s     = v[f];
+        s.timestamp = f * 125;
+        s.subpage   = f & 1;
+        s.temp[0]   = base_raw + f;
+        for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+            s.raw[i] = (uint16_t)(base_raw + i * 2 + ((f / 8) % 4 == 0 && i > 100 && i < 140 ? 900 : 0) + n(rng));
+        }
+    }
+    return v;
+}
+
+// Record into memory
+std::vector<uint8_t> record(RecordingWriter& w, const std::vector<subpage_t>& v, const bool finish = true)
+{
+    std::vector<uint8_t> file;
+    uint8_t buf[recording_max_write_size]{};
+    RecordingHeader h{};
+    h.refresh_rate = 4;
+    h.noise_filter = 3;
+    h.emissivity   = 0.95f;
+    h.start_time   = 1760000000000ULL;
+    size_t len     = w.begin(buf, h);
+    file.insert(file.end(), buf, buf + len);
+    for (auto&& s : v) {
+        len = w.write(buf, s.raw, s.subpage, s.temp, s.timestamp);
+        file.insert(file.end(), buf, buf + len);
+    }
+    if (finish) {
+        len = w.finish(buf);
+        file.insert(file.end(), buf, buf + len);
+    }
+    EXPECT_EQ(w.offset(), file.size());
+    return file;
+}
+
+void compare(const RecordedSubpage& r, const subpage_t& s)
+{
+    EXPECT_EQ(r.timestamp, s.timestamp);
+    EXPECT_EQ(r.subpage, s.subpage);
+    EXPECT_EQ(r.temp[0], s.temp[0]);
+    EXPECT_EQ(std::memcmp(r.raw, s.raw, sizeof(s.raw)), 0) << s.timestamp;
+}
+
+}  // namespace
+
+TEST(Recording, RoundTrip)
+{
+    const auto v = make_subpages(300, 1);
+    for (int compress = 0; compress < 2; ++compress) {
+        RecordingWriter::config_t cfg{};
+        cfg.compress      = compress;
+        cfg.index_entries = 4;
+        RecordingWriter w(cfg);
+        const auto file = record(w, v);
+
+        RecordingReader r;
+        ASSERT_TRUE(r.open(file.data(), file.size()));
+        const auto& h = r.header();
+        EXPECT_EQ(h.version, recording_version);
+        EXPECT_EQ(h.refresh_rate, 4);
+        EXPECT_EQ(h.noise_filter, 3);
+        EXPECT_FLOAT_EQ(h.emissivity, 0.95f);
+        EXPECT_EQ(h.start_time, 1760000000000ULL);
+        EXPECT_EQ(h.sync_interval, 16);
+        EXPECT_EQ(h.index_entries, 4);
+        EXPECT_EQ(h.compressed, compress != 0);
+        EXPECT_EQ(r.end(), file.size());
+        ASSERT_EQ(r.index().size(), 19U);  // 0, 16, ... 288
+        for (size_t i = 0; i < r.index().size(); ++i) {
+            EXPECT_EQ(r.index()[i].timestamp, v[i * 16].timestamp);
+        }
+
+        RecordedSubpage rs{};
+        size_t cnt{};
+        while (r.next(rs)) {
+            ASSERT_LT(cnt, v.size());
+            compare(rs, v[cnt]);
+            EXPECT_EQ(rs.sync(), cnt % 16 == 0);
+            ++cnt;
+        }
+        EXPECT_EQ(cnt, v.size());
+        printf("compress:%d %zu bytes, %.1f per subpage\n", compress, file.size(), (double)file.size() / v.size());
+    }
+}
+
+TEST(Recording, Seek)
+{
+    const auto v = make_subpages(500, 2);
+    RecordingWriter w;
+    const auto file = record(w, v);
+    RecordingReader r;
+    ASSERT_TRUE(r.open(file.data(), file.size()));
+
+    RecordedSubpage rs{};
+    const uint32_t times[] = {0, 125, 16 * 125 * 7 + 1, 40000, 62375, 99999};
+    for (auto&& t : times) {
+        ASSERT_TRUE(r.seek(t)) << t;
+        ASSERT_TRUE(r.next(rs));
+        // The sync point at or before, then every subpage in order
+        EXPECT_TRUE(rs.sync());
+        EXPECT_LE(rs.timestamp, t);
+        EXPECT_GT(rs.timestamp + 16 * 125, std::min(t, v.back().timestamp));
+        size_t f = rs.timestamp / 125;
+        compare(rs, v[f]);
+        while (++f < v.size() && r.next(rs)) {
+            compare(rs, v[f]);
+        }
+        EXPECT_EQ(f, v.size());
+    }
+
+    r.rewind();
+    ASSERT_TRUE(r.next(rs));
+    compare(rs, v[0]);
+
+    // Before the first sync point
+    const auto late = make_subpages(4, 3);
+    std::vector<uint8_t> file2;
+    {
+        RecordingWriter w2;
+        std::vector<subpage_t> shifted(late);
+        for (auto&& s : shifted) {
+            s.timestamp += 1000;
+        }
+        file2 = record(w2, shifted);
+    }
+    ASSERT_TRUE(r.open(file2.data(), file2.size()));
+    EXPECT_FALSE(r.seek(999));
+    EXPECT_TRUE(r.seek(1000));
+}
+
+TEST(Recording, Crash)
+{
+    const auto v = make_subpages(400, 4);
+    RecordingWriter::config_t cfg{};
+    cfg.index_entries = 8;
+    RecordingWriter w(cfg);
+    const auto full = record(w, v, false);
+
+    // Power lost in the middle of a chunk
+    std::mt19937 rng(5);
+    RecordingReader r;
+    RecordedSubpage rs{};
+    for (int t = 0; t < 20; ++t) {
+        const size_t cut = recording_header_size + rng() % (full.size() - recording_header_size);
+        std::vector<uint8_t> file(full.begin(), full.begin() + cut);
+        ASSERT_TRUE(r.open(file.data(), file.size())) << cut;
+        EXPECT_LE(r.end(), cut);
+        EXPECT_GT(r.end() + recording_max_write_size, cut);
+
+        size_t cnt{};
+        while (r.next(rs)) {
+            compare(rs, v[cnt++]);
+        }
+        EXPECT_EQ(r.index().size(), (cnt + 15) / 16) << cut;
+
+        // Continue after the last valid chunk
+        file.resize(r.end());
+        RecordingWriter w2;
+        ASSERT_TRUE(w2.resume(r));
+        EXPECT_EQ(w2.offset(), file.size());
+        uint8_t buf[recording_max_write_size]{};
+        for (size_t f = cnt; f < v.size(); ++f) {
+            const size_t len = w2.write(buf, v[f].raw, v[f].subpage, v[f].temp, v[f].timestamp);
+            file.insert(file.end(), buf, buf + len);
+        }
+        const size_t len = w2.finish(buf);
+        file.insert(file.end(), buf, buf + len);
+
+        ASSERT_TRUE(r.open(file.data(), file.size()));
+        EXPECT_EQ(r.end(), file.size());
+        size_t all{};
+        while (r.next(rs)) {
+            compare(rs, v[all++]);
+        }
+        EXPECT_EQ(all, v.size());
+        // Seeking reaches the subpages written after resuming
+        ASSERT_TRUE(r.seek(v.back().timestamp));
+        ASSERT_TRUE(r.next(rs));
+        EXPECT_GT(rs.timestamp + 16 * 125, v.back().timestamp);
+    }
+
+    // Not a recording
+    std::vector<uint8_t> broken(full.begin(), full.begin() + 200);
+    broken[10] ^= 1;
+    EXPECT_FALSE(r.open(broken.data(), broken.size()));
+    EXPECT_FALSE(r.open(full.data(), 8));
+    EXPECT_FALSE(r.next(rs));
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Recording, DISABLED_Benchmark)
+{
+    // An hour at 8 subpages per second
+    const auto base = make_subpages(64, 6);
+    std::vector<subpage_t> v(8 * 3600);
+    for (size_t f = 0; f < v.size(); ++f) {
+        v[f]           = base[f % base.size()];
+        v[f].timestamp = f * 125;
+    }
+    RecordingWriter w;
+    auto start       = std::chrono::high_resolution_clock::now();
+    const auto file  = record(w, v);
+    auto elapsed     = std::chrono::high_resolution_clock::now() - start;
+    const double us0 = std::chrono::duration<double, std::micro>(elapsed).count() / v.size();
+
+    RecordingReader r;
+    start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(r.open(file.data(), file.size()));
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us1 = std::chrono::duration<double, std::micro>(elapsed).count();
+
+    constexpr uint32_t loops{1000};
+    std::mt19937 rng(7);
+    RecordedSubpage rs{};
+    uint32_t guard{};
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        r.seek(rng() % (3600 * 1000));
+        r.next(rs);
+        guard += rs.raw[i % subpage_pixels];
+    }
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us2 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    printf("1h: %.1f MB write:%.2f us/subpage open:%.0f us seek+read:%.2f us\n", file.size() / 1e6, us0, us1, us2);
+    EXPECT_EQ(r.index().size(), v.size() / 16);
+    EXPECT_GT(guard, 0U);
+}
@@ -0,0 +1,211 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for RoiEngine
+*/
+#include <gtest/gtest.h>
+#include <thermal2/roi.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+RoiStatistics reference(const uint16_t* frame, const Rect& r)
+{
+    RoiStatistics s{};
+    s.lowest = 0xFFFF;
+    for (uint_fast8_t y = r.y; y < r.y + r.h; ++y) {
+        for (uint_fast8_t x = r.x; x < r.x + r.w; ++x) {
+            const uint16_t v = frame[y * frame_width + x];
+            s.sum += v;
+            s.sum2 += (uint64_t)v * v;
+            s.lowest  = std::min(s.lowest, v);
+            s.highest = std::max(s.highest, v);
+        }
+    }
+    s.count = r.area();
+    return s;
+}
+
+Rect random_rect(std::default_random_engine& rng)
+{
+    Rect r{};
+    r.w = std::uniform_int_distribution<int>(1, frame_width)(rng);
+    r.h = std::uniform_int_distribution<int>(1, frame_height)(rng);
+    r.x = std::uniform_int_distribution<int>(0, frame_width - r.w)(rng);
+    r.y = std::uniform_int_distribution<int>(0, frame_height - r.h)(rng);
+    return r;
+}
+
+}  // namespace
+
+TEST(Roi, Rect)
+{
+    EXPECT_TRUE((Rect{0, 0, 32, 24}.valid()));
+    EXPECT_TRUE((Rect{31, 23, 1, 1}.valid()));
+    EXPECT_FALSE((Rect{0, 0, 0, 1}.valid()));
+    EXPECT_FALSE((Rect{0, 0, 1, 0}.valid()));
+    EXPECT_FALSE((Rect{1, 0, 32, 24}.valid()));
+    EXPECT_FALSE((Rect{0, 1, 32, 24}.valid()));
+    EXPECT_EQ((Rect{0, 0, 32, 24}.area()), frame_pixels);
+}
+
+TEST(Roi, IntegralImage)
+{
+    std::default_random_engine rng{};
+    std::uniform_int_distribution<uint16_t> dist;
+    IntegralImage ii{};
+    uint16_t frame[frame_pixels]{};
+
+    for (uint32_t n = 0; n < 32; ++n) {
+        for (auto&& v : frame) {
+            v = (n & 1) ? dist(rng) : 0xFFFF;  // Full range and the largest sums
+        }
+        ii.build(frame);
+        for (uint32_t i = 0; i < 256; ++i) {
+            const Rect r = random_rect(rng);
+            auto ref     = reference(frame, r);
+            auto s       = ii.statistics(r);
+            EXPECT_EQ(s.sum, ref.sum);
+            EXPECT_EQ(s.sum2, ref.sum2);
+            EXPECT_EQ(s.count, ref.count);
+            EXPECT_EQ(s.lowest, ref.lowest);
+            EXPECT_EQ(s.highest, ref.highest);
+        }
+    }
+
+    // Mean and variance
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        frame[i] = (i & 1) ? 11000 : 11010;
+    }
+    ii.build(frame);
+    auto s = ii.statistics(Rect{0, 0, 32, 24});
+    EXPECT_FLOAT_EQ(s.mean(), 11005.0f);
+    EXPECT_NEAR(s.variance(), 25.0f, 1e-3f);
+    EXPECT_FLOAT_EQ(RoiStatistics{}.mean(), 0.0f);
+    EXPECT_FLOAT_EQ(RoiStatistics{}.variance(), 0.0f);
+}
+
+TEST(Roi, Engine)
+{
+    RoiEngine engine{};
+    EXPECT_TRUE(engine.add("bearing", Rect{2, 2, 4, 4}));
+    EXPECT_TRUE(engine.add("motor", Rect{10, 5, 8, 6}));
+    EXPECT_FALSE(engine.add("motor", Rect{0, 0, 1, 1}));  // Duplicated
+    EXPECT_FALSE(engine.add("belt", Rect{30, 0, 4, 1}));  // Out of the frame
+    EXPECT_FALSE(engine.add(nullptr, Rect{0, 0, 1, 1}));
+    EXPECT_EQ(engine.rois().size(), 2U);
+
+    uint16_t frame[frame_pixels]{};
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        frame[i] = 10000 + i;
+    }
+    // The tables are allocated by the first frame if not begun
+    EXPECT_FALSE(engine.isBegun());
+    EXPECT_EQ(engine.image(), nullptr);
+    EXPECT_TRUE(engine.process(frame));
+    EXPECT_TRUE(engine.isBegun());
+    EXPECT_NE(engine.image(), nullptr);
+    EXPECT_EQ(engine.sequence(), 1U);
+
+    auto b = engine.find("bearing");
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(b->stats.lowest, 10000 + 2 * 32 + 2);
+    EXPECT_EQ(b->stats.highest, 10000 + 5 * 32 + 5);
+    EXPECT_EQ(b->stats.count, 16);
+    EXPECT_EQ(engine.find("belt"), nullptr);
+
+    EXPECT_TRUE(engine.remove("bearing"));
+    EXPECT_FALSE(engine.remove("bearing"));
+    EXPECT_EQ(engine.rois().size(), 1U);
+    EXPECT_EQ(engine.rois().front().name, "motor");
+    engine.clear();
+    EXPECT_TRUE(engine.rois().empty());
+}
+
+TEST(Roi, Merge)
+{
+    RoiEngine engine{};
+    EXPECT_TRUE(engine.add("all", Rect{0, 0, frame_width, frame_height}));
+
+    uint16_t sp[2][subpage_pixels]{};
+    for (uint_fast16_t i = 0; i < subpage_pixels; ++i) {
+        sp[0][i] = 10000;
+        sp[1][i] = 20000;
+    }
+
+    // Not processed until both subpages are merged
+    EXPECT_FALSE(engine.merge(sp[0], 0));
+    EXPECT_EQ(engine.sequence(), 0U);
+    ASSERT_NE(engine.frame(), nullptr);
+    EXPECT_TRUE(engine.merge(sp[1], 1));
+    EXPECT_EQ(engine.sequence(), 1U);
+    auto& s = engine.rois().front().stats;
+    EXPECT_EQ(s.count, frame_pixels);
+    EXPECT_EQ(s.lowest, 10000);
+    EXPECT_EQ(s.highest, 20000);
+
+    // Every subpage after that yields the frame of the latest two
+    sp[0][0] = 5000;
+    EXPECT_TRUE(engine.merge(sp[0], 0));
+    EXPECT_EQ(engine.sequence(), 2U);
+    EXPECT_EQ(s.lowest, 5000);
+    EXPECT_EQ(s.highest, 20000);
+
+    engine.reset();
+    EXPECT_FALSE(engine.merge(sp[1], 1));
+    EXPECT_EQ(engine.sequence(), 2U);
+    EXPECT_TRUE(engine.merge(sp[0], 0));
+    EXPECT_EQ(engine.sequence(), 3U);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Roi, DISABLED_Benchmark)
+{
+    // Cost per frame as the region count grows, against computing each region directly
+    std::default_random_engine rng{};
+    std::uniform_int_distribution<uint16_t> dist(8000, 16000);
+    uint16_t frame[frame_pixels]{};
+    for (auto&& v : frame) {
+        v = dist(rng);
+    }
+
+    constexpr uint32_t loops{200};
+    printf("%6s %12s %12s\n", "ROIs", "engine(us)", "direct(us)");
+    for (auto&& n : {1, 10, 20, 50, 100}) {
+        RoiEngine engine{};
+        std::vector<Rect> rects{};
+        for (int i = 0; i < n; ++i) {
+            const Rect r = random_rect(rng);
+            rects.push_back(r);
+            engine.add(std::to_string(i).c_str(), r);
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t l = 0; l < loops; ++l) {
+            frame[l % frame_pixels] ^= 1;
+            engine.process(frame);
+        }
+        auto elapsed_e   = std::chrono::high_resolution_clock::now() - start;
+        const double e = std::chrono::duration<double, std::micro>(elapsed_e).count() / loops;
+
+        uint64_t guard{};
+        start = std::chrono::high_resolution_clock::now();
+        for (uint32_t l = 0; l < loops; ++l) {
+            frame[l % frame_pixels] ^= 1;
+            for (auto&& r : rects) {
+                guard += reference(frame, r).sum2;
+            }
+        }
+        auto elapsed_d   = std::chrono::high_resolution_clock::now() - start;
+        const double d = std::chrono::duration<double, std::micro>(elapsed_d).count() / loops;
+        printf("%6d %12.2f %12.2f\n", n, e, d);
+        EXPECT_NE(guard, 0U);
+    }
+}
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for RunningStatistics
+*/
+#include <gtest/gtest.h>
+#include <utility/running_statistics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <random>
+
+using namespace m5::unit::thermo;
+
+namespace {
+
+// Statistics of the samples by walking them
+struct reference_t {
+    double mean{}, variance{};
+    float minimum{}, maximum{};
+};
+reference_t reference(const std::deque<float>& v)
+{
+    reference_t r{};
+    r.minimum = *std::min_element(v.begin(), v.end());
+    r.maximum = *std::max_element(v.begin(), v.end());
+    for (auto x : v) {
+        r.mean += x;
+    }
+    r.mean /= v.size();
+    for (auto x : v) {
+        r.variance += (x - r.mean) * (x - r.mean);
+    }
+    r.variance /= (v.size() - 1);
+    return r;
+}
+
+}  // namespace
+
+TEST(RunningStatistics, Empty)
+{
+    RunningStatistics rs{};
+    EXPECT_EQ(rs.count(), 0U);
+    EXPECT_TRUE(std::isnan(rs.mean()));
+    EXPECT_TRUE(std::isnan(rs.variance()));
+    EXPECT_TRUE(std::isnan(rs.minimum()));
+    EXPECT_TRUE(std::isnan(rs.maximum()));
+    EXPECT_TRUE(std::isnan(rs.ewma()));
+
+    rs.push(NAN);
+    EXPECT_EQ(rs.total(), 0U);
+    rs.push(3.0f);
+    EXPECT_EQ(rs.count(), 1U);
+    EXPECT_FLOAT_EQ(rs.mean(), 3.0f);
+    EXPECT_TRUE(std::isnan(rs.stddev()));
+    EXPECT_FLOAT_EQ(rs.minimum(), 3.0f);
+    EXPECT_FLOAT_EQ(rs.maximum(), 3.0f);
+    EXPECT_FLOAT_EQ(rs.ewma(), 3.0f);
+}
+
+TEST(RunningStatistics, Exact)
+{
+    // Up to 16 samples the window slides a sample at a time
+    for (uint32_t window : {1U, 2U, 5U, 16U}) {
+        RunningStatistics rs({window, 0});
+        std::deque<float> ref{};
+        std::mt19937 rng(window);
+        std::uniform_real_distribution<float> dist(-20.0f, 80.0f);
+        for (int i = 0; i < 500; ++i) {
+            const float v = dist(rng);
+            rs.push(v);
+            ref.push_back(v);
+            if (ref.size() > window) {
+                ref.pop_front();
+            }
+            ASSERT_EQ(rs.count(), ref.size());
+            const auto r = reference(ref);
+            EXPECT_NEAR(rs.mean(), r.mean, 1e-3);
+            EXPECT_FLOAT_EQ(rs.minimum(), r.minimum);
+            EXPECT_FLOAT_EQ(rs.maximum(), r.maximum);
+            if (ref.size() > 1) {
+                EXPECT_NEAR(rs.variance(), r.variance, 1e-2 + r.variance * 1e-4);
+            }
+        }
+    }
+}
+
+TEST(RunningStatistics, Window)
+{
+    constexpr uint32_t window{1000};
+    RunningStatistics rs({window, 100});
+    std::deque<float> all{};
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    float ewma{};
+    for (int i = 0; i < 20000; ++i) {
+        // Drifting temperature with spikes
+        const float v = 25.0f + 10.0f * std::sin(i / 3000.0f) + noise(rng) + ((i % 997) == 0 ? 15.0f : 0.0f);
+        rs.push(v);
+        all.push_back(v);
+        ewma = i ? ewma + (2.0f / 101.0f) * (v - ewma) : v;
+
+        const uint32_t n = rs.count();
+        ASSERT_GE(n + 63, std::min<uint32_t>(window, i + 1));
+        ASSERT_LE(n, window + 63);
+        if ((i % 101) == 0) {
+            // Exactly the statistics of the latest count() samples
+            std::deque<float> latest(all.end() - n, all.end());
+            const auto r = reference(latest);
+            EXPECT_NEAR(rs.mean(), r.mean, 1e-3);
+            EXPECT_FLOAT_EQ(rs.minimum(), r.minimum);
+            EXPECT_FLOAT_EQ(rs.maximum(), r.maximum);
+            if (n > 1) {
+                EXPECT_NEAR(rs.variance(), r.variance, 1e-3 + r.variance * 1e-4);
+            }
+            EXPECT_NEAR(rs.ewma(), ewma, 1e-3);
+        }
+    }
+    EXPECT_EQ(rs.total(), 20000U);
+
+    rs.reset();
+    EXPECT_EQ(rs.count(), 0U);
+    EXPECT_EQ(rs.total(), 0U);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(RunningStatistics, DISABLED_Benchmark)
+{
+    constexpr int count{1 << 20};
+    std::vector<float> input(count);
+    std::mt19937 rng(2);
+    std::normal_distribution<float> noise(25.0f, 1.0f);
+    for (auto& v : input) {
+        v = noise(rng);
+    }
+
+    RunningStatistics rs({4096, 0});
+    auto started = std::chrono::high_resolution_clock::now();
+    for (auto v : input) {
+        rs.push(v);
+    }
+    const auto push_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+
+    started = std::chrono::high_resolution_clock::now();
+    float sink{};
+    for (int i = 0; i < 10000; ++i) {
+        sink += rs.mean() + rs.stddev() + rs.minimum() + rs.maximum();
+    }
+    const auto query_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+    EXPECT_TRUE(sink == sink);
+    printf("RunningStatistics: %zu bytes, push %.2f ns, all statistics of 4096 samples %.1f ns\n",
+           sizeof(RunningStatistics), (double)push_ns / count, query_ns / 10000.0);
+}
@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for spatial filters
+*/
+#include <gtest/gtest.h>
+#include <thermal2/spatial_filter.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(25 + 64) * 128};  // 25 celsius
+
+uint16_t at(const uint16_t* f, int x, int y)
+{
+    x = std::max(0, std::min(x, (int)frame_width - 1));
+    y = std::max(0, std::min(y, (int)frame_height - 1));
+    return f[y * frame_width + x];
+}
+
+void reference_median(const uint16_t* src, uint16_t* dst)
+{
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            uint16_t w[9]{};
+            uint_fast8_t n{};
+            for (int j = -1; j <= 1; ++j) {
+                for (int i = -1; i <= 1; ++i) {
+                    w[n++] = at(src, x + i, y + j);
+                }
+            }
+            std::nth_element(w, w + 4, w + 9);
+            dst[y * frame_width + x] = w[4];
+        }
+    }
+}
+
+void reference_gaussian(const uint16_t* src, uint16_t* dst, const int r)
+{
+    const double k[2][5] = {{1, 2, 1}, {1, 4, 6, 4, 1}};
+    const double* kk     = k[r - 1];
+    const double norm    = r == 1 ? 16.0 : 256.0;
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            double s{};
+            for (int j = -r; j <= r; ++j) {
+                for (int i = -r; i <= r; ++i) {
+                    s += kk[j + r] * kk[i + r] * at(src, x + i, y + j);
+                }
+            }
+            dst[y * frame_width + x] = (uint16_t)std::lround(s / norm);
+        }
+    }
+}
+
+void reference_bilateral(const uint16_t* src, uint16_t* dst, const double sigma)
+{
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            const double c = at(src, x, y);
+            double s{}, ws{};
+            for (int j = -1; j <= 1; ++j) {
+                for (int i = -1; i <= 1; ++i) {
+                    const double v = at(src, x + i, y + j);
+                    const double w =
+                        (4 >> (std::abs(i) + std::abs(j))) * std::exp(-(v - c) * (v - c) / (2 * sigma * sigma));
+                    s += w * v;
+                    ws += w;
+                }
+            }
+            dst[y * frame_width + x] = (uint16_t)std::lround(s / ws);
+        }
+    }
+}
+
+void make_scene(uint16_t* f, std::default_random_engine& rng, const float sd, const float salt)
+{
+    std::normal_distribution<float> noise(0.0f, sd);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            // Hot object with a sharp edge
+            float v = base_raw + ((x >= 10 && x < 20 && y >= 8 && y < 16) ? 1280 : x * 8) + noise(rng);
+            if (u(rng) < salt) {
+                v = u(rng) < 0.5f ? 0 : 40000;
+            }
+            f[y * frame_width + x] = (uint16_t)std::max(0L, std::lround(v));
+        }
+    }
+}
+
+double usec_per_frame(const std::function<void(uint16_t*)>& fn)
+{
+    constexpr uint32_t loops{2000};
+    std::default_random_engine rng{};
+    uint16_t f[frame_pixels]{};
+    make_scene(f, rng, 12, 0.01f);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        fn(f);
+        f[i % frame_pixels] ^= i;  // Keep the optimizer honest
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() /
+           loops;
+}
+
+}  // namespace
+
+TEST(SpatialFilter, Median)
+{
+    std::default_random_engine rng{};
+    std::uniform_int_distribution<uint16_t> dist;
+    for (uint32_t n = 0; n < 64; ++n) {
+        uint16_t src[frame_pixels]{}, ref[frame_pixels]{};
+        for (auto&& v : src) {
+            v = (n & 1) ? dist(rng) : dist(rng) & 7;  // Many duplicates on even rounds
+        }
+        reference_median(src, ref);
+        median3x3(src);
+        EXPECT_TRUE(std::equal(std::begin(src), std::end(src), ref)) << n;
+    }
+
+    // Salt and pepper is removed
+    uint16_t f[frame_pixels]{};
+    std::fill(std::begin(f), std::end(f), base_raw);
+    f[5 * frame_width + 5]   = 0;
+    f[10 * frame_width + 31] = 0xFFFF;
+    f[0]                     = 0xFFFF;
+    median3x3(f);
+    EXPECT_TRUE(std::all_of(std::begin(f), std::end(f), [](const uint16_t v) { return v == base_raw; }));
+}
+
+TEST(SpatialFilter, Gaussian)
+{
+    std::default_random_engine rng{};
+    std::uniform_int_distribution<uint16_t> dist;
+    for (uint32_t n = 0; n < 64; ++n) {
+        uint16_t src[frame_pixels]{}, ref3[frame_pixels]{}, ref5[frame_pixels]{}, g3[frame_pixels]{},
+            g5[frame_pixels]{};
+        for (auto&& v : src) {
+            v = dist(rng);
+        }
+        reference_gaussian(src, ref3, 1);
+        reference_gaussian(src, ref5, 2);
+        std::copy(std::begin(src), std::end(src), g3);
+        std::copy(std::begin(src), std::end(src), g5);
+        gaussian3x3(g3);
+        gaussian5x5(g5);
+        // Exact up to rounding of the half
+        for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+            EXPECT_LE(std::abs(g3[i] - ref3[i]), 1) << n << "," << i;
+            EXPECT_LE(std::abs(g5[i] - ref5[i]), 1) << n << "," << i;
+        }
+    }
+    // Flat field is kept
+    uint16_t f[frame_pixels]{};
+    std::fill(std::begin(f), std::end(f), 0xFFFF);
+    gaussian5x5(f);
+    EXPECT_TRUE(std::all_of(std::begin(f), std::end(f), [](const uint16_t v) { return v == 0xFFFF; }));
+}
+
+TEST(SpatialFilter, Bilateral)
+{
+    std::default_random_engine rng{};
+    for (auto&& sigma : {16, 64, 128, 512}) {
+        BilateralFilter bf(BilateralFilter::config_t{(uint16_t)sigma});
+        EXPECT_EQ(bf.weight(0), 256);
+        EXPECT_EQ(bf.weight(sigma * 4), 0);
+
+        uint16_t src[frame_pixels]{}, ref[frame_pixels]{};
+        make_scene(src, rng, 12, 0.0f);
+        reference_bilateral(src, ref, sigma);
+        bf.apply(src);
+        double err{};
+        for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+            err = std::max(err, std::fabs((double)src[i] - ref[i]));
+        }
+        // Quantization of the range weights
+        EXPECT_LE(err, std::max(4.0, sigma * 0.1)) << sigma;
+    }
+
+    // Edges are kept
+    BilateralFilter bf{};
+    uint16_t f[frame_pixels]{};
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        f[i] = (i % frame_width) < 16 ? base_raw : base_raw + 1280;
+    }
+    bf.apply(f);
+    EXPECT_EQ(f[15], base_raw);
+    EXPECT_EQ(f[16], base_raw + 1280);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(SpatialFilter, DISABLED_Benchmark)
+{
+    uint16_t tmp[frame_pixels]{};
+    BilateralFilter bf{};
+    const struct {
+        const char* name;
+        std::function<void(uint16_t*)> fn;
+    } table[] = {
+        {"median3x3", [](uint16_t* f) { median3x3(f); }},
+        {"median3x3(reference)",
+         [&tmp](uint16_t* f) {
+             reference_median(f, tmp);
+             std::copy(std::begin(tmp), std::end(tmp), f);
+         }},
+        {"gaussian3x3", [](uint16_t* f) { gaussian3x3(f); }},
+        {"gaussian5x5", [](uint16_t* f) { gaussian5x5(f); }},
+        {"bilateral3x3", [&bf](uint16_t* f) { bf.apply(f); }},
+    };
+    for (auto&& e : table) {
+        printf("%-24s %8.2f us/frame\n", e.name, usec_per_frame(e.fn));
+    }
+}
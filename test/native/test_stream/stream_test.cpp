@@ -0,0 +1,254 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for stream
+*/
+#include <gtest/gtest.h>
+#include <thermal2/stream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+struct subpage_t {
+    uint8_t subpage{};
+    uint16_t temp[8]{};
+    uint16_t raw[subpage_pixels]{};
+};
+
+subpage_t make_subpage(std::mt19937& rng, const uint8_t sp)
+{
+    subpage_t s{};
+    s.subpage = sp;
+    for (auto&& t : s.temp) {
+        t = (uint16_t)rng();
+    }
+    for (auto&& r : s.raw) {
+        r = (uint16_t)rng();
+    }
+    return s;
+}
+
+// Push the bytes and return the packets decoded
+uint32_t feed(StreamDecoder& d, const uint8_t* data, const size_t len)
+{
+    uint32_t cnt{};
+    for (size_t i = 0; i < len; ++i) {
+        cnt += d.push(data[i]);
+    }
+    return cnt;
+}
+
+}  // namespace
+
+TEST(Stream, Crc)
+{
+    // Check value of CRC-16/CCITT-FALSE
+    const char* s = "123456789";
+    EXPECT_EQ(stream_crc16((const uint8_t*)s, 9), 0x29B1);
+    EXPECT_EQ(stream_crc16((const uint8_t*)s + 4, 5, stream_crc16((const uint8_t*)s, 4)), 0x29B1);
+}
+
+TEST(Stream, RoundTrip)
+{
+    std::mt19937 rng(1);
+    StreamEncoder enc;
+    StreamDecoder dec;
+    uint8_t buf[stream_packet_size]{};
+
+    for (int i = 0; i < 16; ++i) {
+        const subpage_t s = make_subpage(rng, i & 1);
+        const size_t len  = enc.encode(buf, s.raw, s.subpage, s.temp, 1000U * i + 0x12345678U, i == 3);
+        ASSERT_LE(len, stream_packet_size);
+        EXPECT_EQ(buf[0], 0x00);
+        EXPECT_EQ(buf[len - 1], 0x00);
+        EXPECT_EQ(std::count(buf + 1, buf + len - 1, 0), 0);
+
+        EXPECT_EQ(feed(dec, buf, len), 1U) << i;
+        const auto& p = dec.packet();
+        EXPECT_EQ(p.sequence, i);
+        EXPECT_EQ(p.timestamp, 1000U * i + 0x12345678U);
+        EXPECT_EQ(p.subpage, i & 1);
+        EXPECT_EQ(p.torn(), i == 3);
+        EXPECT_EQ(std::memcmp(p.temp, s.temp, sizeof(s.temp)), 0);
+        EXPECT_EQ(std::memcmp(p.raw, s.raw, sizeof(s.raw)), 0);
+    }
+    EXPECT_EQ(enc.sequence(), 16);
+    EXPECT_EQ(dec.stats().packets, 16U);
+    EXPECT_EQ(dec.stats().dropped, 0U);
+
+    // Longest packet without any zero, and all zeros
+    subpage_t s{};
+    std::fill(std::begin(s.raw), std::end(s.raw), 0x0101);
+    std::fill(std::begin(s.temp), std::end(s.temp), 0x0101);
+    size_t len = enc.encode(buf, s.raw, 0, s.temp, 0x01010101U);
+    EXPECT_LE(len, stream_packet_size);
+    EXPECT_EQ(feed(dec, buf, len), 1U);
+    EXPECT_EQ(std::memcmp(dec.packet().raw, s.raw, sizeof(s.raw)), 0);
+
+    std::fill(std::begin(s.raw), std::end(s.raw), 0);
+    len = enc.encode(buf, s.raw, 1, nullptr, 0);
+    EXPECT_EQ(feed(dec, buf, len), 1U);
+    EXPECT_EQ(std::memcmp(dec.packet().raw, s.raw, sizeof(s.raw)), 0);
+    EXPECT_EQ(dec.packet().temp[7], 0);
+
+    EXPECT_EQ(enc.encode(nullptr, s.raw, 0, nullptr, 0), 0U);
+}
+
+TEST(Stream, Errors)
+{
+    std::mt19937 rng(2);
+    StreamEncoder enc;
+    StreamDecoder dec;
+    std::vector<uint8_t> packets[8];
+    for (int i = 0; i < 8; ++i) {
+        const subpage_t s = make_subpage(rng, i & 1);
+        packets[i].resize(stream_packet_size);
+        packets[i].resize(enc.encode(packets[i].data(), s.raw, s.subpage, s.temp, i));
+    }
+
+    // Joining in the middle of a packet
+    EXPECT_EQ(feed(dec, packets[0].data() + 100, packets[0].size() - 100), 0U);
+    EXPECT_EQ(dec.stats().framing, 0U);
+    EXPECT_EQ(feed(dec, packets[1].data(), packets[1].size()), 1U);
+
+    // Text written to the same port
+    const char* log = "[I] Something happened\n";
+    EXPECT_EQ(feed(dec, (const uint8_t*)log, std::strlen(log)), 0U);
+    EXPECT_EQ(feed(dec, packets[2].data(), packets[2].size()), 1U);
+    EXPECT_EQ(dec.stats().framing, 1U);
+
+    // Corrupted
+    std::vector<uint8_t> bad = packets[3];
+    bad[400] ^= (bad[400] == 0x10) ? 0x20 : 0x10;
+    EXPECT_EQ(feed(dec, bad.data(), bad.size()), 0U);
+    EXPECT_EQ(dec.stats().crc + dec.stats().framing, 2U);
+
+    // Lost packets
+    EXPECT_EQ(feed(dec, packets[6].data(), packets[6].size()), 1U);
+    EXPECT_EQ(dec.packet().sequence, 6);
+    EXPECT_EQ(dec.stats().dropped, 3U);
+    EXPECT_EQ(dec.stats().packets, 3U);
+
+    // Wrap around of the sequence number
+    dec.reset();
+    enc.reset(0xFFFE);
+    uint8_t buf[stream_packet_size]{};
+    const subpage_t s = make_subpage(rng, 0);
+    for (int i = 0; i < 4; ++i) {
+        const size_t len = enc.encode(buf, s.raw, 0, s.temp, 0);
+        if (i != 2) {
+            EXPECT_EQ(feed(dec, buf, len), 1U);
+        }
+    }
+    EXPECT_EQ(dec.packet().sequence, 1);
+    EXPECT_EQ(dec.stats().dropped, 1U);
+
+    // Duplicated and reordered packets are not gaps
+    dec.reset();
+    enc.reset();
+    std::vector<uint8_t> seq[4];
+    for (auto&& p : seq) {
+        p.resize(stream_packet_size);
+        p.resize(enc.encode(p.data(), s.raw, 0, s.temp, 0));
+    }
+    for (auto&& i : {0, 1, 1, 3, 2, 3}) {
+        EXPECT_EQ(feed(dec, seq[i].data(), seq[i].size()), 1U) << i;
+    }
+    EXPECT_EQ(dec.packet().sequence, 3);
+    EXPECT_EQ(dec.stats().dropped, 1U);
+    EXPECT_EQ(dec.stats().resync, 2U);
+    EXPECT_EQ(dec.stats().packets, 6U);
+
+    // Endless garbage
+    std::vector<uint8_t> junk(4096, 0x55);
+    EXPECT_EQ(feed(dec, junk.data(), junk.size()), 0U);
+    EXPECT_EQ(feed(dec, packets[7].data(), packets[7].size()), 1U);
+    EXPECT_EQ(dec.stats().framing, 1U);
+}
+
+TEST(Stream, Compressed)
+{
+    std::mt19937 rng(4);
+    std::normal_distribution<float> n(0.0f, 8.0f);
+    DeltaEncoder::config_t cfg{};
+    cfg.keyframe_interval = 8;
+    DeltaEncoder codec(cfg);
+    StreamEncoder enc;
+    StreamDecoder dec;
+    uint8_t buf[stream_packet_size]{};
+    subpage_t s{};
+
+    uint32_t decoded{};
+    for (int i = 0; i < 64; ++i) {
+        s.subpage = i & 1;
+        for (auto&& r : s.raw) {
+            r = (uint16_t)((25 + 64) * 128 + n(rng));
+        }
+        const size_t len = enc.encode(buf, codec, s.raw, s.subpage, s.temp, i, false);
+        ASSERT_LE(len, stream_packet_size);
+        if (i > 2) {
+            EXPECT_LT(len, 400U) << i;
+        }
+        // Lose the 20th, the next ones wait for keyframes (32 for the subpage 0, 33 for 1)
+        if (i == 20) {
+            continue;
+        }
+        const bool ok = feed(dec, buf, len);
+        EXPECT_EQ(ok, i < 20 || i >= 32) << i;
+        if (ok) {
+            ++decoded;
+            EXPECT_EQ(dec.packet().sequence, i);
+            EXPECT_EQ(dec.packet().subpage, i & 1);
+            EXPECT_EQ(std::memcmp(dec.packet().raw, s.raw, sizeof(s.raw)), 0) << i;
+        }
+    }
+    EXPECT_EQ(dec.stats().packets, decoded);
+    EXPECT_EQ(dec.stats().dropped, 1U);
+    EXPECT_EQ(dec.stats().unsynced, 11U);
+
+    // Raw and compressed packets in the same stream
+    size_t len = enc.encode(buf, s.raw, 1, s.temp, 0);
+    EXPECT_EQ(feed(dec, buf, len), 1U);
+    len = enc.encode(buf, codec, s.raw, 0, s.temp, 0);
+    EXPECT_EQ(feed(dec, buf, len), 1U);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Stream, DISABLED_Benchmark)
+{
+    std::mt19937 rng(3);
+    const subpage_t s = make_subpage(rng, 0);
+    StreamEncoder enc;
+    StreamDecoder dec;
+    uint8_t buf[stream_packet_size]{};
+    constexpr uint32_t loops{2000};
+    size_t bytes{}, len{};
+    uint32_t decoded{};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        len = enc.encode(buf, s.raw, s.subpage, s.temp, i);
+        bytes += len;
+    }
+    auto elapsed     = std::chrono::high_resolution_clock::now() - start;
+    const double us0 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        decoded += feed(dec, buf, len);
+    }
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us1 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    printf("packet:%zu bytes encode:%.2f us decode:%.2f us\n", bytes / loops, us0, us1);
+    EXPECT_EQ(decoded, loops);
+}
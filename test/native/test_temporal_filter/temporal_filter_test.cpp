@@ -0,0 +1,228 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for TemporalFilter
+*/
+#include <gtest/gtest.h>
+#include <thermal2/temporal_filter.hpp>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(25 + 64) * 128};  // 25 celsius
+constexpr uint16_t hot_raw{(35 + 64) * 128};   // 35 celsius
+
+// Recorded-like sequence: static scene with sensor noise, hot object appears at step_at
+struct scene_t {
+    std::default_random_engine rng{};
+    std::normal_distribution<float> noise{0.0f, 12.0f};  // ~0.1 celsius
+    uint32_t step_at{};
+
+    uint16_t truth(const uint32_t frame, const uint_fast16_t idx) const
+    {
+        const uint_fast8_t x = idx % frame_width;
+        return (frame >= step_at && x >= 8 && x < 16) ? hot_raw : base_raw + (idx & 31) * 4;
+    }
+    void generate(const uint32_t frame, uint16_t* out)
+    {
+        for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+            out[i] = (uint16_t)std::lround(truth(frame, i) + noise(rng));
+        }
+    }
+};
+
+struct result_t {
+    double noise{};      // Residual noise on static pixels (raw)
+    uint32_t latency{};  // Frames until the step reached 90%
+    double usec{};       // Per frame
+};
+
+template <class F>
+result_t evaluate(F& filter)
+{
+    constexpr uint32_t frames{200};
+    scene_t scene{};
+    scene.step_at = 100;
+
+    uint16_t buf[frame_pixels]{};
+    double sum2{};
+    uint32_t cnt{}, latency{};
+    double usec{};
+
+    for (uint32_t f = 0; f < frames; ++f) {
+        scene.generate(f, buf);
+        auto start = std::chrono::high_resolution_clock::now();
+        filter.apply(buf);
+        usec += std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+        // Static pixels after settling
+        if (f >= 50) {
+            for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+                const uint_fast8_t x = i % frame_width;
+                if (x >= 20) {
+                    const double d = (double)buf[i] - scene.truth(f, i);
+                    sum2 += d * d;
+                    ++cnt;
+                }
+            }
+        }
+        if (f >= scene.step_at && !latency) {
+            const uint_fast16_t idx = 4 * frame_width + 12;
+            if (buf[idx] >= base_raw + (hot_raw - base_raw) * 9 / 10) {
+                latency = f - scene.step_at + 1;
+            }
+        }
+    }
+    return result_t{std::sqrt(sum2 / cnt), latency, usec / frames};
+}
+
+}  // namespace
+
+TEST(TemporalFilter, Reference)
+{
+    std::default_random_engine rng{};
+    std::uniform_int_distribution<uint16_t> dist(8000, 16000);
+
+    for (auto&& alpha : {16, 64, 128, 200}) {
+        TemporalFilter::config_t cfg{};
+        cfg.alpha = alpha;
+        TemporalFilter tf(cfg);
+
+        std::vector<double> ref(frame_pixels);
+        uint16_t buf[frame_pixels]{};
+        for (uint32_t f = 0; f < 64; ++f) {
+            for (auto&& v : buf) {
+                v = dist(rng);
+            }
+            for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+                ref[i] = f ? ref[i] + (buf[i] - ref[i]) * alpha / 256.0 : buf[i];
+            }
+            tf.apply(buf);
+            for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+                EXPECT_NEAR(buf[i], ref[i], 1.0) << alpha << "," << f << "," << i;
+            }
+        }
+    }
+}
+
+TEST(TemporalFilter, Passthrough)
+{
+    TemporalFilter::config_t cfg{};
+    cfg.alpha = 256;
+    TemporalFilter tf(cfg);
+    TemporalFilter16 tf16(TemporalFilter16::config_t{256, false, 64, 384});
+
+    std::default_random_engine rng{};
+    for (uint32_t f = 0; f < 8; ++f) {
+        uint16_t src[frame_pixels]{}, a[frame_pixels]{}, b[frame_pixels]{};
+        for (auto&& v : src) {
+            v = rng();
+        }
+        std::copy(std::begin(src), std::end(src), a);
+        std::copy(std::begin(src), std::end(src), b);
+        tf.apply(a);
+        tf16.apply(b);
+        EXPECT_TRUE(std::equal(std::begin(src), std::end(src), a));
+        EXPECT_TRUE(std::equal(std::begin(src), std::end(src), b));
+    }
+    // Out of range alpha is clamped
+    cfg.alpha = 1000;
+    tf.config(cfg);
+    EXPECT_EQ(tf.config().alpha, 256);
+}
+
+TEST(TemporalFilter, Subpage)
+{
+    TemporalFilter tf{};
+    Frame frame{};
+    uint16_t sp[subpage_pixels]{};
+
+    std::fill(std::begin(sp), std::end(sp), base_raw);
+    frame.merge(sp, 0);
+    tf.apply(frame, 0);
+    frame.merge(sp, 1);
+    tf.apply(frame, 1);
+    EXPECT_TRUE(frame.complete());
+
+    std::fill(std::begin(sp), std::end(sp), hot_raw);
+    frame.merge(sp, 0);
+    tf.apply(frame, 0);
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            if (is_subpage_pixel(0, x, y)) {
+                EXPECT_GT(frame.pixel(x, y), base_raw);
+                EXPECT_LT(frame.pixel(x, y), hot_raw);
+            } else {
+                EXPECT_EQ(frame.pixel(x, y), base_raw);
+            }
+        }
+    }
+}
+
+TEST(TemporalFilter, MotionAdaptive)
+{
+    TemporalFilter::config_t cfg{};
+    cfg.alpha           = 32;
+    cfg.motion_adaptive = true;
+    TemporalFilter tf(cfg);
+
+    uint16_t buf[frame_pixels]{};
+    std::fill(std::begin(buf), std::end(buf), base_raw);
+    tf.apply(buf);
+    // Small change is smoothed
+    std::fill(std::begin(buf), std::end(buf), base_raw + 32);
+    tf.apply(buf);
+    EXPECT_EQ(buf[0], base_raw + 4);
+    // Large change passes at once
+    std::fill(std::begin(buf), std::end(buf), hot_raw);
+    tf.apply(buf);
+    EXPECT_EQ(buf[0], hot_raw);
+}
+
+TEST(TemporalFilter, NoiseAndLatency)
+{
+    // Noise vs latency on a recorded-like sequence (firmware levels need the hardware, see embedded test)
+    TemporalFilter none(TemporalFilter::config_t{256, false, 64, 384});
+    const auto rn = evaluate(none);
+    EXPECT_EQ(rn.latency, 1U);
+
+    for (auto&& motion : {false, true}) {
+        TemporalFilter tf(TemporalFilter::config_t{32, motion, 64, 384});
+        const auto r = evaluate(tf);
+        TemporalFilter16 tf16(TemporalFilter16::config_t{32, motion, 64, 384});
+        const auto r16 = evaluate(tf16);
+        SCOPED_TRACE(motion);
+        EXPECT_LT(r.noise * 2, rn.noise);
+        EXPECT_LT(r16.noise * 2, rn.noise);
+        if (motion) {
+            EXPECT_LE(r.latency, 2U);
+            EXPECT_LE(r16.latency, 2U);
+        } else {
+            EXPECT_GT(r.latency, 10U);
+            EXPECT_GT(r16.latency, 10U);
+        }
+    }
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(TemporalFilter, DISABLED_Benchmark)
+{
+    printf("%-24s %8s %8s %8s\n", "Filter", "Noise", "Latency", "us/frm");
+    for (auto&& alpha : {256, 128, 64, 32, 16}) {
+        for (auto&& motion : {false, true}) {
+            TemporalFilter tf(TemporalFilter::config_t{(uint16_t)alpha, motion, 64, 384});
+            auto r = evaluate(tf);
+            TemporalFilter16 tf16(TemporalFilter16::config_t{(uint16_t)alpha, motion, 64, 384});
+            auto r16 = evaluate(tf16);
+            printf("alpha:%3d motion:%d     %8.2f %8u %8.2f | int16 %8.2f %8u %8.2f\n", alpha, motion, r.noise,
+                   r.latency, r.usec, r16.noise, r16.latency, r16.usec);
+        }
+    }
+}
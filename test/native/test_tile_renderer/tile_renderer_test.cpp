@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for TileRenderer
+*/
+#include <gtest/gtest.h>
+#include <thermal2/tile_renderer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(22 + 64) * 128};
+
+// Room with a hot spot at (cx, cy)
+void scene(uint16_t* frame, const float cx, const float cy)
+{
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            const float d2             = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+            frame[y * frame_width + x] = (uint16_t)(base_raw + x * 8 + 1400.0f * std::exp(-d2 / 3.0f));
+        }
+    }
+}
+
+Agc make_agc()
+{
+    Agc::config_t cfg{};
+    cfg.mode = AgcMode::Linear;
+    Agc agc(cfg);
+    agc.update(base_raw - 128, base_raw + 1600);
+    return agc;
+}
+
+// Render the dirty tiles into the screen
+uint16_t compose(TileRenderer& tr, std::vector<uint16_t>& screen, const uint16_t* table)
+{
+    std::vector<uint16_t> buffer(tr.maxTilePixels());
+    const uint16_t w = tr.upscaler().width();
+    return tr.render(table, buffer.data(), [&](const TileRenderer::Tile& t, const uint16_t* pixels) {
+        for (uint16_t y = 0; y < t.h; ++y) {
+            std::copy(pixels + y * t.w, pixels + (y + 1) * t.w, screen.begin() + (t.y + y) * w + t.x);
+        }
+    });
+}
+
+}  // namespace
+
+TEST(TileRenderer, Geometry)
+{
+    TileRenderer tr;
+    EXPECT_EQ(tr.tiles(), 0);
+    EXPECT_FALSE(tr.setup(1, 240));
+
+    const int sizes[][2]  = {{320, 240}, {240, 135}, {33, 25}, {8, 6}};
+    const uint8_t cells[] = {1, 3, 4, 8};
+    for (auto&& s : sizes) {
+        for (auto&& c : cells) {
+            const int w = s[0], h = s[1];
+            TileRenderer::config_t cfg{};
+            cfg.tile_cells = c;
+            tr.config(cfg);
+            EXPECT_TRUE(tr.setup(w, h));
+            EXPECT_EQ(tr.tilesX(), (31 + c - 1) / c);
+            EXPECT_EQ(tr.tilesY(), (23 + c - 1) / c);
+
+            // Tiles cover the output once
+            std::vector<uint8_t> covered(w * h);
+            uint32_t largest{};
+            for (uint8_t ty = 0; ty < tr.tilesY(); ++ty) {
+                for (uint8_t tx = 0; tx < tr.tilesX(); ++tx) {
+                    const auto t = tr.tile(tx, ty);
+                    largest      = std::max<uint32_t>(largest, (uint32_t)t.w * t.h);
+                    for (int y = t.y; y < t.y + t.h; ++y) {
+                        for (int x = t.x; x < t.x + t.w; ++x) {
+                            ++covered[y * w + x];
+                        }
+                    }
+                }
+            }
+            EXPECT_EQ(std::count(covered.begin(), covered.end(), 1), w * h) << w << "x" << h << " " << (int)c;
+            EXPECT_EQ(tr.maxTilePixels(), largest);
+        }
+    }
+}
+
+TEST(TileRenderer, Dirty)
+{
+    constexpr int w{320}, h{240};
+    const Agc agc = make_agc();
+    std::vector<uint16_t> table(agc.size());
+    for (uint16_t i = 0; i < agc.size(); ++i) {
+        table[i] = i;
+    }
+
+    TileRenderer tr;
+    ASSERT_TRUE(tr.setup(w, h));
+    EXPECT_EQ(tr.tiles(), 8 * 6);
+
+    uint16_t frame[frame_pixels]{};
+    std::vector<uint16_t> screen(w * h), full(w * h);
+    Upscaler ref(w, h);
+
+    // Everything at first
+    scene(frame, 5.0f, 5.0f);
+    EXPECT_EQ(tr.update(frame, agc), tr.tiles());
+    EXPECT_EQ(compose(tr, screen, table.data()), tr.tiles());
+
+    // Nothing for the same frame
+    EXPECT_EQ(tr.update(frame, agc), 0);
+    EXPECT_EQ(compose(tr, screen, table.data()), 0);
+
+    // The spot moves, only the tiles around the old and new places
+    scene(frame, 25.0f, 18.0f);
+    const uint16_t dirty = tr.update(frame, agc);
+    EXPECT_GT(dirty, 0);
+    EXPECT_LT(dirty, tr.tiles() / 2);
+    EXPECT_TRUE(tr.isDirty(1, 1));
+    EXPECT_TRUE(tr.isDirty(6, 4));
+    EXPECT_FALSE(tr.isDirty(7, 0));
+    EXPECT_FALSE(tr.isDirty(0, 5));
+    EXPECT_EQ(compose(tr, screen, table.data()), dirty);
+
+    // Same as rendering the whole frame
+    ref.source(frame, agc);
+    ref.render(full.data(), table.data());
+    EXPECT_EQ(screen, full);
+
+    const auto& st = tr.stats();
+    EXPECT_EQ(st.frames, 3U);
+    EXPECT_EQ(st.drawn, tr.tiles() + (uint32_t)dirty);
+    EXPECT_EQ(st.skipped, tr.tiles() * 3U - st.drawn);
+    tr.resetStats();
+    EXPECT_EQ(tr.stats().frames, 0U);
+
+    // Everything after invalidate
+    tr.invalidate();
+    EXPECT_EQ(tr.update(frame, agc), tr.tiles());
+}
+
+TEST(TileRenderer, Threshold)
+{
+    const Agc agc = make_agc();
+    TileRenderer::config_t cfg{};
+    cfg.threshold = 4;
+    TileRenderer tr(cfg);
+    ASSERT_TRUE(tr.setup(240, 135));
+    uint8_t buffer[64 * 64]{};
+    auto discard = [](const TileRenderer::Tile&, const uint8_t*) {};
+
+    uint16_t frame[frame_pixels]{};
+    scene(frame, 16.0f, 12.0f);
+    tr.update(frame, agc);
+    tr.render(agc.lut(), buffer, discard);
+
+    // Drifts below the threshold are skipped, until they add up
+    const uint16_t step = (agc.high() - agc.low() + 1) / 256;  // raw per index
+    uint16_t drift[frame_pixels]{};
+    auto warm = [&](const int indexes) {
+        for (uint_fast16_t p = 0; p < frame_pixels; ++p) {
+            drift[p] = frame[p] + indexes * step;
+        }
+        return tr.update(drift, agc);
+    };
+    EXPECT_EQ(warm(2), 0);
+    tr.render(agc.lut(), buffer, discard);
+    EXPECT_EQ(warm(6), tr.tiles());
+    tr.render(agc.lut(), buffer, discard);
+    EXPECT_EQ(warm(6), 0);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(TileRenderer, DISABLED_Benchmark)
+{
+    constexpr int w{320}, h{240};
+    const Agc agc = make_agc();
+    uint16_t colors[Agc::max_entries]{};
+    std::mt19937 rng(1);
+    for (auto&& c : colors) {
+        c = (uint16_t)rng();
+    }
+    std::vector<uint16_t> screen(w * h);
+    TileRenderer tr;
+    ASSERT_TRUE(tr.setup(w, h));
+    Upscaler u(w, h);
+    constexpr uint32_t loops{500};
+    uint16_t frame[frame_pixels]{};
+    uint32_t guard{};
+
+    // A small object walking across a still room
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        scene(frame, (i % 64) * 0.5f, 12.0f);
+        u.source(frame, agc);
+        u.render(screen.data(), colors);
+        guard += screen[i % screen.size()];
+    }
+    auto elapsed     = std::chrono::high_resolution_clock::now() - start;
+    const double us0 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        scene(frame, (i % 64) * 0.5f, 12.0f);
+        tr.update(frame, agc);
+        compose(tr, screen, colors);
+        guard += screen[i % screen.size()];
+    }
+    elapsed          = std::chrono::high_resolution_clock::now() - start;
+    const double us1 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+    const auto& st = tr.stats();
+    printf("%dx%d full:%.1f us tiles:%.1f us drawn:%u skipped:%u\n", w, h, us0, us1, st.drawn, st.skipped);
+    EXPECT_GT(st.skipped, st.drawn);
+    EXPECT_GT(guard, 0U);
+}
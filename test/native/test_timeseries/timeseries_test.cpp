@@ -0,0 +1,282 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for TimeSeries
+*/
+#include <gtest/gtest.h>
+#include <utility/timeseries.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace m5::unit::thermo;
+
+namespace {
+
+using series_t = TimeSeries<600, 360>;
+
+struct sample_t {
+    uint32_t time;
+    float value;
+};
+
+// One sample per second, a slow sine and a ripple
+std::vector<sample_t> make_samples(const uint32_t seconds)
+{
+    std::vector<sample_t> v{};
+    for (uint32_t s = 0; s < seconds; ++s) {
+        v.push_back(sample_t{s * 1000, 25.0f + 5.0f * std::sin(s / 900.0f) + (float)(s % 7) * 0.1f});
+    }
+    return v;
+}
+
+// Brute force over the samples in [from, to)
+TimeSeriesPoint aggregate(const std::vector<sample_t>& v, const uint32_t from, const uint32_t to)
+{
+    TimeSeriesPoint p{from, 0.0f, 0.0f, 0.0f, 0};
+    double sum{};
+    for (auto& s : v) {
+        if (s.time >= from && s.time < to) {
+            p.minimum = (!p.count || s.value < p.minimum) ? s.value : p.minimum;
+            p.maximum = (!p.count || s.value > p.maximum) ? s.value : p.maximum;
+            sum += s.value;
+            ++p.count;
+        }
+    }
+    p.mean = p.count ? (float)(sum / p.count) : 0.0f;
+    return p;
+}
+
+}  // namespace
+
+TEST(TimeSeries, Buckets)
+{
+    auto ts          = std::unique_ptr<series_t>(new series_t());
+    const auto input = make_samples(2 * 3600 + 5);
+    for (auto& s : input) {
+        ts->append(s.time, s.value);
+    }
+    ts->append(input.back().time, NAN);  // Ignored
+
+    EXPECT_EQ(ts->size(0), 600U);
+    EXPECT_EQ(ts->oldest(0), input[input.size() - 600].time);
+    EXPECT_EQ(ts->size(1), 361U);  // 10s, full and the open one
+    EXPECT_EQ(ts->size(2), 121U);  // 1min, 120 closed and the open one
+    EXPECT_EQ(ts->size(3), 13U);   // 10min
+    EXPECT_EQ(ts->size(4), 3U);    // 1h
+    EXPECT_EQ(ts->size(5), 0U);
+
+    const uint32_t intervals[4]{10000, 60000, 600000, 3600000};
+    for (uint8_t lv = 1; lv <= 4; ++lv) {
+        for (size_t i = 0; i < ts->size(lv); ++i) {
+            const auto p = ts->at(lv, i);
+            const auto e = aggregate(input, p.time, p.time + intervals[lv - 1]);
+            EXPECT_EQ(p.time % intervals[lv - 1], 0U);
+            EXPECT_EQ(p.count, e.count);
+            EXPECT_FLOAT_EQ(p.minimum, e.minimum);
+            EXPECT_FLOAT_EQ(p.maximum, e.maximum);
+            EXPECT_NEAR(p.mean, e.mean, 1e-4f);
+        }
+    }
+    // The open bucket is the newest
+    EXPECT_EQ(ts->at(4, 2).time, 7200000U);
+    EXPECT_EQ(ts->at(4, 2).count, 5U);
+
+    ts->clear();
+    for (uint8_t lv = 0; lv <= 4; ++lv) {
+        EXPECT_EQ(ts->size(lv), 0U);
+    }
+}
+
+TEST(TimeSeries, Query)
+{
+    auto ts          = std::unique_ptr<series_t>(new series_t());
+    const auto input = make_samples(24 * 3600);
+    for (auto& s : input) {
+        ts->append(s.time, s.value);
+    }
+    const uint32_t now = 24 * 3600 * 1000;
+
+    // Level by the time per pixel, and coarser where the history is not kept
+    EXPECT_EQ(ts->level(now - 60 * 1000, now, 60), 0);
+    EXPECT_EQ(ts->level(now - 3600 * 1000, now, 320), 1);
+    EXPECT_EQ(ts->level(now - 6 * 3600 * 1000, now, 320), 2);
+    EXPECT_EQ(ts->level(now - 3600 * 1000, now, 30), 2);
+    EXPECT_EQ(ts->level(now - 12 * 3600 * 1000, now, 320), 3);  // 1min keeps only 6h
+    EXPECT_EQ(ts->level(0, now, 20), 4);
+
+    struct range_t {
+        uint32_t from, to;
+        uint16_t width;
+    };
+    for (auto r : {range_t{now - 600 * 1000, now, 300}, range_t{now - 3600 * 1000, now, 120},
+                   range_t{now - 6 * 3600 * 1000, now, 180}, range_t{0, now, 48}}) {
+        std::vector<TimeSeriesPoint> px(r.width);
+        const uint8_t lv   = ts->query(r.from, r.to, px.data(), r.width);
+        const uint32_t per = (r.to - r.from) / r.width;
+        for (uint16_t x = 0; x < r.width; ++x) {
+            // Pixels aligned to the buckets hold exactly the samples of their time
+            const auto e = aggregate(input, px[x].time, px[x].time + per);
+            EXPECT_EQ(px[x].count, e.count) << "level " << (int)lv << " x " << x;
+            EXPECT_FLOAT_EQ(px[x].minimum, e.minimum);
+            EXPECT_FLOAT_EQ(px[x].maximum, e.maximum);
+            EXPECT_NEAR(px[x].mean, e.mean, 1e-4f);
+        }
+    }
+
+    // No data
+    std::vector<TimeSeriesPoint> px(10);
+    ts->query(now + 1000, now + 11000, px.data(), 10);
+    for (auto& p : px) {
+        EXPECT_EQ(p.count, 0U);
+    }
+}
+
+TEST(TimeSeries, LateStart)
+{
+    // Recording started after the start of the range, 10 samples per second
+    const uint32_t start = 10 * 3600 * 1000;
+    for (auto seconds : {50U, 70U}) {
+        auto ts = std::unique_ptr<series_t>(new series_t());
+        for (uint32_t i = 0; i < seconds * 10; ++i) {
+            ts->append(start + i * 100, (float)i);
+        }
+        const uint32_t now = start + seconds * 1000;
+
+        // Samples while they are all kept, then the 10s buckets
+        std::vector<TimeSeriesPoint> px(320);
+        const uint8_t lv = ts->query(now - 120 * 1000, now, px.data(), 320);
+        EXPECT_EQ(lv, seconds < 60 ? 0 : 1) << seconds;
+        uint32_t count{}, pixels{};
+        for (auto& p : px) {
+            count += p.count;
+            pixels += (p.count != 0);
+        }
+        EXPECT_EQ(count, seconds * 10) << seconds;
+        if (lv) {
+            EXPECT_EQ(pixels, seconds / 10) << seconds;
+        } else {
+            EXPECT_GT(pixels, seconds * 2) << seconds;
+        }
+    }
+}
+
+TEST(TimeSeries, CoveringBucket)
+{
+    auto ts          = std::unique_ptr<series_t>(new series_t());
+    const auto input = make_samples(6 * 3600);
+    for (auto& s : input) {
+        ts->append(s.time, s.value);
+    }
+    const uint32_t now = 6 * 3600 * 1000;
+
+    // Starts 30s into a 1min bucket, the bucket is in the first pixel
+    const uint32_t from = now - 3 * 3600 * 1000 + 30 * 1000;
+    std::vector<TimeSeriesPoint> px(60);
+    const uint8_t lv = ts->query(from, from + 3 * 3600 * 1000, px.data(), 60);
+    ASSERT_EQ(lv, 2);
+    // 3min per pixel, the buckets from -30s to +150s
+    const auto e = aggregate(input, from - 30 * 1000, from + 210 * 1000);
+    EXPECT_EQ(px[0].count, e.count);
+    EXPECT_FLOAT_EQ(px[0].minimum, e.minimum);
+    EXPECT_FLOAT_EQ(px[0].maximum, e.maximum);
+    EXPECT_NEAR(px[0].mean, e.mean, 1e-4f);
+}
+
+TEST(TimeSeries, WrapAround)
+{
+    // Two hours at 1Hz across the wrap around of millis()
+    const uint32_t start = 0xFFFFFFFFU - 3600 * 1000;
+    auto ts              = std::unique_ptr<series_t>(new series_t());
+    std::vector<sample_t> input{};
+    for (uint32_t s = 0; s < 2 * 3600; ++s) {
+        input.push_back(sample_t{start + s * 1000, 25.0f + (float)(s % 13) * 0.1f});
+        ts->append(input.back().time, input.back().value);
+    }
+    const uint32_t now = start + 2 * 3600 * 1000;  // Wrapped
+
+    // Every level stays in time order, each sample in one bucket. Buckets may start before the first sample
+    const uint32_t origin = start - 24 * 3600 * 1000;
+    for (uint8_t lv = 0; lv <= 4; ++lv) {
+        uint32_t count{};
+        for (size_t i = 0; i < ts->size(lv); ++i) {
+            count += ts->at(lv, i).count;
+            if (i) {
+                EXPECT_GT(ts->at(lv, i).time - origin, ts->at(lv, i - 1).time - origin) << (int)lv << " " << i;
+            }
+        }
+        if (!ts->full(lv)) {
+            EXPECT_EQ(count, input.size()) << (int)lv;
+        }
+    }
+
+    // Ranges across the wrap
+    struct range_t {
+        uint32_t from, to;
+        uint16_t width;
+    };
+    for (auto r : {range_t{now - 600 * 1000, now, 300}, range_t{now - 3600 * 1000, now, 120},
+                   range_t{start, now, 120}}) {
+        std::vector<TimeSeriesPoint> px(r.width);
+        const uint8_t lv = ts->query(r.from, r.to, px.data(), r.width);
+        uint32_t count{};
+        for (auto& p : px) {
+            count += p.count;
+        }
+        uint32_t expected{};
+        for (auto& s : input) {
+            expected += (s.time - r.from < r.to - r.from);
+        }
+        // And the samples of the bucket covering from
+        EXPECT_GE(count, expected) << r.from;
+        EXPECT_LT(count, expected + (lv ? ts->config().interval_ms[lv - 1] / 1000 : 1)) << r.from;
+        EXPECT_GT(px[r.width - 1].count, 0U) << r.from;
+    }
+    EXPECT_EQ(ts->level(now - 60 * 1000, now, 60), 0);
+    EXPECT_EQ(ts->level(start, now, 20), 2);
+
+    // Entries older than max_age are dropped, 30 days at 10min
+    ts->clear();
+    uint32_t t{start};
+    for (uint32_t i = 0; i < 30 * 24 * 6; ++i, t += 600 * 1000) {
+        ts->append(t, 25.0f);
+    }
+    for (uint8_t lv = 0; lv <= 4; ++lv) {
+        EXPECT_LE(t - 600 * 1000 - ts->oldest(lv), series_t::max_age) << (int)lv;
+    }
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(TimeSeries, DISABLED_Benchmark)
+{
+    auto ts          = std::unique_ptr<series_t>(new series_t());
+    const auto input = make_samples(7 * 24 * 3600);
+    auto started     = std::chrono::high_resolution_clock::now();
+    for (auto& s : input) {
+        ts->append(s.time, s.value);
+    }
+    const auto append_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+
+    const uint32_t now = input.back().time + 1;
+    std::vector<TimeSeriesPoint> px(320);
+    started = std::chrono::high_resolution_clock::now();
+    constexpr int loops{1000};
+    uint32_t total{};
+    for (int i = 0; i < loops; ++i) {
+        const uint32_t span[4]{600 * 1000, 3600 * 1000, 24 * 3600 * 1000, 7 * 24 * 3600 * 1000 - 1};
+        ts->query(now - span[i & 3], now, px.data(), 320);
+        total += px[319].count;
+    }
+    const auto query_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - started)
+            .count();
+    EXPECT_GT(total, 0U);
+    printf("TimeSeries<600,360>: %zu bytes, append: %.1f ns, query 320px: %.2f us\n", sizeof(series_t),
+           (double)append_ns / input.size(), query_ns / 1000.0 / loops);
+}
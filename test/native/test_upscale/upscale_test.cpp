@@ -0,0 +1,231 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  UnitTest for Upscaler
+*/
+#include <gtest/gtest.h>
+#include <thermal2/upscale.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+constexpr uint16_t base_raw{(22 + 64) * 128};
+
+void scene(uint16_t* frame, std::mt19937& rng)
+{
+    std::normal_distribution<float> n(0.0f, 30.0f);
+    for (int y = 0; y < frame_height; ++y) {
+        for (int x = 0; x < frame_width; ++x) {
+            const float d2             = (x - 20.3f) * (x - 20.3f) + (y - 9.6f) * (y - 9.6f);
+            frame[y * frame_width + x] = (uint16_t)(base_raw + x * 8 + 1400.0f * std::exp(-d2 / 18.0f) + n(rng));
+        }
+    }
+}
+
+// Entry of the output pixel in floating point
+float reference(const uint16_t* frame, const Agc& agc, const int x, const int y, const int w, const int h)
+{
+    auto pos = [&](const int sx, const int sy) {
+        int32_t raw = frame[sy * frame_width + sx];
+        raw         = std::max<int32_t>(agc.lower(), std::min<int32_t>(agc.high(), raw));
+        return (float)(raw - agc.lower()) / (1 << agc.shift());
+    };
+    const float fx     = (float)x * (frame_width - 1) / (w - 1);
+    const float fy     = (float)y * (frame_height - 1) / (h - 1);
+    const int ix       = std::min((int)fx, frame_width - 2);
+    const int iy       = std::min((int)fy, frame_height - 2);
+    const float ax     = fx - ix;
+    const float ay     = fy - iy;
+    const float top    = pos(ix, iy) * (1 - ax) + pos(ix + 1, iy) * ax;
+    const float bottom = pos(ix, iy + 1) * (1 - ax) + pos(ix + 1, iy + 1) * ax;
+    return top * (1 - ay) + bottom * ay;
+}
+
+// The per-box interpolation SmoothDraw used, for comparison
+void legacy(uint16_t* out, const uint16_t* frame, const uint16_t* palette, const int w, const int h, const int lowest,
+            const int diff)
+{
+    int y1 = 0;
+    for (int fy = 1; fy < frame_height; ++fy) {
+        int y0        = y1;
+        y1            = (fy * h) / (frame_height - 1);
+        int boxHeight = y1 - y0;
+        if (boxHeight == 0) continue;
+        int v0, v2;
+        int v1 = ((frame[(fy - 1) * frame_width] - lowest) << 16) / boxHeight;
+        int v3 = ((frame[(fy)*frame_width] - lowest) << 16) / boxHeight;
+        int x1 = 0;
+        for (int fx = 1; fx < frame_width; ++fx) {
+            int x0       = x1;
+            x1           = (fx * w) / (frame_width - 1);
+            int boxWidth = x1 - x0;
+            v0           = v1;
+            v1           = ((frame[fx + (fy - 1) * frame_width] - lowest) << 16) / boxHeight;
+            v2           = v3;
+            v3           = ((frame[fx + (fy)*frame_width] - lowest) << 16) / boxHeight;
+            if (boxWidth == 0) continue;
+            int divider = boxWidth * diff;
+            for (int by = 0; by < boxHeight; ++by) {
+                int v02  = (v0 * (boxHeight - by) + v2 * by) / divider;
+                int v13  = (v1 * (boxHeight - by) + v3 * by) / divider;
+                auto dst = out + x0 + (y0 + by) * w;
+                for (int bx = 0; bx < boxWidth; ++bx) {
+                    int v   = (v02 * (boxWidth - bx) + v13 * bx) >> 8;
+                    dst[bx] = palette[(v < 0) ? 0 : (v > 255) ? 255 : v];
+                }
+            }
+        }
+    }
+}
+
+Agc make_agc(const uint16_t* frame)
+{
+    Agc::config_t cfg{};
+    cfg.mode         = AgcMode::Linear;
+    cfg.smooth_shift = 0;
+    Agc agc(cfg);
+    Histogram h;
+    h.build(frame);
+    agc.update(h);
+    return agc;
+}
+
+}  // namespace
+
+TEST(Upscale, Setup)
+{
+    Upscaler u;
+    EXPECT_EQ(u.width(), 0);
+    EXPECT_FALSE(u.setup(1, 240));
+    EXPECT_FALSE(u.setup(320, 0));
+    EXPECT_FALSE(u.setup(4097, 240));
+    EXPECT_TRUE(u.setup(320, 240));
+    EXPECT_EQ(u.width(), 320);
+    EXPECT_EQ(u.height(), 240);
+
+    // Same size as the frame is the frame itself
+    std::mt19937 rng(1);
+    uint16_t frame[frame_pixels]{};
+    scene(frame, rng);
+    const Agc agc = make_agc(frame);
+    Upscaler same(frame_width, frame_height);
+    same.source(frame, agc);
+    uint8_t out[frame_pixels]{};
+    same.render(out, agc.lut());
+    for (uint_fast16_t i = 0; i < frame_pixels; ++i) {
+        EXPECT_EQ(out[i], agc.index(frame[i])) << i;
+    }
+}
+
+TEST(Upscale, Accuracy)
+{
+    std::mt19937 rng(2);
+    uint16_t frame[frame_pixels]{};
+    scene(frame, rng);
+    const Agc agc = make_agc(frame);
+
+    // Identity table returns the entry itself
+    std::vector<uint16_t> entries(agc.size());
+    for (uint16_t i = 0; i < agc.size(); ++i) {
+        entries[i] = i;
+    }
+
+    const int sizes[][2] = {{320, 240}, {240, 135}, {128, 128}, {33, 25}, {2, 2}};
+    for (auto&& s : sizes) {
+        const int w = s[0], h = s[1];
+        Upscaler u(w, h);
+        u.source(frame, agc);
+        std::vector<uint16_t> out(w * h);
+        u.render(out.data(), entries.data());
+        float max_err{};
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const float err = std::fabs(out[y * w + x] - reference(frame, agc, x, y, w, h));
+                max_err         = std::max(max_err, err);
+            }
+        }
+        // Truncation to the entry plus the Q8 weights on the steep slopes of the hot spot
+        EXPECT_LT(max_err, 1.5f) << w << "x" << h;
+        // Corners are the corner pixels
+        EXPECT_EQ(out[0], agc.entry(frame[0]));
+        EXPECT_EQ(out[w * h - 1], agc.entry(frame[frame_pixels - 1]));
+    }
+}
+
+TEST(Upscale, Strip)
+{
+    std::mt19937 rng(3);
+    uint16_t frame[frame_pixels]{};
+    scene(frame, rng);
+    const Agc agc = make_agc(frame);
+    constexpr int w{240}, h{135};
+    Upscaler u(w, h);
+    u.source(frame, agc);
+
+    std::vector<uint8_t> full(w * h), strip(w * h);
+    u.render(full.data(), agc.lut());
+    // 11 rows at a time into the right half of a buffer twice as wide
+    std::vector<uint8_t> wide(w * 2 * 11);
+    for (int y = 0; y < h; y += 11) {
+        u.render(wide.data() + w, agc.lut(), y, 11, w * 2);
+        for (int r = 0; r < 11 && y + r < h; ++r) {
+            std::copy(wide.begin() + r * w * 2 + w, wide.begin() + (r + 1) * w * 2, strip.begin() + (y + r) * w);
+        }
+    }
+    EXPECT_EQ(full, strip);
+    // Out of range rows are ignored
+    u.render(wide.data(), agc.lut(), h, 1);
+}
+
+// Opt-in: --gtest_also_run_disabled_tests (env:bench_native)
+TEST(Upscale, DISABLED_Benchmark)
+{
+    std::mt19937 rng(4);
+    uint16_t frame[frame_pixels]{};
+    scene(frame, rng);
+    const Agc agc = make_agc(frame);
+    uint16_t palette[256]{};
+    for (auto&& c : palette) {
+        c = (uint16_t)rng();
+    }
+    uint16_t colors[Agc::max_entries]{};
+    agc.colorize(colors, palette);
+
+    const int sizes[][2] = {{320, 240}, {240, 135}};
+    for (auto&& s : sizes) {
+        const int w = s[0], h = s[1];
+        std::vector<uint16_t> out(w * h);
+        Upscaler u(w, h);
+        constexpr uint32_t loops{500};
+        uint32_t guard{};
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < loops; ++i) {
+            u.source(frame, agc);
+            u.render(out.data(), colors);
+            guard += out[i % out.size()];
+        }
+        auto elapsed     = std::chrono::high_resolution_clock::now() - start;
+        const double us0 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < loops; ++i) {
+            legacy(out.data(), frame, palette, w, h, agc.low(), agc.high() - agc.low() + 1);
+            guard += out[i % out.size()];
+        }
+        elapsed          = std::chrono::high_resolution_clock::now() - start;
+        const double us1 = std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+
+        printf("%dx%d upscaler:%.1f us per-box:%.1f us\n", w, h, us0, us1);
+        EXPECT_GT(guard, 0U);
+    }
+}
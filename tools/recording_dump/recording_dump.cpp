@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Host reader of Thermal2 recordings (RecordingWriter)
+
+  Build:
+    g++ -std=c++14 -O2 -I../../src recording_dump.cpp ../../src/thermal2/recording.cpp \
+        ../../src/thermal2/stream.cpp ../../src/thermal2/codec.cpp -o recording_dump
+  Usage:
+    recording_dump [-s seconds] [-n count] [-f] file
+    -s  Start at the time (seconds from the start of the recording)
+    -n  Subpages to print (all)
+    -f  Print every assembled frame as 24 rows of 32 celsius values (CSV)
+
+  The file is memory-mapped, seeking uses the index of the recording
+*/
+#include <thermal2/recording.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+float to_celsius(const uint16_t raw)
+{
+    return raw / 128.0f - 64;
+}
+
+void print_frame(const Frame& frame)
+{
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            printf("%s%.2f", x ? "," : "", to_celsius(frame.pixel(x, y)));
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    bool frames{};
+    double start{-1.0};
+    long count{-1};
+    const char* path{};
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-f")) {
+            frames = true;
+        } else if (!std::strcmp(argv[i], "-s") && i + 1 < argc) {
+            start = std::strtod(argv[++i], nullptr);
+        } else if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+            count = std::strtol(argv[++i], nullptr, 10);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "Usage: %s [-s seconds] [-n count] [-f] file\n", argv[0]);
+        return 1;
+    }
+
+    const int fd = open(path, O_RDONLY);
+    struct stat st {};
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        perror(path);
+        return 1;
+    }
+    const size_t size = st.st_size;
+    void* map         = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    RecordingReader reader;
+    if (!reader.open((const uint8_t*)map, size)) {
+        fprintf(stderr, "%s: Not a recording\n", path);
+        return 1;
+    }
+    const auto& h = reader.header();
+    fprintf(stderr,
+            "version:%u rate:%u filter:%u emissivity:%.4f start:%llu compressed:%u sync points:%zu valid:%u/%zu "
+            "bytes\n",
+            h.version, h.refresh_rate, h.noise_filter, h.emissivity, (unsigned long long)h.start_time, h.compressed,
+            reader.index().size(), reader.end(), size);
+
+    if (start >= 0 && !reader.seek((uint32_t)(start * 1000))) {
+        reader.rewind();
+    }
+    RecordedSubpage rs{};
+    Frame frame{};
+    while (count && reader.next(rs)) {
+        if (start >= 0 && rs.timestamp < start * 1000) {
+            frame.merge(rs.raw, rs.subpage);
+            continue;
+        }
+        if (frames) {
+            frame.merge(rs.raw, rs.subpage);
+            if (frame.complete() && rs.subpage) {
+                print_frame(frame);
+            }
+        } else {
+            printf("time:%10u subpage:%u%s%s med:%6.2f avg:%6.2f low:%6.2f high:%6.2f\n", rs.timestamp, rs.subpage,
+                   rs.sync() ? " sync" : "", rs.torn() ? " torn" : "", to_celsius(rs.temp[0]), to_celsius(rs.temp[1]),
+                   to_celsius(rs.temp[4]), to_celsius(rs.temp[6]));
+        }
+        count -= (count > 0);
+    }
+
+    munmap(map, size);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2025 M5Stack Technology CO LTD
+ *
+ * SPDX-License-Identifier: MIT
+ */
+/*
+  Host decoder of the Thermal2 binary stream (PlotToSerial)
+
+  Build:
+    g++ -std=c++14 -O2 -I../../src stream_decoder.cpp ../../src/thermal2/stream.cpp ../../src/thermal2/codec.cpp \
+        -o stream_decoder
+  Usage:
+    stream_decoder [-f] [-b baud] [device or file]   (stdin if omitted)
+    -f  Print every assembled frame as 24 rows of 32 celsius values (CSV)
+    -b  Baud rate of the serial device (115200)
+
+  Prints one line per subpage, raw or compressed, reports the lost sequence numbers on stderr
+  and the counters at the end of the input (or Ctrl-C)
+*/
+#include <thermal2/stream.hpp>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace m5::unit::thermal2;
+
+namespace {
+
+volatile std::sig_atomic_t running{1};
+
+void on_signal(int)
+{
+    running = 0;
+}
+
+float to_celsius(const uint16_t raw)
+{
+    return raw / 128.0f - 64;
+}
+
+speed_t to_speed(const long baud)
+{
+    switch (baud) {
+        case 9600:
+            return B9600;
+        case 57600:
+            return B57600;
+        case 230400:
+            return B230400;
+        case 460800:
+            return B460800;
+        case 921600:
+            return B921600;
+        default:
+            return B115200;
+    }
+}
+
+// Raw mode if the input is a serial device
+bool setup_tty(const int fd, const long baud)
+{
+    if (!isatty(fd)) {
+        return true;
+    }
+    termios tio{};
+    if (tcgetattr(fd, &tio) != 0) {
+        return false;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, to_speed(baud));
+    cfsetospeed(&tio, to_speed(baud));
+    tio.c_cc[VMIN]  = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+void print_frame(const Frame& frame)
+{
+    for (uint_fast8_t y = 0; y < frame_height; ++y) {
+        for (uint_fast8_t x = 0; x < frame_width; ++x) {
+            printf("%s%.2f", x ? "," : "", to_celsius(frame.pixel(x, y)));
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    bool frames{};
+    long baud{115200};
+    const char* path{};
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-f")) {
+            frames = true;
+        } else if (!std::strcmp(argv[i], "-b") && i + 1 < argc) {
+            baud = std::strtol(argv[++i], nullptr, 10);
+        } else {
+            path = argv[i];
+        }
+    }
+
+    const int fd = path ? open(path, O_RDONLY | O_NOCTTY) : STDIN_FILENO;
+    if (fd < 0 || !setup_tty(fd, baud)) {
+        perror(path ? path : "stdin");
+        return 1;
+    }
+    std::signal(SIGINT, on_signal);
+
+    StreamDecoder decoder;
+    Frame frame{};
+    uint32_t dropped{};
+    uint8_t buf[1024];
+    ssize_t len{};
+    while (running && (len = read(fd, buf, sizeof(buf))) > 0) {
+        for (ssize_t i = 0; i < len; ++i) {
+            const bool decoded = decoder.push(buf[i]);
+            if (decoder.stats().dropped != dropped) {
+                fprintf(stderr, "Lost %u packets\n", decoder.stats().dropped - dropped);
+                dropped = decoder.stats().dropped;
+            }
+            if (!decoded) {
+                continue;
+            }
+            const auto& p = decoder.packet();
+            if (frames) {
+                frame.merge(p.raw, p.subpage);
+                if (frame.complete() && p.subpage) {
+                    print_frame(frame);
+                }
+                continue;
+            }
+            printf("seq:%5u time:%10u subpage:%u%s med:%6.2f avg:%6.2f low:%6.2f high:%6.2f\n", p.sequence,
+                   p.timestamp, p.subpage, p.torn() ? " torn" : "", to_celsius(p.temp[0]), to_celsius(p.temp[1]),
+                   to_celsius(p.temp[4]), to_celsius(p.temp[6]));
+        }
+        fflush(stdout);
+    }
+
+    const auto& st = decoder.stats();
+    fprintf(stderr, "packets:%u dropped:%u resync:%u crc:%u framing:%u unsynced:%u\n", st.packets, st.dropped,
+            st.resync, st.crc, st.framing, st.unsynced);
+    if (path) {
+        close(fd);
+    }
+    return 0;
+}